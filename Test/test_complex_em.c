@@ -10,6 +10,7 @@
 #include <string.h>
 #include "../src/lib/complex_em.h"
 #include "../src/lib/simd_complex_estep.h"
+#include "../src/lib/accel.h"
 
 #ifndef M_PI
 #define M_PI 3.14159265358979323846
@@ -499,6 +500,82 @@ static void test_mv_complex_two(void) {
 }
 
 
+/* ════════════════════════════════════════════════════════════════════
+ * SQUAREM: same optimum as plain EM on overlapping clusters, fewer
+ * iterations
+ * ════════════════════════════════════════════════════════════════════ */
+
+static void test_squarem_complex(void) {
+    printf("test_squarem_complex...\n");
+    int saved = GetEMAcceleration();
+    srand(2024);
+
+    size_t n1 = 1500, n = 3000;
+    double* z = (double*)malloc(2 * n * sizeof(double));
+    gen_noncircular(z,          n1, 0.0, 0.0, 2.0, 0.8, 0.3);
+    gen_noncircular(z + 2 * n1, n - n1, 1.5, 0.5, 1.0, -0.3, 0.2);
+
+    int it[2];
+    double ll[2];
+    for (int on = 0; on < 2; on++) {
+        CCircMixtureResult r = {0};
+        SetEMAcceleration(on);
+        srand(5);
+        ASSERT(UnmixComplexCircular(z, n, 2, 2000, 1e-10, 0, &r) == 0, "SQUAREM circular: success");
+        it[on] = r.iterations;
+        ll[on] = r.loglikelihood;
+        ReleaseCCircResult(&r);
+    }
+    printf("  circular     LL %.4f / %.4f  iters %d / %d\n", ll[0], ll[1], it[0], it[1]);
+    ASSERT(ll[1] > ll[0] - 1e-3, "SQUAREM circular: LL at least plain EM's");
+    ASSERT(it[1] < it[0], "SQUAREM circular: fewer iterations");
+
+    for (int on = 0; on < 2; on++) {
+        CNonCircMixtureResult r = {0};
+        SetEMAcceleration(on);
+        srand(5);
+        ASSERT(UnmixComplexNonCircular(z, n, 2, 2000, 1e-10, 0, &r) == 0, "SQUAREM non-circular: success");
+        for (int j = 0; j < 2; j++) {
+            double pc2 = r.components[j].pcov_re * r.components[j].pcov_re
+                       + r.components[j].pcov_im * r.components[j].pcov_im;
+            ASSERT(pc2 < r.components[j].cov_re * r.components[j].cov_re, "SQUAREM non-circular: |C| < Σ");
+        }
+        it[on] = r.iterations;
+        ll[on] = r.loglikelihood;
+        ReleaseCNonCircResult(&r);
+    }
+    printf("  non-circular LL %.4f / %.4f  iters %d / %d\n", ll[0], ll[1], it[0], it[1]);
+    ASSERT(ll[1] > ll[0] - 1e-2, "SQUAREM non-circular: LL at least plain EM's");
+    ASSERT(it[1] < it[0], "SQUAREM non-circular: fewer iterations");
+
+    /* d = 2 with correlated components */
+    int d = 2;
+    double mean1[4] = {0.0, 0.0, 0.0, 0.0};
+    double chol1[8] = { 1,0, 0,0,  0.6,0.4, 0.8,0 };
+    double mean2[4] = {1.5, 0.5, -1.0, 0.0};
+    double chol2[8] = { 0.7,0, 0,0,  0,0, 1.2,0 };
+    double* w = (double*)malloc(n * 2 * d * sizeof(double));
+    gen_mv_complex(w,              n1,     d, mean1, chol1);
+    gen_mv_complex(w + n1 * 2 * d, n - n1, d, mean2, chol2);
+    for (int on = 0; on < 2; on++) {
+        MVComplexMixtureResult r = {0};
+        SetEMAcceleration(on);
+        srand(5);
+        ASSERT(UnmixMVComplex(w, n, d, 2, 2000, 1e-10, 0, &r) == 0, "SQUAREM MV complex: success");
+        it[on] = r.iterations;
+        ll[on] = r.loglikelihood;
+        ReleaseMVComplexResult(&r);
+    }
+    printf("  MV complex   LL %.4f / %.4f  iters %d / %d\n", ll[0], ll[1], it[0], it[1]);
+    ASSERT(ll[1] > ll[0] - 1e-3, "SQUAREM MV complex: LL at least plain EM's");
+    ASSERT(it[1] < it[0], "SQUAREM MV complex: fewer iterations");
+
+    SetEMAcceleration(saved);
+    free(w);
+    free(z);
+}
+
+
 /* ════════════════════════════════════════════════════════════════════
  * Feature 2 test: SIMD E-step vs scalar
  * ════════════════════════════════════════════════════════════════════ */
@@ -659,6 +736,7 @@ int main(void) {
     test_mv_complex_cholesky();
     test_mv_complex_single();
     test_mv_complex_two();
+    test_squarem_complex();
 
     printf("\n--- Feature 2: SIMD E-step ---\n\n");
     test_simd_matches_scalar();
@@ -7,6 +7,7 @@
 #include <string.h>
 #include <math.h>
 #include "distributions.h"
+#include "sparse_em.h"
 
 static int tests_run = 0;
 static int tests_passed = 0;
@@ -95,6 +96,177 @@ void test_generic_gaussian(void) {
     free(data);
 }
 
+/* ===== Test: Subsampled init for large n matches full-data init ===== */
+void test_init_subsample(void) {
+    printf("Test: Subsampled k-means++ init\n");
+
+    ASSERT_TRUE(InitSubsampleSize(1000, 3, 1) == 0, "Below threshold: full data");
+    SetInitSubsampleThreshold(20000);
+    ASSERT_TRUE(InitSubsampleSize(60000, 3, 1) == 4096, "Small k*d: minimum sample");
+    ASSERT_TRUE(InitSubsampleSize(60000, 64, 8) == 0, "Sample >= n: full data");
+
+    srand(7);
+    int n = 60000;
+    double* data = (double*)malloc(sizeof(double) * n);
+    for (int i = 0; i < n; i++) {
+        int c = i % 3;
+        data[i] = randn(-8.0 + 8.0 * c, 1.0);
+    }
+
+    MixtureResult sub, full;
+    int rc = UnmixGeneric(data, n, DIST_GAUSSIAN, 3, 500, 1e-6, 0, &sub);
+    ASSERT_TRUE(rc == 0, "Subsampled init fit succeeds");
+
+    SetInitSubsampleThreshold(0);
+    ASSERT_TRUE(InitSubsampleSize(60000, 3, 1) == 0, "Threshold 0 disables");
+    rc = UnmixGeneric(data, n, DIST_GAUSSIAN, 3, 500, 1e-6, 0, &full);
+    ASSERT_TRUE(rc == 0, "Full-data init fit succeeds");
+    SetInitSubsampleThreshold(GEMMULEM_INIT_SUBSAMPLE_THRESHOLD);
+
+    ASSERT_CLOSE(sub.loglikelihood, full.loglikelihood, 1e-3 * fabs(full.loglikelihood),
+                 "Same optimum with and without subsample");
+    double lo = 1e30, hi = -1e30;
+    for (int j = 0; j < 3; j++) {
+        if (sub.params[j].p[0] < lo) lo = sub.params[j].p[0];
+        if (sub.params[j].p[0] > hi) hi = sub.params[j].p[0];
+    }
+    ASSERT_CLOSE(lo, -8.0, 0.2, "Lowest mean near -8");
+    ASSERT_CLOSE(hi, 8.0, 0.2, "Highest mean near 8");
+
+    ReleaseMixtureResult(&sub);
+    ReleaseMixtureResult(&full);
+    free(data);
+}
+
+/* ===== Test: Windowed sparse E-step matches dense EM ===== */
+void test_sparse_estep(void) {
+    printf("Test: Sparse windowed E-step\n");
+    srand(11);
+    int n = 20000;
+    double* data = (double*)malloc(sizeof(double) * n);
+    for (int i = 0; i < n; i++) data[i] = randn(3.0 * (i % 4), 0.5);
+
+    MixtureResult sp, dn;
+    double err = -1;
+    int rc = UnmixGenericSparse(data, n, DIST_GAUSSIAN, 4, 500, 1e-6, 0, 0, &sp, &err);
+    ASSERT_TRUE(rc == 0, "Sparse fit succeeds");
+    rc = UnmixGeneric(data, n, DIST_GAUSSIAN, 4, 500, 1e-6, 0, &dn);
+    ASSERT_TRUE(rc == 0, "Dense fit succeeds");
+    ASSERT_CLOSE(sp.loglikelihood, dn.loglikelihood, 1e-4 * fabs(dn.loglikelihood),
+                 "Sparse LL matches dense LL");
+    ASSERT_TRUE(err >= 0 && err < 1e-3, "Truncation error bound is small");
+    ReleaseMixtureResult(&sp);
+    ReleaseMixtureResult(&dn);
+
+    /* k well past the dense engine's 64-component limit; the exact LL at
+     * the returned parameters must lie within [LL, LL + err] */
+    int k = 120;
+    for (int i = 0; i < n; i++) data[i] = randn(2.0 * (i % k), 0.3);
+    rc = UnmixGenericSparse(data, n, DIST_GAUSSIAN, k, 200, 1e-6, 1e-8, 0, &sp, &err);
+    ASSERT_TRUE(rc == 0, "Sparse fit with k=120 succeeds");
+    const DistFunctions* df = GetDistFunctions(DIST_GAUSSIAN);
+    double exact = 0;
+    for (int i = 0; i < n; i++) {
+        double s = 0;
+        for (int j = 0; j < k; j++)
+            s += sp.mixing_weights[j] * exp(df->logpdf(data[i], &sp.params[j]));
+        exact += log(s);
+    }
+    ASSERT_TRUE(exact >= sp.loglikelihood - 1e-6 * fabs(exact), "Reported LL is a lower bound");
+    ASSERT_TRUE(exact - sp.loglikelihood <= err + 1e-6 * fabs(exact), "Exact LL within error bound");
+    ReleaseMixtureResult(&sp);
+
+    rc = UnmixGenericSparse(data, n, DIST_LAPLACE, 8, 100, 1e-6, 0, 0, &sp, NULL);
+    ASSERT_TRUE(rc == 0, "Laplace sparse fit succeeds");
+    ReleaseMixtureResult(&sp);
+    rc = UnmixGenericSparse(data, n, DIST_GAMMA, 4, 100, 1e-6, 0, 0, &sp, NULL);
+    ASSERT_TRUE(rc == -2, "Unsupported family rejected");
+    free(data);
+}
+
+/* ===== Test: Incremental (Neal-Hinton) EM reaches the batch fixed point ===== */
+void test_incremental(void) {
+    printf("Test: Incremental block EM\n");
+    srand(31);
+    int n = 30000;
+    double* data = (double*)malloc(sizeof(double) * n);
+    for (int i = 0; i < n; i++) data[i] = randn(-4.0 + 4.0 * (i % 3), 1.0);
+
+    MixtureResult inc, bat;
+    int rc = UnmixIncremental(data, n, DIST_GAUSSIAN, 3, 200, 1e-6, 16, 0, &inc);
+    ASSERT_TRUE(rc == 0, "Incremental fit succeeds");
+    rc = UnmixGeneric(data, n, DIST_GAUSSIAN, 3, 500, 1e-6, 0, &bat);
+    ASSERT_TRUE(rc == 0, "Batch fit succeeds");
+    ASSERT_CLOSE(inc.loglikelihood, bat.loglikelihood, 1e-4 * fabs(bat.loglikelihood),
+                 "Same LL as batch EM");
+    double ws = 0;
+    for (int j = 0; j < 3; j++) ws += inc.mixing_weights[j];
+    ASSERT_CLOSE(ws, 1.0, 1e-9, "Weights sum to 1");
+    ReleaseMixtureResult(&inc);
+    ReleaseMixtureResult(&bat);
+
+    for (int i = 0; i < n; i++) data[i] = -log((rand() + 1.0) / (RAND_MAX + 2.0)) / (i % 2 ? 0.2 : 2.0);
+    rc = UnmixIncremental(data, n, DIST_EXPONENTIAL, 2, 200, 1e-6, 0, 0, &inc);
+    ASSERT_TRUE(rc == 0, "Exponential incremental fit succeeds");
+    double lo = fmin(inc.params[0].p[0], inc.params[1].p[0]);
+    double hi = fmax(inc.params[0].p[0], inc.params[1].p[0]);
+    ASSERT_CLOSE(lo, 0.2, 0.05, "Low rate near 0.2");
+    ASSERT_CLOSE(hi, 2.0, 0.5, "High rate near 2.0");
+    ReleaseMixtureResult(&inc);
+
+    /* Poisson has no logpdf: the E-step goes through pdf */
+    for (int i = 0; i < n; i++) {
+        double lim = exp(i % 2 ? -12.0 : -2.0), prod = 1.0;
+        int c = -1;
+        do { prod *= (rand() + 1.0) / (RAND_MAX + 2.0); c++; } while (prod > lim);
+        data[i] = c;
+    }
+    rc = UnmixIncremental(data, n, DIST_POISSON, 2, 200, 1e-6, 0, 0, &inc);
+    ASSERT_TRUE(rc == 0, "Poisson incremental fit succeeds");
+    if (rc == 0) {
+        lo = fmin(inc.params[0].p[0], inc.params[1].p[0]);
+        hi = fmax(inc.params[0].p[0], inc.params[1].p[0]);
+        ASSERT_CLOSE(lo, 2.0, 0.2, "Low mean near 2");
+        ASSERT_CLOSE(hi, 12.0, 0.5, "High mean near 12");
+        ASSERT_TRUE(isfinite(inc.loglikelihood), "Finite Poisson LL");
+        ReleaseMixtureResult(&inc);
+    }
+
+    rc = UnmixIncremental(data, n, DIST_GAMMA, 2, 10, 1e-6, 0, 0, &inc);
+    ASSERT_TRUE(rc == -2, "Unsupported family rejected");
+    free(data);
+}
+
+/* ===== Test: Pruned multi-start on an overlapping mixture ===== */
+void test_multistart(void) {
+    printf("Test: Parallel multi-start with pruning\n");
+    srand(5);
+    int n = 20000;
+    const double mu[4] = {0, 1.5, 4, 4.8}, sd[4] = {1, 0.5, 1, 0.3};
+    double* data = (double*)malloc(sizeof(double) * n);
+    for (int i = 0; i < n; i++) data[i] = randn(mu[i % 4], sd[i % 4]);
+
+    MixtureResult one, multi, again;
+    int rc = UnmixGeneric(data, n, DIST_GAUSSIAN, 4, 300, 1e-5, 0, &one);
+    ASSERT_TRUE(rc == 0, "Single start succeeds");
+    SetNumRestarts(6);
+    ASSERT_TRUE(GetNumRestarts() == 6, "Restart count set");
+    rc = UnmixGeneric(data, n, DIST_GAUSSIAN, 4, 300, 1e-5, 0, &multi);
+    ASSERT_TRUE(rc == 0, "Multi-start succeeds");
+    rc = UnmixGeneric(data, n, DIST_GAUSSIAN, 4, 300, 1e-5, 0, &again);
+    SetNumRestarts(1);
+    ASSERT_TRUE(rc == 0 && again.loglikelihood == multi.loglikelihood,
+                "Multi-start is deterministic");
+    ASSERT_TRUE(multi.loglikelihood > one.loglikelihood - 1e-3 * fabs(one.loglikelihood),
+                "Multi-start no worse than single start");
+    ASSERT_TRUE(multi.iterations > 0 && multi.iterations <= 300, "Iterations within budget");
+
+    ReleaseMixtureResult(&one);
+    ReleaseMixtureResult(&multi);
+    ReleaseMixtureResult(&again);
+    free(data);
+}
+
 /* ===== Test: Unmix Exponential mixture (generic) ===== */
 void test_generic_exponential(void) {
     printf("Test: Generic EM on Exponential mixture\n");
@@ -472,6 +644,45 @@ void test_all_families_registered(void) {
     printf("\n");
 }
 
+/* ===== Statistic maps reproduce the family's weighted MLE ===== */
+void test_suffstats_match_estimate(void) {
+    printf("Test: sufficient-statistic M-step matches estimate()\n");
+    srand(4242);
+    int n = 500;
+    double* x = (double*)malloc(sizeof(double)*n);
+    double* w = (double*)malloc(sizeof(double)*n);
+    double stat[DIST_MAX_STATS + 1];
+    int checked = 0;
+    for (int f = 0; f < DIST_COUNT; f++) {
+        const DistSuffStats* ss = GetDistSuffStats((DistFamily)f);
+        if (!ss || ss->uses_params) continue;
+        for (int i = 0; i < n; i++) {
+            x[i] = 1 + rand() % 12;               /* in every mapped domain */
+            if (f == DIST_BETA) x[i] /= 13.0;
+            w[i] = (rand() % 1000 + 1) / 1000.0;
+        }
+        const DistFunctions* df = GetDistFunctions((DistFamily)f);
+        DistParams want, got;
+        memset(&want, 0, sizeof(want));
+        df->estimate(x, w, n, &want);
+        got = want;
+        DistSuffStatsSum((DistFamily)f, x, n, 1, w, &got, NULL, stat);
+        DistParamsFromStats((DistFamily)f, stat, 1, &got);
+        int ok = 1;
+        for (int q = 0; q < df->num_params; q++)
+            if (fabs(got.p[q] - want.p[q]) > 1e-6 * fmax(1, fabs(want.p[q]))) ok = 0;
+        char msg[96];
+        snprintf(msg, sizeof(msg), "%s map matches estimate()", df->name);
+        ASSERT_TRUE(ok, msg);
+        checked++;
+    }
+    ASSERT_TRUE(checked >= 14, "maps for the exponential families");
+    ASSERT_TRUE(GetDistSuffStats(DIST_STUDENT_T) != NULL, "Student-t ECM map");
+    ASSERT_TRUE(GetDistSuffStats(DIST_WEIBULL) == NULL, "no map for Weibull");
+    free(x);
+    free(w);
+}
+
 int main(void) {
     printf("\n========================================\n");
     printf("  GEMMULEM Distribution Framework Tests\n");
@@ -480,9 +691,14 @@ int main(void) {
     test_registry();
     test_pdf_integration();
     test_generic_gaussian();
+    test_init_subsample();
+    test_sparse_estep();
+    test_incremental();
+    test_multistart();
     test_generic_exponential();
     test_generic_gamma();
     test_generic_beta();
+    test_suffstats_match_estimate();
     test_model_selection_gaussian();
     test_model_selection_exponential();
     test_bic_parsimony();
@@ -6,6 +6,8 @@
 #include <math.h>
 #include <string.h>
 #include "multivariate.h"
+#include "distributions.h"
+#include "accel.h"
 
 static int tests_run = 0, tests_passed = 0, tests_failed = 0;
 
@@ -255,6 +257,501 @@ void test_mv_autok(void) {
     free(data);
 }
 
+/* ─── Test 8: Coarse-to-fine multiresolution schedule ─── */
+void test_multires(void) {
+    printf("Test: MV multiresolution schedule\n");
+    size_t sizes[GEMMULEM_MULTIRES_MAX_LEVELS];
+    ASSERT_TRUE(MultiresSchedule(40000, 3, 2, sizes) == 0, "Off by default");
+    SetMultiresLevels(3);
+    ASSERT_TRUE(MultiresSchedule(40000, 3, 2, sizes) == 1 && sizes[0] == 4000,
+                "1% level skipped, 10% level kept");
+    ASSERT_TRUE(MultiresSchedule(1000, 3, 2, sizes) == 0, "Small n: full data only");
+    SetMultiresLevels(1);
+
+    unsigned seed = 2468;
+    int n = 40000, d = 2;
+    double* data = malloc(sizeof(double) * n * d);
+    const double cx[3] = {-5, 0, 5}, cy[3] = {0, 5, 0};
+    for (int i = 0; i < n; i++) {          /* rows interleaved by cluster */
+        data[i*d+0] = randn(cx[i % 3], 1, &seed);
+        data[i*d+1] = randn(cy[i % 3], 1, &seed);
+    }
+
+    double* sub = NULL;
+    size_t m = MultiresSubsample(data, n, d, 4000, &sub);
+    ASSERT_TRUE(m > 3600 && m < 4400, "Subsample size near target");
+    size_t counts[3] = {0, 0, 0};
+    for (size_t i = 0; i < m; i++)
+        counts[sub[i*d+0] < -2.5 ? 0 : (sub[i*d+0] > 2.5 ? 2 : 1)]++;
+    ASSERT_TRUE(counts[0] > m / 4 && counts[1] > m / 4 && counts[2] > m / 4,
+                "Subsample covers every cluster");
+    free(sub);
+
+    MVMixtureResult full, mr;
+    int rc = UnmixMVGaussian(data, n, d, 3, COV_FULL, 500, 1e-5, 0, &full);
+    ASSERT_TRUE(rc == 0, "Full-data fit succeeds");
+    SetMultiresLevels(3);
+    rc = UnmixMVGaussian(data, n, d, 3, COV_FULL, 500, 1e-5, 0, &mr);
+    SetMultiresLevels(1);
+    ASSERT_TRUE(rc == 0, "Multiresolution fit succeeds");
+    ASSERT_CLOSE(mr.loglikelihood, full.loglikelihood, 1e-4 * fabs(full.loglikelihood),
+                 "Same LL as full-data fit");
+
+    ReleaseMVMixtureResult(&full);
+    ReleaseMVMixtureResult(&mr);
+    free(data);
+}
+
+/* ─── Test 9: Incremental block EM matches batch EM ─── */
+void test_mv_incremental(void) {
+    printf("Test: MV incremental block EM\n");
+    unsigned seed = 8642;
+    int n = 20000, d = 2;
+    double* data = malloc(sizeof(double) * n * d);
+    const double cx[3] = {-5, 0, 5}, cy[3] = {0, 5, 0};
+    for (int i = 0; i < n; i++) {
+        data[i*d+0] = 100 + randn(cx[i % 3], 1, &seed);   /* offset data */
+        data[i*d+1] = randn(cy[i % 3], 1, &seed);
+    }
+
+    MVMixtureResult bat, inc;
+    int rc = UnmixMVGaussian(data, n, d, 3, COV_FULL, 500, 1e-6, 0, &bat);
+    ASSERT_TRUE(rc == 0, "Batch fit succeeds");
+    rc = UnmixMVGaussianIncremental(data, n, d, 3, COV_FULL, 200, 1e-6, 16, 0, &inc);
+    ASSERT_TRUE(rc == 0, "Incremental fit succeeds");
+    ASSERT_CLOSE(inc.loglikelihood, bat.loglikelihood, 1e-4 * fabs(bat.loglikelihood),
+                 "Same LL as batch EM");
+    ReleaseMVMixtureResult(&inc);
+
+    rc = UnmixMVGaussianIncremental(data, n, d, 3, COV_DIAGONAL, 200, 1e-6, 0, 0, &inc);
+    ASSERT_TRUE(rc == 0 && inc.loglikelihood < 0, "Diagonal incremental fit succeeds");
+    ReleaseMVMixtureResult(&inc);
+    ReleaseMVMixtureResult(&bat);
+    free(data);
+}
+
+/* ─── Test 10: blocked E-step agrees with the per-point log-density ─── */
+void test_mv_blocked_estep(void) {
+    printf("Test: MV blocked E-step vs mvgauss_logpdf\n");
+    /* d ≤ 8: fixed-dimension kernels; d = 9: partial last tile;
+     * d = 70: beyond the stack buffer */
+    const int dims[7] = {1, 2, 3, 4, 8, 9, 70}, ns[7] = {1001, 1001, 1001, 1001, 1001, 1001, 300};
+    for (int t = 0; t < 7; t++) {
+        unsigned seed = 97 + t;
+        int n = ns[t], d = dims[t];
+        double* data = malloc(sizeof(double) * n * d);
+        for (int i = 0; i < n; i++)
+            for (int a = 0; a < d; a++)
+                data[i*d+a] = randn((i % 3) * (a % 2 ? 4.0 : -4.0), 1 + 0.1 * a, &seed);
+
+        /* The incremental engine reports the LL of its final parameters
+         * through the blocked E-step (diagonal and spherical: the
+         * inverse-variance kernels; tied: whitened Euclidean distances) */
+        const CovType cts[4] = {COV_FULL, COV_DIAGONAL, COV_SPHERICAL, COV_TIED};
+        for (int c = 0; c < 4; c++) {
+            MVMixtureResult r;
+            int rc = UnmixMVGaussianIncremental(data, n, d, 3, cts[c], 5, 1e-6, 0, 0, &r);
+            ASSERT_TRUE(rc == 0, "Fit succeeds");
+            double ll = 0;
+            for (int i = 0; i < n; i++) {
+                double lp[3], mx = -1e300, tot = 0;
+                for (int j = 0; j < 3; j++) {
+                    lp[j] = log(r.mixing_weights[j]) + mvgauss_logpdf(&data[i*d], &r.components[j]);
+                    if (lp[j] > mx) mx = lp[j];
+                }
+                for (int j = 0; j < 3; j++) tot += exp(lp[j] - mx);
+                ll += mx + log(tot);
+            }
+            ASSERT_CLOSE(r.loglikelihood, ll, 1e-9 * fabs(ll), "Blocked LL matches per-point LL");
+            ReleaseMVMixtureResult(&r);
+        }
+        free(data);
+    }
+}
+
+/* ─── Test 11: parallel blocks give the same fit for any thread count ─── */
+void test_mv_thread_invariance(void) {
+    printf("Test: MV fits independent of thread count\n");
+    unsigned seed = 2718;
+    int n = 30000, d = 5;
+    double* data = malloc(sizeof(double) * n * d);
+    for (int i = 0; i < n; i++)
+        for (int a = 0; a < d; a++)
+            data[i*d+a] = randn((i % 3) * (a % 2 ? 3.0 : -3.0), 1, &seed);
+
+    int saved = GetNumThreads();
+    double ll_g[2], ll_t[2], mu_g[2], nu_t[2];
+    const int threads[2] = {1, 3};
+    for (int t = 0; t < 2; t++) {
+        SetNumThreads(threads[t]);
+        MVMixtureResult g;
+        MVStudentTResult st;
+        ASSERT_TRUE(UnmixMVGaussian(data, n, d, 3, COV_FULL, 20, 1e-8, 0, &g) == 0,
+                    "Gaussian fit succeeds");
+        ASSERT_TRUE(UnmixMVStudentT(data, n, d, 3, COV_DIAGONAL, 10, 1e-8, 0, &st) == 0,
+                    "Student-t fit succeeds");
+        ll_g[t] = g.loglikelihood;
+        mu_g[t] = g.components[1].mean[2];
+        ll_t[t] = st.loglikelihood;
+        nu_t[t] = st.components[0].nu;
+        ReleaseMVMixtureResult(&g);
+        ReleaseMVStudentTResult(&st);
+    }
+    SetNumThreads(saved);
+    ASSERT_TRUE(ll_g[0] == ll_g[1] && mu_g[0] == mu_g[1], "Gaussian: 1 and 3 threads identical");
+    ASSERT_TRUE(ll_t[0] == ll_t[1] && nu_t[0] == nu_t[1], "Student-t: 1 and 3 threads identical");
+    free(data);
+}
+
+/* ─── Test 12: low-rank-plus-diagonal (factor analyzer) covariance ─── */
+void test_mv_lowrank(void) {
+    printf("Test: MV low-rank covariance (mixture of factor analyzers)\n");
+    unsigned seed = 4242;
+    int n = 4000, d = 20;
+    double* data = malloc(sizeof(double) * n * d);
+    /* Two clusters, each Σ = WWᵀ + 0.09·I with two factors */
+    for (int i = 0; i < n; i++) {
+        int j = i % 2;
+        double z1 = randn(0, 1, &seed), z2 = randn(0, 1, &seed);
+        for (int a = 0; a < d; a++)
+            data[i*d+a] = (j ? 4.0 : -4.0) + (a % 3 + 1) * z1
+                        + (a % 2 ? 1.0 : -1.0) * (j ? 1.5 : 0.5) * z2 + randn(0, 0.3, &seed);
+    }
+
+    int saved = GetLowRankDim();
+    SetLowRankDim(2);
+    MVMixtureResult r, dg;
+    int rc = UnmixMVGaussian(data, n, d, 2, COV_LOWRANK, 2000, 1e-3, 0, &r);
+    ASSERT_TRUE(rc == 0, "Low-rank fit succeeds");
+    ASSERT_TRUE(r.components[0].rank == 2 && r.components[1].rank == 2, "Rank from SetLowRankDim");
+    int lo = r.components[0].mean[0] < r.components[1].mean[0] ? 0 : 1;
+    ASSERT_CLOSE(r.mixing_weights[lo], 0.5, 0.02, "Weights recovered");
+    ASSERT_CLOSE(r.components[lo].mean[0], -4.0, 0.2, "Lower mean near -4");
+    ASSERT_CLOSE(r.components[1 - lo].mean[d - 1], 4.0, 0.2, "Upper mean near 4");
+
+    /* cov = WWᵀ + Ψ: the LL through cov_chol matches the Woodbury E-step */
+    double ll = 0;
+    for (int i = 0; i < n; i++) {
+        double lp[2], mx;
+        for (int j = 0; j < 2; j++)
+            lp[j] = log(r.mixing_weights[j]) + mvgauss_logpdf(&data[i*d], &r.components[j]);
+        mx = lp[0] > lp[1] ? lp[0] : lp[1];
+        ll += mx + log(exp(lp[0] - mx) + exp(lp[1] - mx));
+    }
+    ASSERT_CLOSE(r.loglikelihood, ll, 1.0, "Low-rank LL matches the dense covariance");
+
+    ASSERT_TRUE(UnmixMVGaussian(data, n, d, 2, COV_DIAGONAL, 2000, 1e-3, 0, &dg) == 0,
+                "Diagonal fit succeeds");
+    printf("    LL lowrank=%.1f  diagonal=%.1f  BIC lowrank=%.1f  diagonal=%.1f\n",
+           r.loglikelihood, dg.loglikelihood, r.bic, dg.bic);
+    ASSERT_TRUE(r.bic < dg.bic, "Low rank preferred over diagonal by BIC");
+    ReleaseMVMixtureResult(&r);
+    ReleaseMVMixtureResult(&dg);
+
+    ASSERT_TRUE(UnmixMVGaussianIncremental(data, n, d, 2, COV_LOWRANK, 5, 1e-6, 0, 0, &r) == -1,
+                "Incremental engine rejects low rank");
+
+    /* AECM: the LL after m iterations never falls as m grows */
+    int saved_accel = GetEMAcceleration();
+    SetEMAcceleration(0);
+    double prev = -HUGE_VAL;
+    int drops = 0;
+    for (int m = 1; m <= 30; m++) {
+        ASSERT_TRUE(UnmixMVGaussian(data, n, d, 2, COV_LOWRANK, m, 0, 0, &r) == 0,
+                    "Low-rank fit succeeds");
+        if (r.loglikelihood < prev - 1e-9 * fabs(prev)) {
+            printf("    LL fell at iteration %d: %.6f -> %.6f\n", m, prev, r.loglikelihood);
+            drops++;
+        }
+        prev = r.loglikelihood;
+        ReleaseMVMixtureResult(&r);
+    }
+    ASSERT_TRUE(drops == 0, "Low-rank LL is non-decreasing");
+    SetEMAcceleration(saved_accel);
+    SetLowRankDim(saved);
+    free(data);
+}
+
+/* ─── Test 13: tied covariance shared by all components ─── */
+void test_mv_tied(void) {
+    printf("Test: MV tied covariance\n");
+    unsigned seed = 5151;
+    int n = 6000, d = 4, k = 3;
+    double* data = malloc(sizeof(double) * n * d);
+    /* Σ = AAᵀ with A = [[1,0,0,0],[0.8,0.6,0,0],[0,0,1,0],[0,0,-0.5,1]],
+     * offset so the total-scatter M-step runs away from the origin */
+    for (int i = 0; i < n; i++) {
+        int j = i % k;
+        double z[4];
+        for (int a = 0; a < d; a++) z[a] = randn(0, 1, &seed);
+        double* x = &data[i*d];
+        x[0] = 50 + 6.0 * j + z[0];
+        x[1] = 50 - 6.0 * j + 0.8 * z[0] + 0.6 * z[1];
+        x[2] = 50 + (j == 1 ? 6.0 : 0.0) + z[2];
+        x[3] = 50 - 0.5 * z[2] + z[3];
+    }
+
+    MVMixtureResult r, f;
+    int rc = UnmixMVGaussian(data, n, d, k, COV_TIED, 300, 1e-6, 0, &r);
+    ASSERT_TRUE(rc == 0, "Tied fit succeeds");
+    int same = 1;
+    for (int j = 1; j < k; j++)
+        for (int e = 0; e < d * d; e++)
+            if (r.components[j].cov[e] != r.components[0].cov[e]) same = 0;
+    ASSERT_TRUE(same, "Every component holds the shared covariance");
+    const double* S = r.components[0].cov;
+    printf("    shared cov: %.2f %.2f %.2f | %.2f %.2f %.2f\n",
+           S[0], S[1], S[5], S[10], S[11], S[15]);
+    ASSERT_CLOSE(S[0], 1.0, 0.1, "Σ00 near 1");
+    ASSERT_CLOSE(S[1], 0.8, 0.1, "Σ01 near 0.8");
+    ASSERT_CLOSE(S[11], -0.5, 0.1, "Σ23 near -0.5");
+    ASSERT_CLOSE(S[15], 1.25, 0.1, "Σ33 near 1.25");
+    for (int j = 0; j < k; j++)
+        ASSERT_CLOSE(r.mixing_weights[j], 1.0 / 3, 0.02, "Weights near 1/3");
+
+    ASSERT_TRUE(UnmixMVGaussian(data, n, d, k, COV_FULL, 300, 1e-6, 0, &f) == 0,
+                "Full fit succeeds");
+    printf("    LL tied=%.1f  full=%.1f  BIC tied=%.1f  full=%.1f\n",
+           r.loglikelihood, f.loglikelihood, r.bic, f.bic);
+    ASSERT_CLOSE(r.loglikelihood, f.loglikelihood, 20.0, "Tied LL close to full");
+    ASSERT_TRUE(r.bic < f.bic, "Tied preferred by BIC");
+    ReleaseMVMixtureResult(&f);
+
+    /* A large constant offset must not cost precision in the whitened
+     * E-step: the same fit, translated */
+    for (int e = 0; e < n * d; e++) data[e] += 1e6;
+    ASSERT_TRUE(UnmixMVGaussian(data, n, d, k, COV_TIED, 300, 1e-6, 0, &f) == 0,
+                "Offset tied fit succeeds");
+    for (int e = 0; e < n * d; e++) data[e] -= 1e6;
+    printf("    LL offset=%.4f  original=%.4f\n", f.loglikelihood, r.loglikelihood);
+    ASSERT_CLOSE(f.loglikelihood, r.loglikelihood, 1e-3, "Offset LL matches");
+    double dev = 0;
+    for (int e = 0; e < d * d; e++)
+        dev = fmax(dev, fabs(f.components[0].cov[e] - r.components[0].cov[e]));
+    for (int j = 0; j < k; j++) {
+        dev = fmax(dev, fabs(f.mixing_weights[j] - r.mixing_weights[j]));
+        for (int a = 0; a < d; a++)
+            dev = fmax(dev, fabs(f.components[j].mean[a] - 1e6 - r.components[j].mean[a]));
+    }
+    ASSERT_TRUE(dev < 1e-5, "Offset fit matches the original, translated");
+    ReleaseMVMixtureResult(&r);
+    ReleaseMVMixtureResult(&f);
+
+    MVStudentTResult t;
+    ASSERT_TRUE(UnmixMVStudentT(data, n, d, k, COV_TIED, 10, 1e-6, 0, &t) == -1,
+                "Student-t rejects tied");
+    free(data);
+}
+
+/* ─── Test 14: kd-tree EM matches exact EM on separated clusters ─── */
+void test_mv_kdtree(void) {
+    printf("Test: MV kd-tree EM\n");
+    /* d = 2: fixed-dimension scatter kernel; d = 5: generic tiled scatter */
+    const int dims[3] = {2, 5, 3};
+    const CovType cts[3] = {COV_FULL, COV_DIAGONAL, COV_TIED};
+    double saved = GetMVKdTreeTolerance();
+    for (int t = 0; t < 3; t++) {
+        unsigned seed = 606 + t;
+        int n = 20000, d = dims[t], k = 3;
+        double* data = malloc(sizeof(double) * n * d);
+        for (int i = 0; i < n; i++)
+            for (int a = 0; a < d; a++)
+                data[i*d+a] = randn(8.0 * (i % k) * (a % 2 ? 1 : -1), 1 + 0.2 * a, &seed);
+
+        MVMixtureResult ex, kd;
+        SetMVKdTreeTolerance(0);
+        ASSERT_TRUE(UnmixMVGaussian(data, n, d, k, cts[t], 200, 1e-6, 0, &ex) == 0,
+                    "Exact fit succeeds");
+        SetMVKdTreeTolerance(1e-4);
+        ASSERT_TRUE(UnmixMVGaussian(data, n, d, k, cts[t], 200, 1e-6, 0, &kd) == 0,
+                    "kd-tree fit succeeds");
+
+        /* The kd-tree LL is the exact LL of its final parameters */
+        double ll = 0;
+        for (int i = 0; i < n; i++) {
+            double lp[3], mx = -1e300, tot = 0;
+            for (int j = 0; j < k; j++) {
+                lp[j] = log(kd.mixing_weights[j]) + mvgauss_logpdf(&data[i*d], &kd.components[j]);
+                if (lp[j] > mx) mx = lp[j];
+            }
+            for (int j = 0; j < k; j++) tot += exp(lp[j] - mx);
+            ll += mx + log(tot);
+        }
+        printf("    d=%d  LL exact=%.4f  kd-tree=%.4f  iters %d / %d\n",
+               d, ex.loglikelihood, kd.loglikelihood, ex.iterations, kd.iterations);
+        ASSERT_CLOSE(kd.loglikelihood, ll, 1e-9 * fabs(ll), "kd-tree LL is exact");
+        ASSERT_CLOSE(kd.loglikelihood, ex.loglikelihood, 1e-5 * fabs(ll), "kd-tree LL matches exact EM");
+        for (int j = 0; j < k; j++) {
+            int m = 0;   /* match components by their first coordinate */
+            for (int jj = 1; jj < k; jj++)
+                if (fabs(ex.components[jj].mean[0] - kd.components[j].mean[0]) <
+                    fabs(ex.components[m].mean[0] - kd.components[j].mean[0])) m = jj;
+            ASSERT_CLOSE(kd.mixing_weights[j], ex.mixing_weights[m], 1e-3, "Weights match exact EM");
+            ASSERT_CLOSE(kd.components[j].mean[d-1], ex.components[m].mean[d-1], 1e-2, "Means match exact EM");
+            ASSERT_CLOSE(kd.components[j].cov[0], ex.components[m].cov[0], 1e-2, "Variances match exact EM");
+        }
+        ReleaseMVMixtureResult(&ex);
+        ReleaseMVMixtureResult(&kd);
+        free(data);
+    }
+    SetMVKdTreeTolerance(saved);
+}
+
+/* ─── Test 15: SQUAREM reaches plain EM's optimum in fewer iterations ─── */
+void test_mv_squarem(void) {
+    printf("Test: MV SQUAREM acceleration\n");
+    int saved = GetEMAcceleration();
+    unsigned seed = 4242;
+    int n = 2000, d = 3, k = 3;
+    double* data = malloc(sizeof(double) * n * d);
+    /* Overlapping clusters: plain EM needs hundreds of iterations */
+    for (int i = 0; i < n; i++)
+        for (int a = 0; a < d; a++)
+            data[i*d+a] = randn(a == 0 ? 1.5 * (i % k) : 0.3 * (i % k), 1 + 0.2 * a * (i % k), &seed);
+
+    const CovType cts[4] = {COV_FULL, COV_DIAGONAL, COV_TIED, COV_LOWRANK};
+    for (int t = 0; t < 4; t++) {
+        MVMixtureResult em, sq;
+        SetEMAcceleration(0);
+        ASSERT_TRUE(UnmixMVGaussian(data, n, d, k, cts[t], 1000, 1e-6, 0, &em) == 0,
+                    "Plain EM fit succeeds");
+        SetEMAcceleration(1);
+        ASSERT_TRUE(UnmixMVGaussian(data, n, d, k, cts[t], 1000, 1e-6, 0, &sq) == 0,
+                    "SQUAREM fit succeeds");
+        printf("    cov=%d  LL plain=%.4f  SQUAREM=%.4f  iters %d / %d\n",
+               (int)cts[t], em.loglikelihood, sq.loglikelihood, em.iterations, sq.iterations);
+        ASSERT_TRUE(sq.loglikelihood > em.loglikelihood - 1e-3, "SQUAREM LL at least plain EM's");
+        ASSERT_TRUE(sq.iterations < em.iterations, "SQUAREM needs fewer iterations");
+        double wsum = 0;
+        for (int j = 0; j < k; j++) wsum += sq.mixing_weights[j];
+        ASSERT_CLOSE(wsum, 1.0, 1e-9, "SQUAREM weights sum to 1");
+        ReleaseMVMixtureResult(&em);
+        ReleaseMVMixtureResult(&sq);
+    }
+
+    /* maxiter ending right after an extrapolation returns the plain EM
+     * point it was built from, never the unchecked extrapolation */
+    {
+        MVMixtureResult em, sq;
+        SetEMAcceleration(0);
+        ASSERT_TRUE(UnmixMVGaussian(data, n, d, k, COV_FULL, 3, 0, 0, &em) == 0,
+                    "Plain EM 3 iterations");
+        SetEMAcceleration(1);
+        ASSERT_TRUE(UnmixMVGaussian(data, n, d, k, COV_FULL, 3, 0, 0, &sq) == 0,
+                    "SQUAREM 3 iterations");
+        double diff = 0;
+        for (int j = 0; j < k; j++) {
+            diff = fmax(diff, fabs(em.mixing_weights[j] - sq.mixing_weights[j]));
+            for (int a = 0; a < d; a++)
+                diff = fmax(diff, fabs(em.components[j].mean[a] - sq.components[j].mean[a]));
+        }
+        ASSERT_TRUE(diff < 1e-9, "Pending extrapolation replaced by u2 at maxiter");
+        ReleaseMVMixtureResult(&em);
+        ReleaseMVMixtureResult(&sq);
+    }
+
+    MVStudentTResult te, ts;
+    SetEMAcceleration(0);
+    ASSERT_TRUE(UnmixMVStudentT(data, n, d, k, COV_FULL, 1000, 1e-6, 0, &te) == 0,
+                "Plain Student-t fit succeeds");
+    SetEMAcceleration(1);
+    ASSERT_TRUE(UnmixMVStudentT(data, n, d, k, COV_FULL, 1000, 1e-6, 0, &ts) == 0,
+                "SQUAREM Student-t fit succeeds");
+    SetEMAcceleration(saved);
+    printf("    Student-t  LL plain=%.4f  SQUAREM=%.4f  iters %d / %d\n",
+           te.loglikelihood, ts.loglikelihood, te.iterations, ts.iterations);
+    ASSERT_TRUE(ts.loglikelihood > te.loglikelihood - 1e-2, "SQUAREM Student-t LL at least plain EM's");
+    ASSERT_TRUE(ts.iterations < te.iterations, "SQUAREM Student-t needs fewer iterations");
+    for (int j = 0; j < k; j++)
+        ASSERT_TRUE(ts.components[j].nu >= 1.0 && ts.components[j].nu <= 200.0, "ν stays in [1, 200]");
+    ReleaseMVStudentTResult(&te);
+    ReleaseMVStudentTResult(&ts);
+    free(data);
+}
+
+/* ─── Test 16: Student-t E-step against the per-point density ─── */
+void test_mv_t_estep(void) {
+    printf("Test: MV Student-t E-step vs direct multivariate-t density\n");
+    unsigned seed = 1616;
+    int n = 3000, d = 3, k = 2;
+    double* data = malloc(sizeof(double) * n * d);
+    /* Every tenth point three times further out: heavy tails */
+    for (int i = 0; i < n; i++)
+        for (int a = 0; a < d; a++)
+            data[i*d+a] = (i % 2 ? 4.0 : -2.0) * (a == 0) +
+                          randn(0, (1 + 0.3 * a) * (i % 10 ? 1.0 : 3.0), &seed);
+
+    int saved = GetEMAcceleration();
+    SetEMAcceleration(0);
+    const CovType cts[3] = {COV_FULL, COV_DIAGONAL, COV_SPHERICAL};
+    double* lp = malloc(sizeof(double) * n * k);
+    double* u = malloc(sizeof(double) * n * k);
+    for (int c = 0; c < 3; c++) {
+        MVStudentTResult r;
+        ASSERT_TRUE(UnmixMVStudentT(data, n, d, k, cts[c], 5000, 1e-9, 0, &r) == 0,
+                    "Student-t fit succeeds");
+        ASSERT_TRUE(r.iterations < 5000, "Student-t fit converges");
+
+        /* log t_ν(x; μ, Σ) = lnΓ((ν+d)/2) − lnΓ(ν/2) − (d/2)ln(νπ) − ½ln|Σ|
+         *                    − ((ν+d)/2) ln(1 + δ²/ν), Σ factored here */
+        for (int j = 0; j < k; j++) {
+            const MVStudentTParams* p = &r.components[j];
+            double L[9], ldet = 0, nu = p->nu;
+            for (int a = 0; a < d; a++)
+                for (int b = 0; b <= a; b++) {
+                    double v = p->cov[a*d+b];
+                    for (int e = 0; e < b; e++) v -= L[a*d+e] * L[b*d+e];
+                    L[a*d+b] = a == b ? sqrt(v) : v / L[b*d+b];
+                }
+            for (int a = 0; a < d; a++) ldet += 2 * log(L[a*d+a]);
+            double base = log(r.mixing_weights[j]) + lgamma((nu + d) / 2) - lgamma(nu / 2)
+                        - 0.5 * d * log(nu * M_PI) - 0.5 * ldet;
+            for (int i = 0; i < n; i++) {
+                double z[3], d2 = 0;
+                for (int a = 0; a < d; a++) {
+                    double v = data[i*d+a] - p->mean[a];
+                    for (int e = 0; e < a; e++) v -= L[a*d+e] * z[e];
+                    z[a] = v / L[a*d+a];
+                    d2 += z[a] * z[a];
+                }
+                lp[i*k+j] = base - 0.5 * (nu + d) * log1p(d2 / nu);
+                u[i*k+j] = (nu + d) / (nu + d2);
+            }
+        }
+        double ll = 0, nj[2] = {0, 0}, su[2] = {0, 0}, sx[2][3] = {{0}};
+        for (int i = 0; i < n; i++) {
+            double mx = fmax(lp[i*k], lp[i*k+1]);
+            double tot = exp(lp[i*k] - mx) + exp(lp[i*k+1] - mx);
+            ll += mx + log(tot);
+            for (int j = 0; j < k; j++) {
+                double rij = exp(lp[i*k+j] - mx) / tot, ru = rij * u[i*k+j];
+                nj[j] += rij;
+                su[j] += ru;
+                for (int a = 0; a < d; a++) sx[j][a] += ru * data[i*d+a];
+            }
+        }
+        printf("    cov=%d  LL engine=%.6f  direct=%.6f  nu=%.2f,%.2f\n", (int)cts[c],
+               r.loglikelihood, ll, r.components[0].nu, r.components[1].nu);
+        /* The engine reports the LL of the E-step before its last M-step,
+         * within rtole of the final parameters' */
+        ASSERT_CLOSE(r.loglikelihood, ll, 1e-6, "Student-t LL matches the direct density");
+        /* At the fixed point the direct responsibilities and u-weights
+         * reproduce the fitted weights and means */
+        double dev = 0;
+        for (int j = 0; j < k; j++) {
+            dev = fmax(dev, fabs(nj[j] / n - r.mixing_weights[j]));
+            for (int a = 0; a < d; a++)
+                dev = fmax(dev, fabs(sx[j][a] / su[j] - r.components[j].mean[a]));
+        }
+        ASSERT_TRUE(dev < 1e-5, "Direct responsibilities reproduce weights and means");
+        ReleaseMVStudentTResult(&r);
+    }
+    SetEMAcceleration(saved);
+    free(lp);
+    free(u);
+    free(data);
+}
+
 int main(void) {
     printf("\n========================================\n");
     printf("  Multivariate EM Tests\n");
@@ -267,6 +764,15 @@ int main(void) {
     test_bic_k_selection();
     test_mv_studentt();
     test_mv_autok();
+    test_multires();
+    test_mv_incremental();
+    test_mv_blocked_estep();
+    test_mv_thread_invariance();
+    test_mv_lowrank();
+    test_mv_tied();
+    test_mv_kdtree();
+    test_mv_squarem();
+    test_mv_t_estep();
 
     printf("\n========================================\n");
     printf("  Results: %d/%d passed", tests_passed, tests_run);
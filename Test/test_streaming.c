@@ -0,0 +1,987 @@
+/*
+ * Tests for file-based streaming EM and its text reader.
+ * Copyright 2022-2026, Micah Thornton and Chanhee Park
+ * License: GPL v3
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include <string.h>
+#include "textio.h"
+#include "streaming.h"
+#include "binfile.h"
+#include "complex_em.h"
+#include "prefetch.h"
+#include "distributions.h"
+#include "checkpoint.h"
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <signal.h>
+#include <unistd.h>
+#include <sys/wait.h>
+#endif
+
+static int tests_passed = 0;
+static int tests_failed = 0;
+
+#define ASSERT(cond, msg) do { \
+    if (!(cond)) { \
+        printf("  FAIL: %s (line %d)\n", msg, __LINE__); \
+        tests_failed++; \
+    } else { \
+        tests_passed++; \
+    } \
+} while(0)
+
+#define ASSERT_NEAR(a, b, tol, msg) do { \
+    if (fabs((a)-(b)) > (tol)) { \
+        printf("  FAIL: %s: %.6f != %.6f (tol=%.6f, line %d)\n", msg, (double)(a), (double)(b), (double)(tol), __LINE__); \
+        tests_failed++; \
+    } else { \
+        tests_passed++; \
+    } \
+} while(0)
+
+static double randn(void) {
+    double u = (rand() % 100000 + 1) / 100001.0;
+    double v = (rand() % 100000 + 1) / 100001.0;
+    return sqrt(-2.0 * log(u)) * cos(2.0 * 3.14159265 * v);
+}
+
+static void write_file(const char* path, const char* text) {
+    FILE* f = fopen(path, "wb");
+    fputs(text, f);
+    fclose(f);
+}
+
+/* ── FastParseDouble agrees with strtod ── */
+static void test_parse_matches_strtod(void) {
+    printf("Test: FastParseDouble vs strtod\n");
+    static const char* fixed[] = {
+        "0", "-0", "1", "-1", "3.14159", "1e10", "1E-10", "+2.5", ".5", "5.",
+        "-0.000123", "123456789012345678", "1.7976931348623157e308",
+        "2.2250738585072014e-308", "4.9e-324", "1e-400", "1e400",
+        "0.1", "0.30000000000000004", "9007199254740993",
+        "1234567890123456789012345", "0.000000000000000000000000001234",
+        "6.02214076e23", "  42.5", "\t-7", "1e", "1e+", "3.0abc"
+    };
+    int bad = 0;
+    for (size_t i = 0; i < sizeof(fixed) / sizeof(fixed[0]); i++) {
+        const char* s = fixed[i];
+        const char* e = s + strlen(s);
+        const char* next;
+        double a = FastParseDouble(s, e, &next);
+        char* ref_end;
+        double b = strtod(s, &ref_end);
+        if (!(a == b && signbit(a) == signbit(b)) || next != ref_end) {
+            printf("    '%s': got %.17g, strtod %.17g\n", s, a, b);
+            bad++;
+        }
+    }
+    ASSERT(bad == 0, "fixed strings parse exactly as strtod");
+
+    /* Random values at %.6g, %.10g and %.15g round-trip exactly */
+    srand(17);
+    bad = 0;
+    char buf[64];
+    for (int i = 0; i < 30000; i++) {
+        double x = randn() * pow(10.0, (rand() % 40) - 20);
+        const char* fmt = i % 3 == 0 ? "%.6g" : i % 3 == 1 ? "%.10g" : "%.15g";
+        snprintf(buf, sizeof(buf), fmt, x);
+        double a = FastParseDouble(buf, buf + strlen(buf), NULL);
+        if (a != strtod(buf, NULL)) bad++;
+    }
+    ASSERT(bad == 0, "up to 15 digits is correctly rounded");
+
+    /* %.17g: at most one ulp away (long double path) */
+    int far = 0;
+    for (int i = 0; i < 30000; i++) {
+        double x = randn() * pow(10.0, (rand() % 40) - 20);
+        snprintf(buf, sizeof(buf), "%.17g", x);
+        double a = FastParseDouble(buf, buf + strlen(buf), NULL);
+        double b = strtod(buf, NULL);
+        if (a != b && nextafter(a, b) != b) far++;
+    }
+    ASSERT(far == 0, "17 digits within one ulp");
+
+    const char* inf = "-inf";
+    ASSERT(isinf(FastParseDouble(inf, inf + 4, NULL)), "inf via slow path");
+    const char* nan_s = "nan";
+    ASSERT(isnan(FastParseDouble(nan_s, nan_s + 3, NULL)), "nan via slow path");
+}
+
+/* ── Line rules: comments, blank lines, CRLF, no final newline ── */
+static void test_reader_lines(void) {
+    printf("Test: TextReader line handling\n");
+    const char* path = "test_streaming_lines.tmp";
+    write_file(path,
+        "# header comment\n"
+        "1.5\n"
+        "\n"
+        "-2.25\r\n"
+        "\r\n"
+        "   \n"
+        "3e2 trailing words\n"
+        "#1000\n"
+        "junk\n"
+        "  7");
+    const double expect[] = { 1.5, -2.25, 300.0, 0.0, 7.0 };
+
+    for (int mode = 0; mode < 2; mode++) {
+        TextReader* r = TextReaderOpen(path, mode ? TEXTIO_NO_MMAP : 0);
+        ASSERT(r != NULL, "open");
+        if (!r) continue;
+        double v[16];
+        size_t n = 0, got;
+        /* Read two at a time to exercise resumption between calls */
+        while ((got = TextReaderRead(r, v + n, 2)) > 0) n += got;
+        ASSERT(n == 5, "five values");
+        int ok = 1;
+        for (size_t i = 0; i < n && i < 5; i++) ok &= (v[i] == expect[i]);
+        ASSERT(ok, "values and order");
+
+        TextReaderRewind(r);
+        ASSERT(TextReaderOffset(r) == 0, "offset reset on rewind");
+        ASSERT(TextReaderRead(r, v, 16) == 5, "same values after rewind");
+        TextReaderClose(r);
+    }
+    remove(path);
+
+    ASSERT(TextReaderOpen("does_not_exist.tmp", 0) == NULL, "missing file -> NULL");
+}
+
+/* ── Block mode across several refills matches the mapped reader ── */
+static void test_reader_blocks(void) {
+    printf("Test: TextReader block refills\n");
+    const char* path = "test_streaming_blocks.tmp";
+    FILE* f = fopen(path, "wb");
+    size_t n = 600000;   /* ~11 MB: several 4 MB blocks, lines cut at edges */
+    srand(23);
+    double sum_ref = 0;
+    for (size_t i = 0; i < n; i++) {
+        char buf[32];
+        if (i % 1000 == 0) fputs("# comment line\n", f);
+        snprintf(buf, sizeof(buf), "%.12f", randn() * 1000.0);
+        fprintf(f, "%s\n", buf);
+        sum_ref += strtod(buf, NULL);
+    }
+    fclose(f);
+
+    for (int mode = 0; mode < 2; mode++) {
+        TextReader* r = TextReaderOpen(path, mode ? TEXTIO_NO_MMAP : 0);
+        ASSERT(r != NULL, "open");
+        if (!r) continue;
+        double* v = (double*)malloc(sizeof(double) * 7777);
+        size_t total = 0, got;
+        double sum = 0;
+        for (int pass = 0; pass < 2; pass++) {
+            TextReaderRewind(r);
+            total = 0; sum = 0;
+            while ((got = TextReaderRead(r, v, 7777)) > 0) {
+                for (size_t i = 0; i < got; i++) sum += v[i];
+                total += got;
+            }
+        }
+        ASSERT(total == n, "value count");
+        ASSERT_NEAR(sum, sum_ref, 1e-6 * fabs(sum_ref) + 1e-6, "value sum");
+        free(v);
+        TextReaderClose(r);
+    }
+    remove(path);
+}
+
+/* ── UnmixStreaming end to end on a two-component file ── */
+static void test_streaming_gaussian(void) {
+    printf("Test: UnmixStreaming two Gaussians\n");
+    const char* path = "test_streaming_gauss.tmp";
+    FILE* f = fopen(path, "w");
+    srand(42);
+    fprintf(f, "# two components\n");
+    for (int i = 0; i < 20000; i++)
+        fprintf(f, "%.8f\n", (i % 2 ? 5.0 : -5.0) + randn());
+    fclose(f);
+
+    StreamConfig cfg;
+    memset(&cfg, 0, sizeof(cfg));
+    cfg.family = DIST_GAUSSIAN;
+    cfg.num_components = 2;
+    cfg.chunk_size = 2000;
+    cfg.max_passes = 10;
+    cfg.rtole = 1e-6;
+
+    MixtureResult res;
+    int rc = UnmixStreaming(path, &cfg, &res);
+    ASSERT(rc == 0, "rc == 0");
+    if (rc == 0) {
+        double lo = fmin(res.params[0].p[0], res.params[1].p[0]);
+        double hi = fmax(res.params[0].p[0], res.params[1].p[0]);
+        ASSERT_NEAR(lo, -5.0, 0.2, "lower mean");
+        ASSERT_NEAR(hi, 5.0, 0.2, "upper mean");
+        ASSERT_NEAR(res.mixing_weights[0], 0.5, 0.05, "weight");
+        ASSERT(isfinite(res.loglikelihood), "finite LL");
+        ReleaseMixtureResult(&res);
+    }
+    remove(path);
+
+    ASSERT(UnmixStreaming("does_not_exist.tmp", &cfg, &res) == -3, "missing file -> -3");
+}
+
+/* ── Non-Gaussian families take the generic log-sum-exp E-step; the
+ *    reported LL must match the fitted mixture evaluated directly ── */
+static void test_streaming_gamma_generic(void) {
+    printf("Test: UnmixStreaming two Gammas (generic E-step)\n");
+    const char* path = "test_streaming_gamma.tmp";
+    const int n = 20000;
+    double* xs = (double*)malloc(sizeof(double) * n);
+    FILE* f = fopen(path, "w");
+    srand(11);
+    for (int i = 0; i < n; i++) {
+        /* Gamma(20, rate) as a sum of exponentials: means 2 and 10 */
+        double rate = i % 2 ? 2.0 : 10.0, v = 0;
+        for (int s = 0; s < 20; s++) v -= log((rand() % 100000 + 1) / 100001.0);
+        xs[i] = v / rate;
+        fprintf(f, "%.10f\n", xs[i]);
+    }
+    fclose(f);
+
+    StreamConfig cfg;
+    memset(&cfg, 0, sizeof(cfg));
+    cfg.family = DIST_GAMMA;
+    cfg.num_components = 2;
+    cfg.chunk_size = 3000;
+    cfg.max_passes = 15;
+    cfg.rtole = 1e-7;
+
+    MixtureResult res;
+    int rc = UnmixStreaming(path, &cfg, &res);
+    ASSERT(rc == 0, "rc == 0");
+    if (rc == 0) {
+        double m0 = res.params[0].p[0] / res.params[0].p[1];
+        double m1 = res.params[1].p[0] / res.params[1].p[1];
+        ASSERT_NEAR(fmin(m0, m1), 2.0, 0.2, "lower mean");
+        ASSERT_NEAR(fmax(m0, m1), 10.0, 0.5, "upper mean");
+
+        const DistFunctions* df = GetDistFunctions(DIST_GAMMA);
+        double ll = 0;
+        for (int i = 0; i < n; i++) {
+            double tot = 0;
+            for (int j = 0; j < 2; j++)
+                tot += res.mixing_weights[j] * exp(df->logpdf(xs[i], &res.params[j]));
+            ll += log(tot);
+        }
+        ASSERT_NEAR(res.loglikelihood, ll, 1e-6 * fabs(ll), "LL matches direct evaluation");
+        ReleaseMixtureResult(&res);
+    }
+    free(xs);
+    remove(path);
+}
+
+/* ── Student-t through the ECM statistic map: location, scale and the
+ *    degrees of freedom are recovered, which a per-chunk refit is not ── */
+static void test_streaming_studentt_ecm(void) {
+    printf("Test: UnmixStreaming two Student-t (ECM statistics)\n");
+    const char* path = "test_streaming_t.tmp";
+    FILE* f = fopen(path, "w");
+    srand(17);
+    for (int i = 0; i < 150000; i++) {
+        /* t(4) = N(0,1) / sqrt(chi2(4)/4), chi2(4) = 2·(E1 + E2) */
+        double e = -log((rand() % 100000 + 1) / 100001.0)
+                   - log((rand() % 100000 + 1) / 100001.0);
+        fprintf(f, "%.9f\n", (i % 3 ? 3.0 : -4.0) + randn() / sqrt(0.5 * e));
+    }
+    fclose(f);
+
+    StreamConfig cfg;
+    memset(&cfg, 0, sizeof(cfg));
+    cfg.family = DIST_STUDENT_T;
+    cfg.num_components = 2;
+    cfg.chunk_size = 5000;
+    cfg.max_passes = 6;
+    cfg.rtole = 1e-9;
+    MixtureResult res;
+    ASSERT(UnmixStreaming(path, &cfg, &res) == 0, "rc == 0");
+    int lo = res.params[0].p[0] < res.params[1].p[0] ? 0 : 1;
+    ASSERT_NEAR(res.params[lo].p[0], -4.0, 0.05, "lower location");
+    ASSERT_NEAR(res.params[1 - lo].p[0], 3.0, 0.05, "upper location");
+    ASSERT_NEAR(res.params[lo].p[1], 1.0, 0.1, "scale");
+    ASSERT(res.params[lo].p[2] > 3 && res.params[lo].p[2] < 5.5 &&
+           res.params[1 - lo].p[2] > 3 && res.params[1 - lo].p[2] < 5.5, "df near 4");
+    ASSERT_NEAR(res.mixing_weights[lo], 1.0 / 3, 0.02, "weight");
+    ReleaseMixtureResult(&res);
+    remove(path);
+}
+
+/* ── Input shorter than the warm-up prefix: initialized from all of it,
+ *    EM from the second pass on ── */
+static void test_streaming_short_input(void) {
+    printf("Test: UnmixStreaming on a file shorter than the warm-up prefix\n");
+    const char* path = "test_streaming_short.tmp";
+    FILE* f = fopen(path, "w");
+    srand(5);
+    /* Skewed: 90% near 0, 10% near 8 */
+    for (int i = 0; i < 3000; i++)
+        fprintf(f, "%.8f\n", (i % 10 ? 0.0 : 8.0) + 0.5 * randn());
+    fclose(f);
+
+    StreamConfig cfg;
+    memset(&cfg, 0, sizeof(cfg));
+    cfg.family = DIST_GAUSSIAN;
+    cfg.num_components = 2;
+    cfg.chunk_size = 500;
+    cfg.max_passes = 20;
+    MixtureResult res;
+    int rc = UnmixStreaming(path, &cfg, &res);
+    ASSERT(rc == 0, "rc == 0");
+    if (rc == 0) {
+        int lo = res.params[0].p[0] < res.params[1].p[0] ? 0 : 1;
+        ASSERT_NEAR(res.params[lo].p[0], 0.0, 0.3, "major component mean");
+        ASSERT_NEAR(res.mixing_weights[lo], 0.9, 0.05, "major component weight");
+        ReleaseMixtureResult(&res);
+    }
+    remove(path);
+
+    write_file(path, "# comments only\n\n");
+    ASSERT(UnmixStreaming(path, &cfg, &res) == -4, "no values -> -4");
+    remove(path);
+}
+
+/* ── ll_from_last_pass: no trailing scan, LL close to the exact one ── */
+static void test_streaming_last_pass_ll(void) {
+    printf("Test: final LL from the last streaming pass\n");
+    const char* path = "test_streaming_llpass.tmp";
+    FILE* f = fopen(path, "w");
+    srand(23);
+    for (int i = 0; i < 100000; i++)
+        fprintf(f, "%.9f\n", (i % 4 ? -2.0 : 3.0) + randn());
+    fclose(f);
+
+    StreamConfig cfg;
+    memset(&cfg, 0, sizeof(cfg));
+    cfg.family = DIST_GAUSSIAN;
+    cfg.num_components = 2;
+    cfg.chunk_size = 5000;
+    cfg.max_passes = 10;
+    cfg.rtole = 1e-7;
+    MixtureResult exact, last;
+    ASSERT(UnmixStreaming(path, &cfg, &exact) == 0, "exact rc");
+    cfg.ll_from_last_pass = 1;
+    ASSERT(UnmixStreaming(path, &cfg, &last) == 0, "last-pass rc");
+    ASSERT(exact.params[0].p[0] == last.params[0].p[0], "same fit");
+    ASSERT_NEAR(last.loglikelihood, exact.loglikelihood,
+                1e-3 * fabs(exact.loglikelihood), "LL within 0.1%");
+    ASSERT(last.bic > 0 && isfinite(last.bic), "BIC from last-pass LL");
+    ReleaseMixtureResult(&exact);
+    ReleaseMixtureResult(&last);
+
+    /* A single pass (EM after the warm-up prefix): scaled to all values */
+    cfg.max_passes = 1;
+    cfg.ll_from_last_pass = 0;
+    ASSERT(UnmixStreaming(path, &cfg, &exact) == 0, "one-pass exact rc");
+    cfg.ll_from_last_pass = 1;
+    ASSERT(UnmixStreaming(path, &cfg, &last) == 0, "one-pass rc");
+    ASSERT_NEAR(last.loglikelihood, exact.loglikelihood,
+                1e-2 * fabs(exact.loglikelihood), "one-pass LL scaled to n");
+    ReleaseMixtureResult(&exact);
+    ReleaseMixtureResult(&last);
+    remove(path);
+}
+
+/* ── One-pass online engine: stdin-style stream, snapshots, early stop ── */
+typedef struct { int calls; size_t last_n; int stop_after; } SnapLog;
+
+static int snap_cb(const MixtureResult* model, size_t n_seen, void* ctx) {
+    SnapLog* log = (SnapLog*)ctx;
+    log->calls++;
+    log->last_n = n_seen;
+    (void)model;
+    return log->stop_after > 0 && log->calls >= log->stop_after;
+}
+
+static void test_streaming_online(void) {
+    printf("Test: UnmixStreamingOnline over a pipe\n");
+    const char* path = "test_streaming_online.tmp";
+    FILE* f = fopen(path, "w");
+    srand(31);
+    for (int i = 0; i < 200000; i++)
+        fprintf(f, "%.9f\n", (i % 2 ? 4.0 : -1.0) + randn());
+    fclose(f);
+
+    StreamConfig cfg;
+    memset(&cfg, 0, sizeof(cfg));
+    cfg.family = DIST_GAUSSIAN;
+    cfg.num_components = 2;
+    cfg.chunk_size = 4000;
+    cfg.snapshot_every = 50000;
+    cfg.snapshot = snap_cb;
+    SnapLog log = { 0, 0, 0 };
+    cfg.snapshot_ctx = &log;
+
+    MixtureResult ra, rb;
+    f = fopen(path, "rb");
+    ASSERT(UnmixStreamingOnline(f, &cfg, &ra) == 0, "file rc");
+    fclose(f);
+    ASSERT(log.calls == 4 && log.last_n == 200000, "snapshot every 50000 values");
+    double lo = fmin(ra.params[0].p[0], ra.params[1].p[0]);
+    double hi = fmax(ra.params[0].p[0], ra.params[1].p[0]);
+    ASSERT_NEAR(lo, -1.0, 0.1, "lower mean");
+    ASSERT_NEAR(hi, 4.0, 0.1, "upper mean");
+    ASSERT(isfinite(ra.loglikelihood) && isfinite(ra.bic), "finite LL/BIC");
+
+    /* A pipe delivers the same values in arbitrary pieces: same fit */
+    char cmd[256];
+    snprintf(cmd, sizeof(cmd), "cat %s", path);
+    FILE* pipe = popen(cmd, "r");
+    log.calls = 0;
+    ASSERT(pipe && UnmixStreamingOnline(pipe, &cfg, &rb) == 0, "pipe rc");
+    if (pipe) pclose(pipe);
+    ASSERT(ra.params[0].p[0] == rb.params[0].p[0] &&
+           ra.loglikelihood == rb.loglikelihood, "pipe fit identical to file");
+    ReleaseMixtureResult(&ra);
+    ReleaseMixtureResult(&rb);
+
+    /* The callback can end an unbounded stream */
+    log.calls = 0;
+    log.stop_after = 2;
+    f = fopen(path, "rb");
+    ASSERT(UnmixStreamingOnline(f, &cfg, &ra) == 0, "stopped rc");
+    fclose(f);
+    ASSERT(log.calls == 2 && log.last_n == 100000, "stopped after second snapshot");
+    ReleaseMixtureResult(&ra);
+
+    ASSERT(UnmixStreamingOnline(NULL, &cfg, &ra) == -1, "NULL stream -> -1");
+
+    /* Checkpoints would re-read the input: refused in one-pass mode */
+    cfg.checkpoint_path = "test_streaming_online.ckpt";
+    f = fopen(path, "rb");
+    ASSERT(UnmixStreamingOnline(f, &cfg, &ra) == -1, "checkpoint_path -> -1");
+    fclose(f);
+    cfg.checkpoint_path = NULL;
+    remove(path);
+}
+
+#if defined(__unix__) || defined(__APPLE__)
+/* Stop at the first snapshot, once the reader has had time to block */
+static int snap_stop_cb(const MixtureResult* model, size_t n_seen, void* ctx) {
+    usleep(200000);
+    return snap_cb(model, n_seen, ctx);
+}
+#endif
+
+/* Stopping must not wait for a writer that keeps the pipe open */
+static void test_streaming_online_stop(void) {
+#if defined(__unix__) || defined(__APPLE__)
+    printf("Test: UnmixStreamingOnline stops on an open pipe\n");
+    StreamConfig cfg;
+    memset(&cfg, 0, sizeof(cfg));
+    cfg.family = DIST_GAUSSIAN;
+    cfg.num_components = 2;
+    cfg.chunk_size = 4000;
+    cfg.snapshot_every = 4000;
+    cfg.snapshot = snap_stop_cb;
+    SnapLog log = { 0, 0, 1 };
+    cfg.snapshot_ctx = &log;
+    MixtureResult ra;
+
+    srand(37);
+    int fds[2];
+    ASSERT(pipe(fds) == 0, "pipe");
+    fflush(stdout);
+    pid_t pid = fork();
+    if (pid == 0) {
+        close(fds[0]);
+        FILE* w = fdopen(fds[1], "w");
+        for (int i = 0; i < 68000; i++)   /* just past the warm-up */
+            fprintf(w, "%.9f\n", (i % 2 ? 4.0 : -1.0) + randn());
+        fflush(w);
+        alarm(40);   /* outlive the reader, but never the test run */
+        pause();
+        _exit(0);
+    }
+    ASSERT(pid > 0, "fork");
+    if (pid > 0) {
+        close(fds[1]);
+        FILE* rd = fdopen(fds[0], "rb");
+        alarm(30);   /* a hang fails the test instead of blocking ctest */
+        ASSERT(UnmixStreamingOnline(rd, &cfg, &ra) == 0, "stop on open pipe rc");
+        alarm(0);
+        ASSERT(log.calls == 1, "stopped at first snapshot");
+        ReleaseMixtureResult(&ra);
+        kill(pid, SIGKILL);
+        waitpid(pid, NULL, 0);
+        fclose(rd);
+    }
+#endif
+}
+
+/* ── Drift tracking: forgetting follows a regime shift, split/merge
+ *    re-seeds a component onto a mode that appears mid-stream ── */
+static void write_drift(const char* path, double shifted, int three) {
+    FILE* f = fopen(path, "w");
+    srand(43);
+    for (int i = 0; i < 300000; i++) {
+        int late = i >= 150000;
+        double mu = i % 2 ? 0.0 : late && !three ? shifted : 5.0;
+        if (three && late && i % 3 == 0) mu = shifted;
+        fprintf(f, "%.9f\n", mu + randn());
+    }
+    fclose(f);
+}
+
+static void test_streaming_drift(void) {
+    printf("Test: streaming drift tracking (half-life, split/merge)\n");
+    const char* path = "test_streaming_drift.tmp";
+    write_drift(path, 12.0, 0);
+
+    StreamConfig cfg;
+    memset(&cfg, 0, sizeof(cfg));
+    cfg.family = DIST_GAUSSIAN;
+    cfg.num_components = 2;
+    cfg.chunk_size = 2000;
+    cfg.halflife = 10000;
+
+    MixtureResult r;
+    FILE* f = fopen(path, "rb");
+    ASSERT(UnmixStreamingOnline(f, &cfg, &r) == 0, "half-life rc");
+    fclose(f);
+    double hi = fmax(r.params[0].p[0], r.params[1].p[0]);
+    double lo = fmin(r.params[0].p[0], r.params[1].p[0]);
+    ASSERT_NEAR(hi, 12.0, 0.2, "upper mode followed to 12");
+    ASSERT_NEAR(lo, 0.0, 0.2, "lower mode kept");
+    int up = r.params[1].p[0] > r.params[0].p[0];
+    ASSERT_NEAR(r.params[up].p[1], 1.0, 0.15, "old regime forgotten (variance)");
+    /* Forgetting-weighted LL: that of the current regime, two separated
+     * unit Gaussians with equal weights */
+    ASSERT_NEAR(r.loglikelihood / 300000.0, -(1.4189385 + log(2.0)), 0.05,
+                "LL per value of the current regime");
+    ReleaseMixtureResult(&r);
+
+    /* k = 3 on two modes; a third mode at 20 appears halfway */
+    write_drift(path, 20.0, 1);
+    cfg.num_components = 3;
+    cfg.split_merge = 1;
+    f = fopen(path, "rb");
+    ASSERT(UnmixStreamingOnline(f, &cfg, &r) == 0, "split/merge rc");
+    fclose(f);
+    int far = 0;
+    for (int j = 1; j < 3; j++) if (r.params[j].p[0] > r.params[far].p[0]) far = j;
+    ASSERT_NEAR(r.params[far].p[0], 20.0, 0.2, "component re-seeded onto the new mode");
+    ASSERT_NEAR(r.mixing_weights[far], 1.0 / 3, 0.03, "new mode's weight");
+    ReleaseMixtureResult(&r);
+    remove(path);
+}
+
+/* ── GEMBIN round trip for every dtype, and header validation ── */
+static void test_binfile_roundtrip(void) {
+    printf("Test: GEMBIN write/map round trip\n");
+    const char* path = "test_streaming_bin.tmp";
+    double rows[3 * 4] = { 1.5, -2.25, 1e10,   0.1, 7.0, -0.0,
+                           300.7, -40000.0, 3.0,  -1.5, 2.5, 12.0 };
+    const GemBinType types[3] = { GEMBIN_F64, GEMBIN_F32, GEMBIN_CI16 };
+    for (int t = 0; t < 3; t++) {
+        /* 4 rows × 3 doubles, or 2 rows of 3 complex values for CI16 */
+        int dim = 3;
+        size_t nrows = types[t] == GEMBIN_CI16 ? 2 : 4;
+        GemBinWriter* w = GemBinWriterOpen(path, types[t], dim);
+        ASSERT(w != NULL, "writer open");
+        if (!w) continue;
+        ASSERT(GemBinWriterAppend(w, rows, 1) == 0, "append 1 row");
+        ASSERT(GemBinWriterAppend(w, rows + (types[t] == GEMBIN_CI16 ? 6 : 3),
+                                  nrows - 1) == 0, "append rest");
+        ASSERT(GemBinWriterClose(w) == 0, "writer close");
+        ASSERT(GemBinIsFile(path), "magic detected");
+
+        GemBin b;
+        ASSERT(GemBinOpen(path, &b) == 0, "open");
+        ASSERT(b.count == nrows, "row count");
+        ASSERT(b.width == (types[t] == GEMBIN_CI16 ? 6 : 3), "decoded width");
+        double buf[12], full[12];
+        const double* x = GemBinRows(&b, 0, b.count, buf);
+        int ok = 1;
+        for (size_t i = 0; i < b.count * (size_t)b.width; i++) {
+            full[i] = x[i];
+            double want = types[t] == GEMBIN_F64 ? rows[i]
+                        : types[t] == GEMBIN_F32 ? (double)(float)rows[i]
+                        : fmax(-32768.0, fmin(32767.0, floor(rows[i] + 0.5)));
+            ok &= (x[i] == want);
+        }
+        ASSERT(ok, "values survive the round trip");
+        if (types[t] == GEMBIN_F64)
+            ASSERT(GemBinData(&b) == x && x != buf, "f64 is zero-copy");
+        else
+            ASSERT(GemBinData(&b) == NULL && x == buf, "f32/ci16 decode into buf");
+        x = GemBinRows(&b, 1, 1, buf);
+        ASSERT(x[0] == full[b.width] && x[b.width - 1] == full[2 * b.width - 1], "row offset");
+        GemBinClose(&b);
+    }
+
+    /* Count larger than the payload is rejected */
+    FILE* f = fopen(path, "r+b");
+    unsigned char big[8] = { 0xff, 0xff, 0, 0, 0, 0, 0, 0 };
+    fseek(f, 16, SEEK_SET);
+    fwrite(big, 1, 8, f);
+    fclose(f);
+    GemBin b;
+    ASSERT(GemBinOpen(path, &b) == -1, "truncated payload -> -1");
+
+    write_file(path, "1.0\n2.0\n");
+    ASSERT(!GemBinIsFile(path), "text is not GEMBIN");
+    ASSERT(GemBinOpen(path, &b) == -1, "text -> -1");
+    remove(path);
+}
+
+/* ── Streaming engines give the same fit from text and GEMBIN ── */
+static void test_streaming_binary_matches_text(void) {
+    printf("Test: streaming on GEMBIN matches text\n");
+    const char* txt = "test_streaming_bt.tmp";
+    const char* bin = "test_streaming_bb.tmp";
+    srand(99);
+    FILE* f = fopen(txt, "w");
+    GemBinWriter* w = GemBinWriterOpen(bin, GEMBIN_F64, 1);
+    for (int i = 0; i < 10000; i++) {
+        char s[32];
+        snprintf(s, sizeof(s), "%.10g", (i % 3 ? 2.0 : -3.0) + randn());
+        fprintf(f, "%s\n", s);
+        double v = strtod(s, NULL);
+        GemBinWriterAppend(w, &v, 1);
+    }
+    fclose(f);
+    GemBinWriterClose(w);
+
+    StreamConfig cfg;
+    memset(&cfg, 0, sizeof(cfg));
+    cfg.family = DIST_GAUSSIAN;
+    cfg.num_components = 2;
+    cfg.chunk_size = 1000;
+    cfg.max_passes = 5;
+    MixtureResult rt, rb;
+    ASSERT(UnmixStreaming(txt, &cfg, &rt) == 0, "text rc");
+    ASSERT(UnmixStreaming(bin, &cfg, &rb) == 0, "binary rc");
+    ASSERT(rt.loglikelihood == rb.loglikelihood, "identical LL");
+    ASSERT(rt.params[0].p[0] == rb.params[0].p[0], "identical mean");
+    ReleaseMixtureResult(&rt);
+    ReleaseMixtureResult(&rb);
+
+    /* Complex: CI16 IQ samples vs the same integers as text */
+    f = fopen(txt, "w");
+    w = GemBinWriterOpen(bin, GEMBIN_CI16, 1);
+    for (int i = 0; i < 6000; i++) {
+        double z[2] = { floor((i % 2 ? 200.0 : -200.0) + 30.0 * randn() + 0.5),
+                        floor(30.0 * randn() + 0.5) };
+        fprintf(f, "%.0f,%.0f\n", z[0], z[1]);
+        GemBinWriterAppend(w, z, 1);
+    }
+    fclose(f);
+    GemBinWriterClose(w);
+
+    ComplexStreamConfig cc;
+    memset(&cc, 0, sizeof(cc));
+    cc.num_components = 2;
+    cc.chunk_size = 1000;
+    cc.max_passes = 5;
+    cc.type = CGAUSS_CIRCULAR;
+    CCircMixtureResult ct, cb;
+    ASSERT(UnmixComplexStreaming(txt, &cc, &ct) == 0, "complex text rc");
+    ASSERT(UnmixComplexStreaming(bin, &cc, &cb) == 0, "complex binary rc");
+    ASSERT(ct.loglikelihood == cb.loglikelihood, "complex identical LL");
+    ReleaseCCircResult(&ct);
+    ReleaseCCircResult(&cb);
+
+    /* One-column engine rejects a two-column file */
+    MixtureResult r;
+    ASSERT(UnmixStreaming(bin, &cfg, &r) == -1, "width mismatch -> -1");
+    remove(txt);
+    remove(bin);
+}
+
+/* ── Prefetch ring delivers every chunk once, in order ── */
+typedef struct { size_t next, n; } CountSource;
+
+static size_t count_read(void* ctx, double* buf, size_t max, const double** rows) {
+    CountSource* c = (CountSource*)ctx;
+    size_t m = 0;
+    for (; m < max && c->next < c->n; m++, c->next++) {
+        buf[2*m]   = (double)c->next;
+        buf[2*m+1] = -(double)c->next;
+    }
+    *rows = buf;
+    return m;
+}
+
+static void test_prefetch_order(void) {
+    printf("Test: ChunkPrefetch ordering\n");
+    const int nbufs[] = { 1, 2, 3, 8 };
+    for (int t = 0; t < 4; t++) {
+        CountSource c = { 0, 100003 };
+        ChunkPrefetch* pf = ChunkPrefetchStart(count_read, &c, 1000, 2, nbufs[t]);
+        ASSERT(pf != NULL, "start");
+        if (!pf) continue;
+        const double* x;
+        size_t got, seen = 0;
+        int ok = 1;
+        double sink = 0;
+        while ((got = ChunkPrefetchNext(pf, &x)) > 0) {
+            for (size_t i = 0; i < got; i++) {
+                ok &= (x[2*i] == (double)(seen + i) && x[2*i+1] == -(double)(seen + i));
+                for (int w = 0; w < 20; w++) sink += sqrt(x[2*i] + w);   /* slow consumer */
+            }
+            seen += got;
+        }
+        ASSERT(ok && sink > 0, "rows in order and intact");
+        ASSERT(seen == c.n, "every row delivered once");
+        ASSERT(ChunkPrefetchNext(pf, &x) == 0, "stays at end");
+        double wait = -1;
+        ChunkPrefetchFinish(pf, &wait);
+        ASSERT(wait >= 0, "io_wait reported");
+    }
+
+    /* Finishing early stops the reader cleanly */
+    CountSource c = { 0, 1000000 };
+    ChunkPrefetch* pf = ChunkPrefetchStart(count_read, &c, 100, 2, 3);
+    const double* x;
+    ASSERT(ChunkPrefetchNext(pf, &x) == 100, "first chunk");
+    ChunkPrefetchFinish(pf, NULL);
+    ASSERT(c.next < c.n, "reader stopped before the end");
+}
+
+/* ── Threaded and synchronous reading give bit-identical fits ── */
+static void test_streaming_prefetch_identical(void) {
+    printf("Test: streaming with and without reader thread\n");
+    const char* path = "test_streaming_pf.tmp";
+    FILE* f = fopen(path, "w");
+    srand(7);
+    for (int i = 0; i < 30000; i++)
+        fprintf(f, "%.9f\n", (i % 3 ? 1.0 : 6.0) + randn());
+    fclose(f);
+
+    StreamConfig cfg;
+    memset(&cfg, 0, sizeof(cfg));
+    cfg.family = DIST_GAUSSIAN;
+    cfg.num_components = 2;
+    cfg.chunk_size = 777;
+    cfg.max_passes = 4;
+    MixtureResult ra, rb;
+    cfg.io_buffers = 1;
+    ASSERT(UnmixStreaming(path, &cfg, &ra) == 0, "synchronous rc");
+    cfg.io_buffers = 0;
+    ASSERT(UnmixStreaming(path, &cfg, &rb) == 0, "prefetch rc");
+    ASSERT(ra.loglikelihood == rb.loglikelihood, "identical LL");
+    ASSERT(ra.params[1].p[0] == rb.params[1].p[0], "identical params");
+    ReleaseMixtureResult(&ra);
+    ReleaseMixtureResult(&rb);
+    remove(path);
+}
+
+/* ── Checkpoint/resume: an interrupted fit continues to the same result ── */
+static void test_checkpoint_resume(void) {
+    printf("Test: checkpoint and resume\n");
+    const char* path = "test_streaming_ckpt.tmp";
+    const char* ckpt = "test_streaming_ckpt.ckpt";
+    remove(ckpt);
+
+    /* File format round trip */
+    double w[2] = { 0.25, 0.75 }, prm[4] = { 1, 2, 3, 4 }, st[6] = { 1, 2, 3, 4, 5, 6 };
+    Checkpoint c, r;
+    memset(&c, 0, sizeof(c));
+    c.engine = CKPT_STREAMING;
+    c.family = DIST_GAMMA;
+    c.k = 2; c.nparam = 2; c.nstat = 3;
+    c.pass = 3; c.step = 41; c.rows = 5000; c.offset = 123456789012ULL;
+    c.prev_ll = -1.5; c.pass_ll = -7.25;
+    c.weights = w; c.params = prm; c.stats = st;
+    ASSERT(CheckpointWrite(ckpt, &c) == 0, "write rc");
+    ASSERT(CheckpointRead(ckpt, &r) == 0, "read rc");
+    ASSERT(r.engine == CKPT_STREAMING && r.family == DIST_GAMMA && r.k == 2 &&
+           r.pass == 3 && r.step == 41 && r.offset == 123456789012ULL &&
+           r.pass_ll == -7.25, "header round trip");
+    ASSERT(r.weights[1] == 0.75 && r.params[3] == 4 && r.stats[5] == 6,
+           "payload round trip");
+    CheckpointRelease(&r);
+    write_file(ckpt, "not a checkpoint\n");
+    ASSERT(CheckpointRead(ckpt, &r) == -1, "garbage -> -1");
+    remove(ckpt);
+    ASSERT(CheckpointRead(ckpt, &r) == -3, "missing -> -3");
+
+    FILE* f = fopen(path, "w");
+    srand(47);
+    for (int i = 0; i < 200000; i++)
+        fprintf(f, "%.9f\n", (i % 3 ? 1.0 : 6.0) + randn());
+    fclose(f);
+
+    StreamConfig cfg;
+    memset(&cfg, 0, sizeof(cfg));
+    cfg.family = DIST_GAUSSIAN;
+    cfg.num_components = 2;
+    cfg.chunk_size = 1000;
+    cfg.max_passes = 4;
+    cfg.rtole = 1e-12;
+    MixtureResult ref, res;
+    ASSERT(UnmixStreaming(path, &cfg, &ref) == 0, "uninterrupted rc");
+
+    /* Stop after two passes, then ask for four: same as four straight */
+    cfg.checkpoint_path = ckpt;
+    cfg.max_passes = 2;
+    ASSERT(UnmixStreaming(path, &cfg, &res) == 0, "first half rc");
+    ReleaseMixtureResult(&res);
+    cfg.max_passes = 4;
+    ASSERT(UnmixStreaming(path, &cfg, &res) == 0, "resumed rc");
+    ASSERT(res.loglikelihood == ref.loglikelihood &&
+           res.params[0].p[0] == ref.params[0].p[0] &&
+           res.mixing_weights[1] == ref.mixing_weights[1], "pass-boundary resume exact");
+    ReleaseMixtureResult(&res);
+    remove(ckpt);
+
+    /* Drift mode: the running LL and the re-seed counter are restored too */
+    MixtureResult dref;
+    cfg.checkpoint_path = NULL;
+    cfg.halflife = 20000;
+    cfg.split_merge = 1;
+    ASSERT(UnmixStreaming(path, &cfg, &dref) == 0, "drift uninterrupted rc");
+    cfg.checkpoint_path = ckpt;
+    cfg.max_passes = 2;
+    ASSERT(UnmixStreaming(path, &cfg, &res) == 0, "drift first half rc");
+    ReleaseMixtureResult(&res);
+    cfg.max_passes = 4;
+    ASSERT(UnmixStreaming(path, &cfg, &res) == 0, "drift resumed rc");
+    ASSERT(res.loglikelihood == dref.loglikelihood &&
+           res.params[0].p[0] == dref.params[0].p[0], "drift resume exact");
+    ReleaseMixtureResult(&res);
+    ReleaseMixtureResult(&dref);
+    remove(ckpt);
+    cfg.halflife = 0;
+    cfg.split_merge = 0;
+
+#if defined(__unix__) || defined(__APPLE__)
+    /* Kill a fit mid-pass; resuming from its last checkpoint is exact */
+    cfg.checkpoint_every = 1;
+    fflush(stdout);
+    pid_t pid = fork();
+    if (pid == 0) {
+        MixtureResult cr;
+        _exit(UnmixStreaming(path, &cfg, &cr) == 0 ? 0 : 1);
+    }
+    ASSERT(pid > 0, "fork");
+    if (pid > 0) {
+        for (int i = 0; i < 2000 && access(ckpt, F_OK) != 0; i++) usleep(1000);
+        usleep(20000);
+        kill(pid, SIGKILL);
+        waitpid(pid, NULL, 0);
+        ASSERT(CheckpointRead(ckpt, &r) == 0, "checkpoint survives the kill");
+        CheckpointRelease(&r);
+        ASSERT(UnmixStreaming(path, &cfg, &res) == 0, "resume after kill rc");
+        ASSERT(res.loglikelihood == ref.loglikelihood &&
+               res.params[1].p[1] == ref.params[1].p[1], "mid-pass resume exact");
+        ReleaseMixtureResult(&res);
+    }
+    remove(ckpt);
+    remove("test_streaming_ckpt.ckpt.tmp");
+    cfg.checkpoint_every = 0;
+#endif
+
+    /* A checkpoint of another model is refused, not silently reused */
+    cfg.max_passes = 1;
+    ASSERT(UnmixStreaming(path, &cfg, &res) == 0, "k=2 checkpoint rc");
+    ReleaseMixtureResult(&res);
+    ASSERT(CheckpointRead(ckpt, &r) == 0, "k=2 checkpoint read");
+    double np0 = r.params[DIST_MAX_PARAMS];
+    r.params[DIST_MAX_PARAMS] = DIST_MAX_PARAMS + 1;
+    ASSERT(CheckpointWrite(ckpt, &r) == 0, "corrupted checkpoint write");
+    ASSERT(UnmixStreaming(path, &cfg, &res) == -1, "bad nparams -> -1");
+    r.params[DIST_MAX_PARAMS] = np0;
+    ASSERT(CheckpointWrite(ckpt, &r) == 0, "restored checkpoint write");
+    CheckpointRelease(&r);
+    f = fopen(path, "a");
+    fprintf(f, "1.0\n");
+    fclose(f);
+    ASSERT(UnmixStreaming(path, &cfg, &res) == -1, "changed input -> -1");
+    cfg.num_components = 3;
+    ASSERT(UnmixStreaming(path, &cfg, &res) == -1, "k mismatch -> -1");
+    remove(ckpt);
+    ReleaseMixtureResult(&ref);
+
+    /* Complex streaming: 2 passes + 2 resumed == 4 */
+    f = fopen(path, "w");
+    for (int i = 0; i < 20000; i++)
+        fprintf(f, "%.6f %.6f\n", (i % 2 ? 3.0 : -3.0) + randn(), randn());
+    fclose(f);
+    ComplexStreamConfig cc;
+    memset(&cc, 0, sizeof(cc));
+    cc.num_components = 2;
+    cc.chunk_size = 1500;
+    cc.max_passes = 4;
+    cc.rtole = 1e-12;
+    cc.type = CGAUSS_CIRCULAR;
+    CCircMixtureResult cref, cres;
+    ASSERT(UnmixComplexStreaming(path, &cc, &cref) == 0, "complex rc");
+    cc.checkpoint_path = ckpt;
+    cc.checkpoint_every = 3;
+    cc.max_passes = 2;
+    ASSERT(UnmixComplexStreaming(path, &cc, &cres) == 0, "complex first half rc");
+    ReleaseCCircResult(&cres);
+    cc.max_passes = 4;
+    ASSERT(UnmixComplexStreaming(path, &cc, &cres) == 0, "complex resumed rc");
+    ASSERT(cres.loglikelihood == cref.loglikelihood &&
+           cres.components[0].mu_re == cref.components[0].mu_re, "complex resume exact");
+    ReleaseCCircResult(&cres);
+    f = fopen(path, "a");
+    fprintf(f, "0.5 0.5\n");
+    fclose(f);
+    ASSERT(UnmixComplexStreaming(path, &cc, &cres) == -1, "complex changed input -> -1");
+    ReleaseCCircResult(&cref);
+    remove(ckpt);
+    remove(path);
+
+    /* Online EM: 100 iterations, then resumed to 300 == 300 straight */
+    size_t n = 20000;
+    double* data = (double*)malloc(sizeof(double) * n);
+    for (size_t i = 0; i < n; i++) data[i] = (i % 2 ? 5.0 : 0.0) + randn();
+    MixtureResult oref, ores;
+    ASSERT(UnmixOnline(data, n, DIST_GAUSSIAN, 2, 300, 1e-15, 256, 0, &oref) == 0,
+           "online rc");
+    SetOnlineCheckpoint(ckpt, 50);
+    ASSERT(UnmixOnline(data, n, DIST_GAUSSIAN, 2, 100, 1e-15, 256, 0, &ores) == 0,
+           "online first part rc");
+    ReleaseMixtureResult(&ores);
+    ASSERT(UnmixOnline(data, n, DIST_GAUSSIAN, 2, 300, 1e-15, 256, 0, &ores) == 0,
+           "online resumed rc");
+    ASSERT(ores.loglikelihood == oref.loglikelihood &&
+           ores.params[0].p[0] == oref.params[0].p[0], "online resume exact");
+    ReleaseMixtureResult(&ores);
+    ASSERT(UnmixOnline(data, n / 2, DIST_GAUSSIAN, 2, 300, 1e-15, 256, 0, &ores) == -1,
+           "online checkpoint of other data -> -1");
+    ASSERT(UnmixOnline(data, n, DIST_GAUSSIAN, 2, 300, 1e-15, 128, 0, &ores) == -1,
+           "online checkpoint of another batch size -> -1");
+    data[n / 2] += 1.0;
+    ASSERT(UnmixOnline(data, n, DIST_GAUSSIAN, 2, 300, 1e-15, 256, 0, &ores) == -1,
+           "online checkpoint of same-size other data -> -1");
+    SetOnlineCheckpoint(NULL, 0);
+    remove(ckpt);
+    free(data);
+    ReleaseMixtureResult(&oref);
+}
+
+int main(void) {
+    printf("=== Streaming Tests ===\n\n");
+
+    test_parse_matches_strtod();
+    test_reader_lines();
+    test_reader_blocks();
+    test_streaming_gaussian();
+    test_streaming_gamma_generic();
+    test_streaming_studentt_ecm();
+    test_streaming_short_input();
+    test_streaming_last_pass_ll();
+    test_streaming_online();
+    test_streaming_online_stop();
+    test_streaming_drift();
+    test_binfile_roundtrip();
+    test_streaming_binary_matches_text();
+    test_prefetch_order();
+    test_streaming_prefetch_identical();
+    test_checkpoint_resume();
+
+    printf("\n=== Results: %d passed, %d failed ===\n",
+           tests_passed, tests_failed);
+
+    return tests_failed > 0 ? 1 : 0;
+}
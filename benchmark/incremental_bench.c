@@ -0,0 +1,95 @@
+/*
+ * LL vs wall time: batch EM, online EM and incremental (Neal–Hinton) EM.
+ *
+ * Each engine is run with iteration budgets 1, 2, 4, ... and the final LL
+ * and wall time of every run is printed, giving one (time, LL) point per
+ * budget.  Budgets are passes over the data for the incremental engines
+ * and mini-batch steps ×(n / batch) for online EM, so every column is
+ * comparable in data touched.
+ *
+ * Build (from the repo root, after cmake --build build):
+ *   gcc -O2 -Isrc/lib benchmark/incremental_bench.c build/src/lib/libem.a \
+ *       -lm -fopenmp -o incremental_bench
+ * Usage: incremental_bench [n] [k] [d]
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include <time.h>
+#include "distributions.h"
+#include "multivariate.h"
+
+static double wall_seconds(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + 1e-9 * (double)ts.tv_nsec;
+}
+
+static double randn(unsigned* seed) {
+    double u = ((*seed = *seed * 1664525 + 1013904223) % 100000 + 1) / 100001.0;
+    double v = ((*seed = *seed * 1664525 + 1013904223) % 100000 + 1) / 100001.0;
+    return sqrt(-2.0 * log(u)) * cos(2.0 * 3.14159265358979 * v);
+}
+
+int main(int argc, char* argv[]) {
+    size_t n = argc > 1 ? (size_t)atol(argv[1]) : 500000;
+    int k    = argc > 2 ? atoi(argv[2]) : 5;
+    int d    = argc > 3 ? atoi(argv[3]) : 3;
+    unsigned seed = 2024;
+
+    /* 1-D: k unit-variance Gaussians 2.5 apart (overlapping) */
+    double* x = (double*)malloc(sizeof(double) * n);
+    for (size_t i = 0; i < n; i++) x[i] = 2.5 * (double)(i % k) + randn(&seed);
+
+    printf("1-D Gaussian  n=%zu k=%d\n", n, k);
+    printf("%6s  %10s %16s  %10s %16s  %10s %16s\n", "budget",
+           "batch s", "batch LL", "online s", "online LL", "incr s", "incr LL");
+    for (int it = 1; it <= 64; it *= 2) {
+        MixtureResult r;
+        double t = wall_seconds();
+        UnmixGeneric(x, n, DIST_GAUSSIAN, k, it, 1e-8, 0, &r);
+        double tb = wall_seconds() - t, lb = r.loglikelihood;
+        ReleaseMixtureResult(&r);
+
+        t = wall_seconds();
+        UnmixOnline(x, n, DIST_GAUSSIAN, k, (int)(it * (n / 256)), 1e-12, 256, 0, &r);
+        double to = wall_seconds() - t, lo = r.loglikelihood;
+        ReleaseMixtureResult(&r);
+
+        t = wall_seconds();
+        UnmixIncremental(x, n, DIST_GAUSSIAN, k, it, 1e-8, 0, 0, &r);
+        double ti = wall_seconds() - t, li = r.loglikelihood;
+        ReleaseMixtureResult(&r);
+
+        printf("%6d  %10.3f %16.4f  %10.3f %16.4f  %10.3f %16.4f\n",
+               it, tb, lb, to, lo, ti, li);
+    }
+    free(x);
+
+    /* d-D: k full-covariance clusters on a line, 2.5 apart in dim 0 */
+    size_t nm = n / 4;
+    double* xm = (double*)malloc(sizeof(double) * nm * d);
+    for (size_t i = 0; i < nm; i++)
+        for (int a = 0; a < d; a++)
+            xm[i*d+a] = (a == 0 ? 2.5 * (double)(i % k) : 0.0) + randn(&seed);
+
+    printf("\nMV Gaussian (full)  n=%zu d=%d k=%d\n", nm, d, k);
+    printf("%6s  %10s %16s  %10s %16s\n", "budget",
+           "batch s", "batch LL", "incr s", "incr LL");
+    for (int it = 1; it <= 64; it *= 2) {
+        MVMixtureResult r;
+        double t = wall_seconds();
+        UnmixMVGaussian(xm, nm, d, k, COV_FULL, it, 1e-8, 0, &r);
+        double tb = wall_seconds() - t, lb = r.loglikelihood;
+        ReleaseMVMixtureResult(&r);
+
+        t = wall_seconds();
+        UnmixMVGaussianIncremental(xm, nm, d, k, COV_FULL, it, 1e-8, 0, 0, &r);
+        double ti = wall_seconds() - t, li = r.loglikelihood;
+        ReleaseMVMixtureResult(&r);
+
+        printf("%6d  %10.3f %16.4f  %10.3f %16.4f\n", it, tb, lb, ti, li);
+    }
+    free(xm);
+    return 0;
+}
@@ -0,0 +1,87 @@
+/*
+ * Strong scaling of the multivariate engines: UnmixMVGaussian and
+ * UnmixMVStudentT (full covariance) on fixed data, d ∈ {2, 8, 32, 128},
+ * with 1, 2, 4, ... threads up to the OpenMP default.
+ *
+ * Each cell is the wall time per EM iteration, taken as the difference
+ * between a 6-iteration and a 1-iteration fit so the (serial) seeding is
+ * excluded.  The LL is printed for every thread count: the block
+ * decomposition does not depend on it, so the values must agree exactly.
+ *
+ * Build (from the repo root, after cmake --build build):
+ *   gcc -O2 -fopenmp -Isrc/lib benchmark/mv_scaling_bench.c \
+ *       build/src/lib/libem.a -lm -o mv_scaling_bench
+ * Usage: mv_scaling_bench [n] [k] [max_threads]
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include <time.h>
+#include "distributions.h"
+#include "multivariate.h"
+
+static double wall_seconds(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + 1e-9 * (double)ts.tv_nsec;
+}
+
+static double randn(unsigned* seed) {
+    double u = ((*seed = *seed * 1664525 + 1013904223) % 100000 + 1) / 100001.0;
+    double v = ((*seed = *seed * 1664525 + 1013904223) % 100000 + 1) / 100001.0;
+    return sqrt(-2.0 * log(u)) * cos(2.0 * 3.14159265358979 * v);
+}
+
+/* Seconds for a fit of maxiter iterations (rtole < 0: never converges) */
+static double fit_time(const double* x, size_t n, int d, int k, int student,
+                       int maxiter, double* ll) {
+    double t = wall_seconds();
+    if (student) {
+        MVStudentTResult r;
+        UnmixMVStudentT(x, n, d, k, COV_FULL, maxiter, -1, 0, &r);
+        *ll = r.loglikelihood;
+        ReleaseMVStudentTResult(&r);
+    } else {
+        MVMixtureResult r;
+        UnmixMVGaussian(x, n, d, k, COV_FULL, maxiter, -1, 0, &r);
+        *ll = r.loglikelihood;
+        ReleaseMVMixtureResult(&r);
+    }
+    return wall_seconds() - t;
+}
+
+int main(int argc, char* argv[]) {
+    size_t n = argc > 1 ? (size_t)atol(argv[1]) : 200000;
+    int k    = argc > 2 ? atoi(argv[2]) : 4;
+    int tmax = argc > 3 ? atoi(argv[3]) : GetNumThreads();
+    const int dims[4] = {2, 8, 32, 128};
+
+    printf("n=%zu k=%d, seconds per iteration (speedup vs 1 thread)\n", n, k);
+    for (int di = 0; di < 4; di++) {
+        int d = dims[di];
+        unsigned seed = 77;
+        double* x = (double*)malloc(sizeof(double) * n * d);
+        if (!x) { fprintf(stderr, "out of memory at d=%d\n", d); return 1; }
+        for (size_t i = 0; i < n; i++)
+            for (int a = 0; a < d; a++)
+                x[i*d+a] = 2.5 * (double)(i % k) * (a % 2 ? 1 : -1) + randn(&seed);
+
+        for (int student = 0; student < 2; student++) {
+            double base = 0;
+            for (int t = 1; ; t = 2 * t < tmax ? 2 * t : tmax) {
+                SetNumThreads(t);
+                double ll1, ll6;
+                double t1 = fit_time(x, n, d, k, student, 1, &ll1);
+                double t6 = fit_time(x, n, d, k, student, 6, &ll6);
+                double per = (t6 - t1) / 5;
+                if (t == 1) base = per;
+                printf("%-8s d=%-4d threads=%-3d %9.4f s/iter  (%5.2fx)  LL=%.10g\n",
+                       student ? "MV-T" : "MV-Gauss", d, t, per, base / per, ll6);
+                if (t >= tmax) break;
+            }
+        }
+        free(x);
+    }
+    SetNumThreads(0);
+    return 0;
+}
@@ -0,0 +1,101 @@
+/*
+ * Text input throughput: fgets + atof (the old streaming reader) against
+ * TextReader (mmap / block read + FastParseDouble).
+ *
+ * Writes n values with printf("%.10g") to a temporary file, then times
+ * full passes with each reader and prints MB/s and the value sums (which
+ * must agree).  Run it twice to see warm-cache numbers; drop the page
+ * cache in between for cold-cache ones.
+ *
+ * Build (from the repo root, after cmake --build build):
+ *   gcc -O2 -Isrc/lib benchmark/parse_bench.c build/src/lib/libem.a \
+ *       -lm -fopenmp -o parse_bench
+ * Usage: parse_bench [n] [path]
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include <time.h>
+#include "textio.h"
+
+static double wall_seconds(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + 1e-9 * (double)ts.tv_nsec;
+}
+
+static double randn(unsigned* seed) {
+    double u = ((*seed = *seed * 1664525 + 1013904223) % 100000 + 1) / 100001.0;
+    double v = ((*seed = *seed * 1664525 + 1013904223) % 100000 + 1) / 100001.0;
+    return sqrt(-2.0 * log(u)) * cos(2.0 * 3.14159265358979 * v);
+}
+
+static size_t read_fgets(const char* path, double* sum) {
+    FILE* fp = fopen(path, "r");
+    if (!fp) return 0;
+    char line[256];
+    size_t n = 0;
+    double s = 0;
+    while (fgets(line, sizeof(line), fp)) {
+        if (line[0] == '#' || line[0] == '\n') continue;
+        s += atof(line);
+        n++;
+    }
+    fclose(fp);
+    *sum = s;
+    return n;
+}
+
+static size_t read_textio(const char* path, int flags, double* sum) {
+    TextReader* r = TextReaderOpen(path, flags);
+    if (!r) return 0;
+    double buf[10000];
+    size_t n = 0, got;
+    double s = 0;
+    while ((got = TextReaderRead(r, buf, 10000)) > 0) {
+        for (size_t i = 0; i < got; i++) s += buf[i];
+        n += got;
+    }
+    TextReaderClose(r);
+    *sum = s;
+    return n;
+}
+
+int main(int argc, char* argv[]) {
+    size_t n = argc > 1 ? (size_t)atol(argv[1]) : 10000000;
+    const char* path = argc > 2 ? argv[2] : "parse_bench.tmp";
+    unsigned seed = 2024;
+
+    FILE* f = fopen(path, "w");
+    if (!f) { perror(path); return 1; }
+    fprintf(f, "# parse_bench data\n");
+    for (size_t i = 0; i < n; i++)
+        fprintf(f, "%.10g\n", 3.0 * (double)(i % 4) + randn(&seed));
+    long bytes = ftell(f);
+    fclose(f);
+    double mb = (double)bytes / 1e6;
+    printf("n=%zu  file=%.1f MB\n", n, mb);
+    printf("%-22s %10s %10s %22s\n", "reader", "seconds", "MB/s", "sum");
+
+    for (int rep = 0; rep < 2; rep++) {
+        double s, t;
+        size_t m;
+
+        t = wall_seconds();
+        m = read_fgets(path, &s);
+        t = wall_seconds() - t;
+        printf("%-22s %10.3f %10.1f %22.10f  (n=%zu)\n", "fgets+atof", t, mb / t, s, m);
+
+        t = wall_seconds();
+        m = read_textio(path, 0, &s);
+        t = wall_seconds() - t;
+        printf("%-22s %10.3f %10.1f %22.10f  (n=%zu)\n", "TextReader mmap", t, mb / t, s, m);
+
+        t = wall_seconds();
+        m = read_textio(path, TEXTIO_NO_MMAP, &s);
+        t = wall_seconds() - t;
+        printf("%-22s %10.3f %10.1f %22.10f  (n=%zu)\n", "TextReader read()", t, mb / t, s, m);
+    }
+    remove(path);
+    return 0;
+}
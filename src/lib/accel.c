@@ -0,0 +1,128 @@
+/*
+ * Copyright 2022-2026, Micah Thornton and Chanhee Park
+ * SQUAREM acceleration for the EM engines (see accel.h for the protocol).
+ * License: GPL v3
+ */
+
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "accel.h"
+
+#define ACCEL_STEP_FACTOR 4.0    /* stepmax ×/÷ per clamped accept / reject */
+#define ACCEL_STEP_START  4.0
+#define ACCEL_STEP_LIMIT  1024.0
+
+static int g_accel = 0;
+
+void SetEMAcceleration(int on) { g_accel = on != 0; }
+int  GetEMAcceleration(void) { return g_accel; }
+
+struct EMAccel {
+    size_t  p;
+    double* u[3];       /* consecutive M-step results u₀, u₁, u₂ */
+    int     have;       /* how many of them are held */
+    int     pending;    /* the next E-step evaluates an extrapolation */
+    int     clamped;    /* ... whose α hit −stepmax */
+    double  ll_ref;     /* LL of u₁ */
+    double  stepmax;
+    int     tried, rejected;
+};
+
+EMAccel* EMAccelStart(size_t p) {
+    if (!g_accel || p == 0) return NULL;
+    EMAccel* a = (EMAccel*)calloc(1, sizeof(EMAccel));
+    if (!a) return NULL;
+    a->p = p;
+    a->stepmax = ACCEL_STEP_START;
+    for (int s = 0; s < 3; s++) {
+        a->u[s] = (double*)malloc(sizeof(double) * p);
+        if (!a->u[s]) { EMAccelFinish(a, NULL); return NULL; }
+    }
+    return a;
+}
+
+int EMAccelCheck(EMAccel* a, double ll, double* theta) {
+    if (!a) return 0;
+    if (a->have == 2) a->ll_ref = ll;   /* E-step at u₁ */
+    if (!a->pending) return 0;
+    a->pending = 0;
+    if (ll >= a->ll_ref) {              /* false for NaN */
+        if (a->clamped && a->stepmax < ACCEL_STEP_LIMIT) a->stepmax *= ACCEL_STEP_FACTOR;
+        return 0;
+    }
+    /* Lost likelihood: continue from u₂, which starts the next cycle */
+    a->rejected++;
+    a->stepmax /= ACCEL_STEP_FACTOR;
+    if (a->stepmax < 1.0) a->stepmax = 1.0;
+    memcpy(theta, a->u[2], sizeof(double) * a->p);
+    double* t = a->u[0]; a->u[0] = a->u[2]; a->u[2] = t;
+    a->have = 1;
+    return 1;
+}
+
+int EMAccelUpdate(EMAccel* a, double* theta) {
+    if (!a) return 0;
+    if (a->have < 2) {
+        memcpy(a->u[a->have++], theta, sizeof(double) * a->p);
+        return 0;
+    }
+    const double* u0 = a->u[0];
+    const double* u1 = a->u[1];
+    memcpy(a->u[2], theta, sizeof(double) * a->p);
+    double rr = 0, vv = 0;
+    for (size_t i = 0; i < a->p; i++) {
+        double r = u1[i] - u0[i];
+        double v = theta[i] - 2 * u1[i] + u0[i];
+        rr += r * r;
+        vv += v * v;
+    }
+    a->have = 0;
+    if (!(vv > 0) || !isfinite(rr + vv)) {
+        /* Converged or broken cycle: u₂ as it is starts the next one */
+        double* t = a->u[0]; a->u[0] = a->u[2]; a->u[2] = t;
+        a->have = 1;
+        return 0;
+    }
+    double alpha = -sqrt(rr / vv);
+    a->clamped = alpha <= -a->stepmax;
+    if (a->clamped) alpha = -a->stepmax;
+    if (alpha > -1.0) alpha = -1.0;      /* −1 gives u₂ itself */
+    for (size_t i = 0; i < a->p; i++) {
+        double r = u1[i] - u0[i];
+        double v = a->u[2][i] - 2 * u1[i] + u0[i];
+        theta[i] = u0[i] - 2 * alpha * r + alpha * alpha * v;
+    }
+    a->pending = 1;
+    a->tried++;
+    return 1;
+}
+
+int EMAccelSettle(EMAccel* a, double* theta) {
+    if (!a || !a->pending) return 0;
+    a->pending = 0;
+    memcpy(theta, a->u[2], sizeof(double) * a->p);
+    return 1;
+}
+
+int EMAccelFinish(EMAccel* a, int* rejected) {
+    if (!a) {
+        if (rejected) *rejected = 0;
+        return 0;
+    }
+    int tried = a->tried;
+    if (rejected) *rejected = a->rejected;
+    for (int s = 0; s < 3; s++) free(a->u[s]);
+    free(a);
+    return tried;
+}
+
+void EMAccelProjectWeights(double* w, int k) {
+    double s = 0;
+    for (int j = 0; j < k; j++) {
+        if (!(w[j] > 1e-10)) w[j] = 1e-10;
+        s += w[j];
+    }
+    for (int j = 0; j < k; j++) w[j] /= s;
+}
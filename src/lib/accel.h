@@ -0,0 +1,94 @@
+/*
+ * Copyright 2022-2026, Micah Thornton and Chanhee Park
+ * SQUAREM acceleration for the EM engines: extrapolation on a packed
+ * parameter vector with a monotone safeguard, driven from the engine's
+ * own E-step/M-step loop.
+ * License: GPL v3
+ */
+#ifndef ACCEL_H
+#define ACCEL_H
+
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * Protocol (Varadhan & Roland 2008, scheme SqS3).  The engine packs its
+ * parameters into p doubles in coordinates where every point is feasible
+ * or cheaply projected (weights clipped by EMAccelProjectWeights, SPD
+ * covariances as a Cholesky factor with log diagonal, log variances).
+ * Three consecutive M-step results u₀, u₁, u₂ give r = u₁ − u₀,
+ * v = u₂ − 2u₁ + u₀ and the point
+ *
+ *     θ' = u₀ − 2αr + α²v,   α = −‖r‖/‖v‖ clamped to [−stepmax, −1],
+ *
+ * which replaces u₂: its E-step is the one u₂ would have had, so an
+ * accepted extrapolation costs nothing.  θ' is accepted if its LL is at
+ * least the LL of u₁ (EM cannot do worse from there); otherwise the
+ * engine falls back to u₂ and repeats the E-step.  stepmax grows ×4 when
+ * a clamped step is accepted and shrinks ×4 on a rejection.
+ *
+ *     for (iter ...) {
+ *         ll = E-step
+ *         if (EMAccelCheck(a, ll, th)) { unpack(th); continue; }
+ *         convergence check on ll
+ *         M-step; pack(th)
+ *         if (EMAccelUpdate(a, th)) unpack(th);
+ *     }
+ *     if (EMAccelSettle(a, th)) unpack(th);
+ */
+
+typedef struct EMAccel EMAccel;
+
+/**
+ * Accelerator for p packed parameters.
+ * @return NULL when acceleration is off (SetEMAcceleration) or on
+ *         allocation failure; the engine then runs plain EM
+ */
+EMAccel* EMAccelStart(size_t p);
+
+/**
+ * After the E-step with log-likelihood ll.  If the evaluated point was an
+ * extrapolation that lost likelihood, writes the fallback u₂ to theta and
+ * returns 1: the engine unpacks it and repeats the E-step (the iteration
+ * counts, its ll is not used for the convergence check).
+ */
+int EMAccelCheck(EMAccel* a, double ll, double* theta);
+
+/**
+ * After the M-step, theta holding its packed result.  Every third call
+ * overwrites theta with the extrapolated point and returns 1; the engine
+ * unpacks it (projecting onto the feasible set).
+ */
+int EMAccelUpdate(EMAccel* a, double* theta);
+
+/**
+ * After the loop.  If it ended on an extrapolation whose E-step never ran
+ * (maxiter reached right after EMAccelUpdate returned 1), writes u₂ to
+ * theta and returns 1: the engine unpacks it, so it never returns an
+ * unchecked point.
+ */
+int EMAccelSettle(EMAccel* a, double* theta);
+
+/**
+ * Free the accelerator.
+ * @param rejected  Output (may be NULL): extrapolations that were rejected
+ * @return extrapolations tried
+ */
+int EMAccelFinish(EMAccel* a, int* rejected);
+
+/** Clip k mixing weights to ≥ 1e-10 and renormalize (after extrapolation) */
+void EMAccelProjectWeights(double* w, int k);
+
+/** SQUAREM in the multivariate and complex engines (default off; the CLI
+ *  turns it on with --squarem) */
+void SetEMAcceleration(int on);
+int  GetEMAcceleration(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* ACCEL_H */
@@ -0,0 +1,233 @@
+/*
+ * Copyright 2022-2026, Micah Thornton and Chanhee Park
+ * Native binary data format (see binfile.h for the layout).
+ * License: GPL v3
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+#include "binfile.h"
+
+#if defined(__unix__) || defined(__APPLE__)
+#define BINFILE_POSIX 1
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#endif
+
+static const unsigned char gembin_magic[8] = { 'G','E','M','B','I','N', 0, 1 };
+
+static int host_little_endian(void) {
+    const uint16_t one = 1;
+    return *(const unsigned char*)&one == 1;
+}
+
+static uint64_t get_le(const unsigned char* p, int nbytes) {
+    uint64_t v = 0;
+    for (int i = nbytes - 1; i >= 0; i--) v = (v << 8) | p[i];
+    return v;
+}
+
+static void put_le(unsigned char* p, uint64_t v, int nbytes) {
+    for (int i = 0; i < nbytes; i++) { p[i] = (unsigned char)(v & 0xff); v >>= 8; }
+}
+
+static size_t elem_size(GemBinType t) {
+    return t == GEMBIN_F64 ? 8 : t == GEMBIN_F32 ? 4 : t == GEMBIN_CI16 ? 2 : 0;
+}
+
+static int elems_per_value(GemBinType t) {
+    return t == GEMBIN_CI16 ? 2 : 1;
+}
+
+int GemBinIsFile(const char* path) {
+    if (!path) return 0;
+    FILE* f = fopen(path, "rb");
+    if (!f) return 0;
+    unsigned char m[8];
+    int ok = fread(m, 1, 8, f) == 8 && memcmp(m, gembin_magic, 8) == 0;
+    fclose(f);
+    return ok;
+}
+
+int GemBinOpen(const char* path, GemBin* bin) {
+    if (!path || !bin) return -1;
+    memset(bin, 0, sizeof(*bin));
+
+    size_t len = 0;
+    void* base = NULL;
+#ifdef BINFILE_POSIX
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) return -3;
+    struct stat st;
+    if (fstat(fd, &st) != 0) { close(fd); return -3; }
+    if (st.st_size < GEMBIN_HEADER_SIZE) { close(fd); return -1; }
+    len = (size_t)st.st_size;
+    base = mmap(NULL, len, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (base == MAP_FAILED) return -3;
+#ifdef MADV_SEQUENTIAL
+    madvise(base, len, MADV_SEQUENTIAL);
+#endif
+    bin->mapped = 1;
+#else
+    FILE* f = fopen(path, "rb");
+    if (!f) return -3;
+    fseek(f, 0, SEEK_END);
+    long sz = ftell(f);
+    fseek(f, 0, SEEK_SET);
+    if (sz < GEMBIN_HEADER_SIZE) { fclose(f); return -1; }
+    len = (size_t)sz;
+    base = malloc(len);
+    if (!base || fread(base, 1, len, f) != len) { free(base); fclose(f); return -3; }
+    fclose(f);
+#endif
+    bin->map_base = base;
+    bin->map_len = len;
+
+    const unsigned char* h = (const unsigned char*)base;
+    GemBinType dtype = (GemBinType)get_le(h + 8, 4);
+    uint64_t dim = get_le(h + 12, 4);
+    uint64_t count = get_le(h + 16, 8);
+    size_t es = elem_size(dtype);
+    if (memcmp(h, gembin_magic, 8) != 0 || es == 0 || dim < 1 || dim > 1u << 20) {
+        GemBinClose(bin);
+        return -1;
+    }
+    size_t row_bytes = es * (size_t)elems_per_value(dtype) * (size_t)dim;
+    if (count > (len - GEMBIN_HEADER_SIZE) / row_bytes) {
+        GemBinClose(bin);
+        return -1;
+    }
+    bin->dtype = dtype;
+    bin->dim = (int)dim;
+    bin->width = (int)dim * elems_per_value(dtype);
+    bin->count = (size_t)count;
+    bin->data = h + GEMBIN_HEADER_SIZE;
+    return 0;
+}
+
+void GemBinClose(GemBin* bin) {
+    if (!bin) return;
+    if (bin->map_base) {
+#ifdef BINFILE_POSIX
+        munmap(bin->map_base, bin->map_len);
+#else
+        free(bin->map_base);
+#endif
+    }
+    memset(bin, 0, sizeof(*bin));
+}
+
+const double* GemBinData(const GemBin* bin) {
+    if (!bin || bin->dtype != GEMBIN_F64 || !host_little_endian()) return NULL;
+    return (const double*)bin->data;
+}
+
+const double* GemBinRows(const GemBin* bin, size_t row0, size_t nrows, double* buf) {
+    size_t w = (size_t)bin->width;
+    const double* direct = GemBinData(bin);
+    if (direct) return direct + row0 * w;
+
+    size_t nv = nrows * w;
+    const unsigned char* p = bin->data + row0 * w * elem_size(bin->dtype);
+    int le = host_little_endian();
+    switch (bin->dtype) {
+    case GEMBIN_F64:
+        for (size_t i = 0; i < nv; i++) {
+            uint64_t u = get_le(p + 8 * i, 8);
+            memcpy(&buf[i], &u, 8);
+        }
+        break;
+    case GEMBIN_F32:
+        for (size_t i = 0; i < nv; i++) {
+            float f;
+            if (le) memcpy(&f, p + 4 * i, 4);
+            else { uint32_t u = (uint32_t)get_le(p + 4 * i, 4); memcpy(&f, &u, 4); }
+            buf[i] = (double)f;
+        }
+        break;
+    case GEMBIN_CI16:
+        for (size_t i = 0; i < nv; i++)
+            buf[i] = (double)(int16_t)(uint16_t)get_le(p + 2 * i, 2);
+        break;
+    }
+    return buf;
+}
+
+/* ── Writer ───────────────────────────────────────────────────────── */
+
+struct GemBinWriter {
+    FILE*      fp;
+    GemBinType dtype;
+    int        dim;
+    int        width;
+    uint64_t   count;
+    int        failed;
+};
+
+GemBinWriter* GemBinWriterOpen(const char* path, GemBinType dtype, int dim) {
+    if (!path || elem_size(dtype) == 0 || dim < 1) return NULL;
+    GemBinWriter* w = (GemBinWriter*)calloc(1, sizeof(GemBinWriter));
+    if (!w) return NULL;
+    w->fp = fopen(path, "wb");
+    if (!w->fp) { free(w); return NULL; }
+    w->dtype = dtype;
+    w->dim = dim;
+    w->width = dim * elems_per_value(dtype);
+
+    unsigned char h[GEMBIN_HEADER_SIZE];
+    memset(h, 0, sizeof(h));
+    memcpy(h, gembin_magic, 8);
+    put_le(h + 8, (uint64_t)dtype, 4);
+    put_le(h + 12, (uint64_t)dim, 4);
+    if (fwrite(h, 1, sizeof(h), w->fp) != sizeof(h)) w->failed = 1;
+    return w;
+}
+
+int GemBinWriterAppend(GemBinWriter* w, const double* rows, size_t nrows) {
+    if (!w || (!rows && nrows)) return -1;
+    size_t nv = nrows * (size_t)w->width;
+    size_t es = elem_size(w->dtype);
+    unsigned char tmp[8 * 512];
+    size_t per = sizeof(tmp) / es;
+    for (size_t i0 = 0; i0 < nv && !w->failed; i0 += per) {
+        size_t m = nv - i0 < per ? nv - i0 : per;
+        for (size_t i = 0; i < m; i++) {
+            double v = rows[i0 + i];
+            uint64_t u;
+            if (w->dtype == GEMBIN_F64) {
+                memcpy(&u, &v, 8);
+            } else if (w->dtype == GEMBIN_F32) {
+                float f = (float)v;
+                uint32_t u32;
+                memcpy(&u32, &f, 4);
+                u = u32;
+            } else {
+                double r = isnan(v) ? 0.0 : floor(v + 0.5);
+                if (r > 32767.0) r = 32767.0;
+                if (r < -32768.0) r = -32768.0;
+                u = (uint16_t)(int16_t)r;
+            }
+            put_le(tmp + i * es, u, (int)es);
+        }
+        if (fwrite(tmp, es, m, w->fp) != m) w->failed = 1;
+    }
+    w->count += nrows;
+    return w->failed ? -3 : 0;
+}
+
+int GemBinWriterClose(GemBinWriter* w) {
+    if (!w) return -1;
+    int rc = w->failed ? -3 : 0;
+    unsigned char c[8];
+    put_le(c, w->count, 8);
+    if (fseek(w->fp, 16, SEEK_SET) != 0 || fwrite(c, 1, 8, w->fp) != 8) rc = -3;
+    if (fclose(w->fp) != 0) rc = -3;
+    free(w);
+    return rc;
+}
@@ -0,0 +1,91 @@
+/*
+ * Copyright 2022-2026, Micah Thornton and Chanhee Park
+ * Native binary data format: a 64-byte header followed by raw
+ * little-endian rows, memory-mapped for zero-copy fits.
+ * License: GPL v3
+ */
+#ifndef BINFILE_H
+#define BINFILE_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * Layout (all integers little-endian):
+ *
+ *   offset  size  field
+ *        0     8  magic "GEMBIN\0\1"
+ *        8     4  dtype (GemBinType)
+ *       12     4  dim   values per row (complex values for GEMBIN_CI16)
+ *       16     8  count rows
+ *       24    40  reserved, zero
+ *       64        count × dim values, row-major
+ *
+ * The 64-byte header keeps the payload aligned for any element type.
+ */
+#define GEMBIN_HEADER_SIZE 64
+
+typedef enum {
+    GEMBIN_F64  = 1,   /* double */
+    GEMBIN_F32  = 2,   /* float */
+    GEMBIN_CI16 = 3    /* complex int16: (re, im) pairs, e.g. raw IQ samples */
+} GemBinType;
+
+typedef struct {
+    GemBinType dtype;
+    int        dim;       /* values per row as stored */
+    int        width;     /* doubles per row when decoded (2·dim for CI16) */
+    size_t     count;     /* rows */
+    const unsigned char* data;   /* first row (inside the mapping) */
+    /* private */
+    void*      map_base;
+    size_t     map_len;
+    int        mapped;
+} GemBin;
+
+/** @return 1 if path starts with the GEMBIN magic, 0 otherwise */
+int GemBinIsFile(const char* path);
+
+/**
+ * Map a binary data file read-only.
+ * @return 0 on success, -1 bad header or truncated payload, -3 open/map failure
+ */
+int GemBinOpen(const char* path, GemBin* bin);
+
+void GemBinClose(GemBin* bin);
+
+/**
+ * Rows [row0, row0 + nrows) as doubles, width values per row.  For F64 on
+ * a little-endian host this is a pointer into the mapping and buf is not
+ * touched; otherwise the rows are decoded into buf (nrows × width doubles).
+ */
+const double* GemBinRows(const GemBin* bin, size_t row0, size_t nrows, double* buf);
+
+/** Whole payload as doubles without copying, or NULL if it needs decoding. */
+const double* GemBinData(const GemBin* bin);
+
+/* Incremental writer: rows are appended and the count is patched on close. */
+typedef struct GemBinWriter GemBinWriter;
+
+/** @return writer, or NULL on bad arguments or if the file cannot be created */
+GemBinWriter* GemBinWriterOpen(const char* path, GemBinType dtype, int dim);
+
+/**
+ * Append nrows rows of width doubles each (2·dim for CI16: re, im, ...).
+ * CI16 values are rounded and saturated to int16.
+ * @return 0 on success, -3 on write failure
+ */
+int GemBinWriterAppend(GemBinWriter* w, const double* rows, size_t nrows);
+
+/** Finalize the header and close.  @return 0 on success, -3 on write failure */
+int GemBinWriterClose(GemBinWriter* w);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* BINFILE_H */
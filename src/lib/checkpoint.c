@@ -0,0 +1,187 @@
+/*
+ * Copyright 2022-2026, Micah Thornton and Chanhee Park
+ * Checkpoint files for streaming/online EM (see checkpoint.h for the layout).
+ * License: GPL v3
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+
+#include "checkpoint.h"
+
+static const unsigned char ckpt_magic[8] = { 'G','E','M','C','K','P','T', 4 };
+
+static uint64_t get_le(const unsigned char* p, int nbytes) {
+    uint64_t v = 0;
+    for (int i = nbytes - 1; i >= 0; i--) v = (v << 8) | p[i];
+    return v;
+}
+
+static void put_le(unsigned char* p, uint64_t v, int nbytes) {
+    for (int i = 0; i < nbytes; i++) { p[i] = (unsigned char)(v & 0xff); v >>= 8; }
+}
+
+static double get_f64(const unsigned char* p) {
+    uint64_t u = get_le(p, 8);
+    double v;
+    memcpy(&v, &u, 8);
+    return v;
+}
+
+static void put_f64(unsigned char* p, double v) {
+    uint64_t u;
+    memcpy(&u, &v, 8);
+    put_le(p, u, 8);
+}
+
+static size_t payload_doubles(const Checkpoint* c) {
+    return (size_t)c->k * (size_t)(1 + c->nparam + c->nstat);
+}
+
+int CheckpointWrite(const char* path, const Checkpoint* c) {
+    if (!path || !c || c->k < 1 || c->nparam < 0 || c->nstat < 0 ||
+        !c->weights || (c->nparam && !c->params) || (c->nstat && !c->stats))
+        return -1;
+
+    unsigned char h[CKPT_HEADER_SIZE];
+    memset(h, 0, sizeof(h));
+    memcpy(h, ckpt_magic, 8);
+    put_le(h + 8, (uint64_t)c->engine, 4);
+    put_le(h + 12, (uint64_t)(uint32_t)c->family, 4);
+    put_le(h + 16, (uint64_t)c->k, 4);
+    put_le(h + 20, (uint64_t)c->nparam, 4);
+    put_le(h + 24, (uint64_t)c->nstat, 4);
+    put_le(h + 28, (uint64_t)c->pass, 4);
+    put_le(h + 32, c->step, 8);
+    put_le(h + 40, c->rows, 8);
+    put_le(h + 48, c->offset, 8);
+    put_le(h + 56, c->total_n, 8);
+    put_le(h + 64, c->rng, 8);
+    put_le(h + 72, c->last_n, 8);
+    put_f64(h + 80, c->prev_ll);
+    put_f64(h + 88, c->pass_ll);
+    put_f64(h + 96, c->last_ll);
+    put_le(h + 104, c->pass_n, 8);
+    put_le(h + 112, c->chunks, 8);
+    put_le(h + 120, (uint64_t)(c->converged != 0), 4);
+    put_le(h + 124, (uint64_t)(uint32_t)c->drift_chunks, 4);
+    put_le(h + 128, c->input_size, 8);
+    put_f64(h + 136, c->drift_ll);
+    put_le(h + 144, c->fingerprint, 8);
+
+    size_t k = (size_t)c->k;
+    size_t nd = payload_doubles(c);
+    unsigned char* body = (unsigned char*)malloc(8 * nd);
+    if (!body) return -3;
+    unsigned char* q = body;
+    for (size_t j = 0; j < k; j++, q += 8) put_f64(q, c->weights[j]);
+    for (size_t i = 0; i < k * (size_t)c->nparam; i++, q += 8) put_f64(q, c->params[i]);
+    for (size_t i = 0; i < k * (size_t)c->nstat; i++, q += 8) put_f64(q, c->stats[i]);
+
+    size_t plen = strlen(path);
+    char* tmp = (char*)malloc(plen + 5);
+    if (!tmp) { free(body); return -3; }
+    memcpy(tmp, path, plen);
+    memcpy(tmp + plen, ".tmp", 5);
+
+    int rc = 0;
+    FILE* f = fopen(tmp, "wb");
+    if (!f) rc = -3;
+    else {
+        if (fwrite(h, 1, sizeof(h), f) != sizeof(h) ||
+            fwrite(body, 8, nd, f) != nd) rc = -3;
+        if (fclose(f) != 0) rc = -3;
+    }
+    if (rc == 0 && rename(tmp, path) != 0) {
+        /* rename() does not replace an existing file on every platform */
+        remove(path);
+        if (rename(tmp, path) != 0) rc = -3;
+    }
+    if (rc != 0) remove(tmp);
+    free(tmp);
+    free(body);
+    return rc;
+}
+
+int CheckpointRead(const char* path, Checkpoint* c) {
+    if (!path || !c) return -1;
+    memset(c, 0, sizeof(*c));
+    FILE* f = fopen(path, "rb");
+    if (!f) return -3;
+
+    unsigned char h[CKPT_HEADER_SIZE];
+    if (fread(h, 1, sizeof(h), f) != sizeof(h) || memcmp(h, ckpt_magic, 8) != 0) {
+        fclose(f);
+        return -1;
+    }
+    c->engine  = (CheckpointEngine)get_le(h + 8, 4);
+    c->family  = (int)(uint32_t)get_le(h + 12, 4);
+    c->k       = (int)get_le(h + 16, 4);
+    c->nparam  = (int)get_le(h + 20, 4);
+    c->nstat   = (int)get_le(h + 24, 4);
+    c->pass    = (int)get_le(h + 28, 4);
+    c->step    = get_le(h + 32, 8);
+    c->rows    = get_le(h + 40, 8);
+    c->offset  = get_le(h + 48, 8);
+    c->total_n = get_le(h + 56, 8);
+    c->rng     = get_le(h + 64, 8);
+    c->last_n  = get_le(h + 72, 8);
+    c->prev_ll = get_f64(h + 80);
+    c->pass_ll = get_f64(h + 88);
+    c->last_ll = get_f64(h + 96);
+    c->pass_n  = get_le(h + 104, 8);
+    c->chunks  = get_le(h + 112, 8);
+    c->converged = (int)get_le(h + 120, 4);
+    c->drift_chunks = (int)(uint32_t)get_le(h + 124, 4);
+    c->input_size = get_le(h + 128, 8);
+    c->drift_ll = get_f64(h + 136);
+    c->fingerprint = get_le(h + 144, 8);
+    if (c->k < 1 || c->k > (1 << 20) || c->nparam < 0 || c->nparam > 1024 ||
+        c->nstat < 0 || c->nstat > 1024) {
+        fclose(f);
+        memset(c, 0, sizeof(*c));
+        return -1;
+    }
+
+    size_t k = (size_t)c->k;
+    size_t nd = payload_doubles(c);
+    unsigned char* body = (unsigned char*)malloc(8 * nd);
+    c->weights = (double*)malloc(sizeof(double) * k);
+    c->params = (double*)malloc(sizeof(double) * (k * (size_t)c->nparam + 1));
+    c->stats = (double*)malloc(sizeof(double) * (k * (size_t)c->nstat + 1));
+    if (!body || !c->weights || !c->params || !c->stats) {
+        free(body);
+        fclose(f);
+        CheckpointRelease(c);
+        return -5;
+    }
+    size_t got = fread(body, 8, nd, f);
+    fclose(f);
+    if (got != nd) {
+        free(body);
+        CheckpointRelease(c);
+        return -1;
+    }
+    const unsigned char* q = body;
+    for (size_t j = 0; j < k; j++, q += 8) c->weights[j] = get_f64(q);
+    for (size_t i = 0; i < k * (size_t)c->nparam; i++, q += 8) c->params[i] = get_f64(q);
+    for (size_t i = 0; i < k * (size_t)c->nstat; i++, q += 8) c->stats[i] = get_f64(q);
+    free(body);
+    return 0;
+}
+
+void CheckpointRelease(Checkpoint* c) {
+    if (!c) return;
+    free(c->weights);
+    free(c->params);
+    free(c->stats);
+    memset(c, 0, sizeof(*c));
+}
+
+uint64_t CheckpointInputSize(const char* path) {
+    struct stat st;
+    if (!path || stat(path, &st) != 0 || !S_ISREG(st.st_mode)) return 0;
+    return (uint64_t)st.st_size;
+}
@@ -0,0 +1,110 @@
+/*
+ * Copyright 2022-2026, Micah Thornton and Chanhee Park
+ * Checkpoint files for the streaming and online EM engines: sufficient
+ * statistics, parameters, step counter and input position, so a fit
+ * interrupted by a crash or preemption resumes where it stopped.
+ * License: GPL v3
+ */
+#ifndef CHECKPOINT_H
+#define CHECKPOINT_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * Layout (all fields little-endian, doubles as IEEE-754 bit patterns):
+ *
+ *   offset  size  field
+ *        0     8  magic "GEMCKPT" + format version (4)
+ *        8     4  engine (CheckpointEngine)
+ *       12     4  family (DistFamily, or ComplexGaussType)
+ *       16     4  k
+ *       20     4  nparam   doubles per component in params
+ *       24     4  nstat    doubles per component in stats
+ *       28     4  pass
+ *       32     8  step     global step of the step-size schedule
+ *       40     8  rows     rows consumed in the current pass
+ *       48     8  offset   input position of the next row
+ *       56     8  total_n
+ *       64     8  rng
+ *       72     8  last_n
+ *       80     8  prev_ll
+ *       88     8  pass_ll
+ *       96     8  last_ll
+ *      104     8  pass_n
+ *      112     8  chunks
+ *      120     4  converged
+ *      124     4  drift_chunks
+ *      128     8  input_size  byte length of the input file
+ *      136     8  drift_ll
+ *      144     8  fingerprint
+ *      152        weights[k], params[k × nparam], stats[nstat × k]
+ */
+#define CKPT_HEADER_SIZE 152
+
+typedef enum {
+    CKPT_STREAMING         = 1,   /* UnmixStreaming */
+    CKPT_COMPLEX_STREAMING = 2,   /* UnmixComplexStreaming */
+    CKPT_ONLINE            = 3    /* UnmixOnline */
+} CheckpointEngine;
+
+typedef struct {
+    CheckpointEngine engine;
+    int      family;
+    int      k;
+    int      nparam;
+    int      nstat;
+    int      pass;      /* pass in progress */
+    uint64_t step;      /* step-size schedule position */
+    uint64_t rows;      /* rows consumed in this pass */
+    uint64_t offset;    /* where the next row starts: byte offset for text,
+                         * row index for GEMBIN */
+    uint64_t total_n;   /* rows in the input (so far, during the first pass) */
+    uint64_t rng;       /* sampler state (UnmixOnline) */
+    uint64_t pass_n;    /* rows EM has run on in this pass */
+    uint64_t chunks;    /* chunks EM has run on in this pass */
+    int      converged; /* fit finished: a resumed run only reports it */
+    uint64_t last_n;
+    double   prev_ll;   /* convergence-check state */
+    double   pass_ll;
+    double   last_ll;
+    uint64_t input_size;/* CheckpointInputSize of the input: a resume
+                         * against a different file is refused */
+    int      drift_chunks; /* drift tracking (UnmixStreaming): chunks since */
+    double   drift_ll;     /* the last re-seed, running chunk LL per value */
+    uint64_t fingerprint;  /* hash of the data and sampler settings
+                            * (UnmixOnline): a resume against other data
+                            * is refused */
+    double*  weights;   /* k */
+    double*  params;    /* k × nparam, engine-specific per component */
+    double*  stats;     /* nstat × k: statistic s of component j at s·k + j */
+} Checkpoint;
+
+/**
+ * Write c to path atomically (a temporary file renamed over path), so a
+ * crash during the write leaves the previous checkpoint intact.
+ * @return 0 on success, -1 bad arguments, -3 write failure
+ */
+int CheckpointWrite(const char* path, const Checkpoint* c);
+
+/**
+ * Read a checkpoint; the arrays are allocated (CheckpointRelease frees them).
+ * @return 0 on success, -1 not a checkpoint or truncated, -3 cannot open
+ *         (e.g. no checkpoint yet), -5 allocation failure
+ */
+int CheckpointRead(const char* path, Checkpoint* c);
+
+void CheckpointRelease(Checkpoint* c);
+
+/** Byte length of the file at path, 0 if it is not a regular file */
+uint64_t CheckpointInputSize(const char* path);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* CHECKPOINT_H */
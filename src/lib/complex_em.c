@@ -6,11 +6,20 @@
 
 #include "complex_em.h"
 #include "simd_complex_estep.h"
+#include "distributions.h"
+#include "binfile.h"
+#include "prefetch.h"
+#include "checkpoint.h"
+#include "accel.h"
+#include "walltime.h"
 #include <stdlib.h>
 #include <string.h>
 #include <math.h>
 #include <float.h>
 #include <stdio.h>
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#endif
 
 #ifndef M_PI
 #define M_PI 3.14159265358979323846
@@ -113,7 +122,18 @@ double cnocirc_gauss_pdf(double re, double im, const CNonCircGaussParams* p) {
  * K-means++ initialization for complex data
  * ════════════════════════════════════════════════════════════════════ */
 static void kmeans_init_complex(const double* data, size_t n, int k,
-                                CCircGaussParams* params) {
+                                CCircGaussParams* params, int verbose) {
+    double t_init = WallSeconds();
+    size_t n_full = n;
+
+    /* Very large n: seed on a stratified subsample (EM still sees all n) */
+    double* sample = NULL;
+    size_t m = InitSubsample(data, n, 2, k, &sample);
+    if (m > 0) {
+        data = sample;
+        n = m;
+    }
+
     /* Pick first center uniformly at random */
     size_t c0 = (size_t)(((double)rand()/RAND_MAX) * n);
     if (c0 >= n) c0 = n-1;
@@ -121,22 +141,19 @@ static void kmeans_init_complex(const double* data, size_t n, int k,
     params[0].mu_im = data[2*c0+1];
 
     double* dist2 = (double*)malloc(n * sizeof(double));
-    if (!dist2) return;
+    if (!dist2) { free(sample); return; }
+    for (size_t i = 0; i < n; i++) dist2[i] = DBL_MAX;
 
     for (int j = 1; j < k; j++) {
-        /* Compute D²: min distance to existing centers */
+        /* D²: running min distance to existing centers — only the newest
+         * center (j-1) can lower it, so each round is O(n) not O(n·j) */
         double sum = 0.0;
         for (size_t i = 0; i < n; i++) {
-            double re_i = data[2*i], im_i = data[2*i+1];
-            double mind2 = DBL_MAX;
-            for (int c = 0; c < j; c++) {
-                double dr = re_i - params[c].mu_re;
-                double di = im_i - params[c].mu_im;
-                double d2 = dr*dr + di*di;
-                if (d2 < mind2) mind2 = d2;
-            }
-            dist2[i] = mind2;
-            sum += mind2;
+            double dr = data[2*i]   - params[j-1].mu_re;
+            double di = data[2*i+1] - params[j-1].mu_im;
+            double d2 = dr*dr + di*di;
+            if (d2 < dist2[i]) dist2[i] = d2;
+            sum += dist2[i];
         }
         /* Roulette wheel selection */
         double target = ((double)rand()/RAND_MAX) * sum;
@@ -175,6 +192,13 @@ static void kmeans_init_complex(const double* data, size_t n, int k,
     }
 
     free(dist2);
+    free(sample);
+
+    if (verbose) {
+        printf("  init %.3f s", WallSeconds() - t_init);
+        if (m > 0) printf(" (subsample %zu of %zu)", m, n_full);
+        printf("\n");
+    }
 }
 
 
@@ -182,6 +206,30 @@ static void kmeans_init_complex(const double* data, size_t n, int k,
  * Circular symmetric complex Gaussian mixture EM
  * ════════════════════════════════════════════════════════════════════ */
 
+/* SQUAREM coordinates (accel.h): k weights, then (μ_re, μ_im, log σ²)
+ * per component */
+static void ccirc_accel_pack(const double* w, const CCircGaussParams* c, int k,
+                             double* th) {
+    memcpy(th, w, sizeof(double) * k);
+    for (int j = 0; j < k; j++) {
+        th[k + 3*j]     = c[j].mu_re;
+        th[k + 3*j + 1] = c[j].mu_im;
+        th[k + 3*j + 2] = log(c[j].var);
+    }
+}
+
+static void ccirc_accel_unpack(const double* th, int k, double* w,
+                               CCircGaussParams* c) {
+    memcpy(w, th, sizeof(double) * k);
+    EMAccelProjectWeights(w, k);
+    for (int j = 0; j < k; j++) {
+        c[j].mu_re = th[k + 3*j];
+        c[j].mu_im = th[k + 3*j + 1];
+        c[j].var   = exp(th[k + 3*j + 2]);
+        if (!(c[j].var >= 1e-10)) c[j].var = 1e-10;
+    }
+}
+
 int UnmixComplexCircular(const double* data, size_t n, int k,
                          int maxiter, double rtole, int verbose,
                          CCircMixtureResult* result) {
@@ -202,7 +250,7 @@ int UnmixComplexCircular(const double* data, size_t n, int k,
     }
 
     /* Initialize: k-means++ centers + equal weights */
-    kmeans_init_complex(data, n, k, comps);
+    kmeans_init_complex(data, n, k, comps, verbose);
     for (int j = 0; j < k; j++) weights[j] = 1.0 / k;
 
     /* Temporary arrays for SIMD path */
@@ -219,6 +267,9 @@ int UnmixComplexCircular(const double* data, size_t n, int k,
     double prev_ll = -1e30;
     int iter;
     int use_simd = (n >= SIMD_CIRC_THRESHOLD);
+    EMAccel* acc = EMAccelStart((size_t)4 * k);
+    double* th = acc ? (double*)malloc(sizeof(double) * 4 * k) : NULL;
+    if (acc && !th) { EMAccelFinish(acc, NULL); acc = NULL; }
 
     for (iter = 0; iter < maxiter; iter++) {
 
@@ -257,6 +308,12 @@ int UnmixComplexCircular(const double* data, size_t n, int k,
             }
         }
 
+        if (EMAccelCheck(acc, ll, th)) {
+            /* The extrapolation lost likelihood: E-step again from u₂ */
+            ccirc_accel_unpack(th, k, weights, comps);
+            continue;
+        }
+
         if (verbose && (iter < 5 || iter % 10 == 0 || iter == maxiter-1)) {
             printf("  iter %3d: LL = %.6f\n", iter, ll);
         }
@@ -307,8 +364,18 @@ int UnmixComplexCircular(const double* data, size_t n, int k,
 
             weights[j] = nj / n;
         }
+
+        if (acc) {
+            ccirc_accel_pack(weights, comps, k, th);
+            if (EMAccelUpdate(acc, th)) ccirc_accel_unpack(th, k, weights, comps);
+        }
     }
+    if (EMAccelSettle(acc, th)) ccirc_accel_unpack(th, k, weights, comps);
 
+    int rejected, tried = EMAccelFinish(acc, &rejected);
+    if (verbose && tried)
+        printf("  SQUAREM: %d extrapolations, %d rejected\n", tried, rejected);
+    free(th);
     free(log_w_tmp); free(mu_re_tmp); free(mu_im_tmp); free(var_tmp);
 
     /* Compute final log-likelihood */
@@ -393,6 +460,49 @@ void ReleaseCCircResult(CCircMixtureResult* result) {
  * Non-circular complex Gaussian mixture EM
  * ════════════════════════════════════════════════════════════════════ */
 
+/* Pseudo-covariance shrink that keeps det(Γ) > 0: Σ² > |C|² */
+static void cnoncirc_project(CNonCircGaussParams* c) {
+    double pc_abs2 = c->pcov_re*c->pcov_re + c->pcov_im*c->pcov_im;
+    if (pc_abs2 >= c->cov_re * c->cov_re * 0.99) {
+        double scale = 0.95 * c->cov_re / sqrt(pc_abs2 + 1e-30);
+        c->pcov_re *= scale;
+        c->pcov_im *= scale;
+    }
+}
+
+/* SQUAREM coordinates (accel.h): k weights, then per component
+ * (μ_re, μ_im, log Σ, C_re/Σ, C_im/Σ); the ratio is projected into the
+ * disc cnoncirc_project allows */
+static void cnoncirc_accel_pack(const double* w, const CNonCircGaussParams* c,
+                                int k, double* th) {
+    memcpy(th, w, sizeof(double) * k);
+    for (int j = 0; j < k; j++) {
+        double* t = th + k + 5*j;
+        t[0] = c[j].mu_re;
+        t[1] = c[j].mu_im;
+        t[2] = log(c[j].cov_re);
+        t[3] = c[j].pcov_re / c[j].cov_re;
+        t[4] = c[j].pcov_im / c[j].cov_re;
+    }
+}
+
+static void cnoncirc_accel_unpack(const double* th, int k, double* w,
+                                  CNonCircGaussParams* c) {
+    memcpy(w, th, sizeof(double) * k);
+    EMAccelProjectWeights(w, k);
+    for (int j = 0; j < k; j++) {
+        const double* t = th + k + 5*j;
+        c[j].mu_re = t[0];
+        c[j].mu_im = t[1];
+        c[j].cov_re = exp(t[2]);
+        if (!(c[j].cov_re >= 1e-10)) c[j].cov_re = 1e-10;
+        c[j].cov_im = 0.0;
+        c[j].pcov_re = t[3] * c[j].cov_re;
+        c[j].pcov_im = t[4] * c[j].cov_re;
+        cnoncirc_project(&c[j]);
+    }
+}
+
 int UnmixComplexNonCircular(const double* data, size_t n, int k,
                             int maxiter, double rtole, int verbose,
                             CNonCircMixtureResult* result) {
@@ -413,7 +523,7 @@ int UnmixComplexNonCircular(const double* data, size_t n, int k,
     {
         CCircGaussParams* circ = (CCircGaussParams*)calloc(k, sizeof(CCircGaussParams));
         if (circ) {
-            kmeans_init_complex(data, n, k, circ);
+            kmeans_init_complex(data, n, k, circ, verbose);
             for (int j = 0; j < k; j++) {
                 comps[j].mu_re = circ[j].mu_re;
                 comps[j].mu_im = circ[j].mu_im;
@@ -429,6 +539,9 @@ int UnmixComplexNonCircular(const double* data, size_t n, int k,
 
     double prev_ll = -1e30;
     int iter;
+    EMAccel* acc = EMAccelStart((size_t)6 * k);
+    double* th = acc ? (double*)malloc(sizeof(double) * 6 * k) : NULL;
+    if (acc && !th) { EMAccelFinish(acc, NULL); acc = NULL; }
 
     for (iter = 0; iter < maxiter; iter++) {
 
@@ -451,6 +564,11 @@ int UnmixComplexNonCircular(const double* data, size_t n, int k,
             ll += max_logp + log(sum_exp);
         }
 
+        if (EMAccelCheck(acc, ll, th)) {
+            cnoncirc_accel_unpack(th, k, weights, comps);
+            continue;
+        }
+
         if (verbose && (iter < 5 || iter % 10 == 0))
             printf("  iter %3d: LL = %.6f\n", iter, ll);
 
@@ -508,20 +626,23 @@ int UnmixComplexNonCircular(const double* data, size_t n, int k,
             comps[j].pcov_re = sum_pc_re / nj;
             comps[j].pcov_im = sum_pc_im / nj;
 
-            /* Ensure det(Γ) > 0: Σ² > |C|² */
-            double pc_abs2 = comps[j].pcov_re*comps[j].pcov_re +
-                             comps[j].pcov_im*comps[j].pcov_im;
-            if (pc_abs2 >= comps[j].cov_re * comps[j].cov_re * 0.99) {
-                /* Shrink pseudo-covariance to maintain positive definiteness */
-                double scale = 0.95 * comps[j].cov_re / sqrt(pc_abs2 + 1e-30);
-                comps[j].pcov_re *= scale;
-                comps[j].pcov_im *= scale;
-            }
+            /* Ensure det(Γ) > 0: shrink the pseudo-covariance */
+            cnoncirc_project(&comps[j]);
 
             if (comps[j].cov_re < 1e-10) comps[j].cov_re = 1e-10;
             weights[j] = nj / n;
         }
+
+        if (acc) {
+            cnoncirc_accel_pack(weights, comps, k, th);
+            if (EMAccelUpdate(acc, th)) cnoncirc_accel_unpack(th, k, weights, comps);
+        }
     }
+    if (EMAccelSettle(acc, th)) cnoncirc_accel_unpack(th, k, weights, comps);
+    int rejected, tried = EMAccelFinish(acc, &rejected);
+    if (verbose && tried)
+        printf("  SQUAREM: %d extrapolations, %d rejected\n", tried, rejected);
+    free(th);
 
     /* Final log-likelihood */
     double final_ll = 0.0;
@@ -704,32 +825,42 @@ static int update_mv_complex_cholesky(MVComplexGaussParams* p) {
 /* ── K-means++ init for multivariate complex data ─────────────────── */
 static void kmeans_init_mv_complex(const double* data, size_t n, int d, int k,
                                    MVComplexGaussParams* params,
-                                   double* mixing_weights) {
+                                   double* mixing_weights, int verbose) {
     int d2 = 2 * d;
+    double t_init = WallSeconds();
+    size_t n_full = n;
+
+    /* Very large n: seed on a stratified subsample (EM still sees all n) */
+    double* sample = NULL;
+    size_t m = InitSubsample(data, n, d2, k, &sample);
+    if (m > 0) {
+        data = sample;
+        n = m;
+    }
+
     /* Choose first center uniformly */
     size_t c0 = (size_t)(((double)rand() / RAND_MAX) * n);
     if (c0 >= n) c0 = n - 1;
     memcpy(params[0].mean, data + c0 * d2, d2 * sizeof(double));
 
     double* dist2 = (double*)malloc(n * sizeof(double));
-    if (!dist2) return;
+    if (!dist2) { free(sample); return; }
+    for (size_t i = 0; i < n; i++) dist2[i] = DBL_MAX;
 
     for (int jj = 1; jj < k; jj++) {
+        /* Running D²: fold in the distance to the newest center only */
         double sum = 0.0;
+        const double* prev = params[jj-1].mean;
         for (size_t i = 0; i < n; i++) {
             const double* zi = data + i * d2;
-            double mind2 = DBL_MAX;
-            for (int c = 0; c < jj; c++) {
-                double d2c = 0.0;
-                for (int dd = 0; dd < d; dd++) {
-                    double dr = zi[2*dd]   - params[c].mean[2*dd];
-                    double di = zi[2*dd+1] - params[c].mean[2*dd+1];
-                    d2c += dr*dr + di*di;
-                }
-                if (d2c < mind2) mind2 = d2c;
+            double d2c = 0.0;
+            for (int dd = 0; dd < d; dd++) {
+                double dr = zi[2*dd]   - prev[2*dd];
+                double di = zi[2*dd+1] - prev[2*dd+1];
+                d2c += dr*dr + di*di;
             }
-            dist2[i] = mind2;
-            sum += mind2;
+            if (d2c < dist2[i]) dist2[i] = d2c;
+            sum += dist2[i];
         }
         double target = ((double)rand() / RAND_MAX) * sum;
         double cumul = 0.0;
@@ -776,6 +907,85 @@ static void kmeans_init_mv_complex(const double* data, size_t n, int d, int k,
     }
     free(total_d2);
     free(counts);
+    free(sample);
+
+    if (verbose) {
+        printf("  init %.3f s", WallSeconds() - t_init);
+        if (m > 0) printf(" (subsample %zu of %zu)", m, n_full);
+        printf("\n");
+    }
+}
+
+/* ── SQUAREM coordinates (accel.h) ──────────────────────────────────
+ * k weights, then per component the mean (2d) and the lower triangle of
+ * L with log diagonal (d²): every extrapolated L gives a Hermitian PD Σ. */
+static size_t mv_complex_accel_len(int d, int k) {
+    return (size_t)k * (1 + 2 * (size_t)d + (size_t)d * d);
+}
+
+static void mv_complex_accel_pack(const double* w, const MVComplexGaussParams* c,
+                                  int k, double* th) {
+    memcpy(th, w, sizeof(double) * k);
+    th += k;
+    for (int jj = 0; jj < k; jj++) {
+        int d = c[jj].dim;
+        const double* L = c[jj].cov_chol;
+        memcpy(th, c[jj].mean, sizeof(double) * 2 * d);
+        th += 2 * d;
+        for (int a = 0; a < d; a++) {
+            for (int b = 0; b < a; b++) {
+                *th++ = L[2*(a*d+b)];
+                *th++ = L[2*(a*d+b)+1];
+            }
+            *th++ = log(L[2*(a*d+a)]);
+        }
+    }
+}
+
+/* Σ = L Lᴴ less the regularisation update_mv_complex_cholesky adds back */
+static void mv_complex_accel_unpack(const double* th, int k, double* w,
+                                    MVComplexGaussParams* c) {
+    memcpy(w, th, sizeof(double) * k);
+    EMAccelProjectWeights(w, k);
+    th += k;
+    for (int jj = 0; jj < k; jj++) {
+        int d = c[jj].dim;
+        double* L = c[jj].cov_chol;
+        double* cov = c[jj].cov;
+        memcpy(c[jj].mean, th, sizeof(double) * 2 * d);
+        th += 2 * d;
+        for (int a = 0; a < d; a++) {
+            for (int b = 0; b < a; b++) {
+                L[2*(a*d+b)]   = *th++;
+                L[2*(a*d+b)+1] = *th++;
+            }
+            L[2*(a*d+a)]   = exp(*th++);
+            L[2*(a*d+a)+1] = 0.0;
+        }
+        for (int a = 0; a < d; a++) {
+            for (int b = 0; b <= a; b++) {
+                /* Σ[a,b] = Σ_c L[a,c] conj(L[b,c]) */
+                double vr = 0.0, vi = 0.0;
+                for (int e = 0; e <= b; e++) {
+                    double ar = L[2*(a*d+e)], ai = L[2*(a*d+e)+1];
+                    double br = L[2*(b*d+e)], bi = L[2*(b*d+e)+1];
+                    vr += ar*br + ai*bi;
+                    vi += ai*br - ar*bi;
+                }
+                cov[2*(a*d+b)]   = vr;
+                cov[2*(a*d+b)+1] = vi;
+                cov[2*(b*d+a)]   = vr;
+                cov[2*(b*d+a)+1] = -vi;
+            }
+            cov[2*(a*d+a)] -= MVC_COV_REG;
+            cov[2*(a*d+a)+1] = 0.0;
+        }
+        if (update_mv_complex_cholesky(&c[jj]) != 0) {
+            memset(cov, 0, 2*d*d*sizeof(double));
+            for (int dd = 0; dd < d; dd++) cov[2*(dd*d+dd)] = 1.0;
+            update_mv_complex_cholesky(&c[jj]);
+        }
+    }
 }
 
 /* ── Public API ───────────────────────────────────────────────────── */
@@ -801,11 +1011,15 @@ int UnmixMVComplex(const double* data, size_t n, int d, int k,
     }
 
     /* Initialise */
-    kmeans_init_mv_complex(data, n, d, k, comps, weights);
+    kmeans_init_mv_complex(data, n, d, k, comps, weights, verbose);
 
     double prev_ll = -1e30;
     int iter;
     int d2 = 2 * d;
+    size_t th_len = mv_complex_accel_len(d, k);
+    EMAccel* acc = EMAccelStart(th_len);
+    double* th = acc ? (double*)malloc(sizeof(double) * th_len) : NULL;
+    if (acc && !th) { EMAccelFinish(acc, NULL); acc = NULL; }
 
     for (iter = 0; iter < maxiter; iter++) {
 
@@ -828,6 +1042,11 @@ int UnmixMVComplex(const double* data, size_t n, int d, int k,
             ll += max_logp + log(sum_exp);
         }
 
+        if (EMAccelCheck(acc, ll, th)) {
+            mv_complex_accel_unpack(th, k, weights, comps);
+            continue;
+        }
+
         if (verbose && (iter < 5 || iter % 10 == 0 || iter == maxiter-1))
             printf("  iter %3d: LL = %.6f\n", iter, ll);
 
@@ -902,7 +1121,17 @@ int UnmixMVComplex(const double* data, size_t n, int d, int k,
         double wsum = 0.0;
         for (int jj = 0; jj < k; jj++) wsum += weights[jj];
         if (wsum > 0) for (int jj = 0; jj < k; jj++) weights[jj] /= wsum;
+
+        if (acc) {
+            mv_complex_accel_pack(weights, comps, k, th);
+            if (EMAccelUpdate(acc, th)) mv_complex_accel_unpack(th, k, weights, comps);
+        }
     }
+    if (EMAccelSettle(acc, th)) mv_complex_accel_unpack(th, k, weights, comps);
+    int rejected, tried = EMAccelFinish(acc, &rejected);
+    if (verbose && tried)
+        printf("  SQUAREM: %d extrapolations, %d rejected\n", tried, rejected);
+    free(th);
 
     /* Final log-likelihood */
     double final_ll = 0.0;
@@ -963,6 +1192,127 @@ void ReleaseMVComplexResult(MVComplexMixtureResult* result) {
  * Step-size schedule: γₜ = (t + 2)^(-eta_decay)
  * ════════════════════════════════════════════════════════════════════ */
 
+/* Input: "re im" / "re,im" text lines, or a GEMBIN file with two values
+ * per row (CI16 dim 1, or F64/F32 dim 2) read straight out of the mapping */
+#define CSTREAM_OFFSET_RING 16   /* > PREFETCH_MAX_BUFFERS + 1 chunks in flight */
+
+typedef struct {
+    FILE*  fp;
+    GemBin bin;
+    size_t pos;
+    /* Where each chunk ends (byte offset for text, row for GEMBIN), for
+     * checkpoints: chunk c of the pass at chunk_end[c % CSTREAM_OFFSET_RING] */
+    size_t chunk_end[CSTREAM_OFFSET_RING];
+    size_t produced;
+} CStreamSource;
+
+static int cstream_open(CStreamSource* src, const char* filename) {
+    memset(src, 0, sizeof(*src));
+    if (GemBinIsFile(filename)) {
+        int rc = GemBinOpen(filename, &src->bin);
+        if (rc != 0) return rc;
+        if (src->bin.width != 2) { GemBinClose(&src->bin); return -1; }
+        return 0;
+    }
+    src->fp = fopen(filename, "r");
+    if (!src->fp) return -3;
+#if defined(POSIX_FADV_SEQUENTIAL) && !defined(__APPLE__)
+    posix_fadvise(fileno(src->fp), 0, 0, POSIX_FADV_SEQUENTIAL);
+#endif
+    return 0;
+}
+
+/* Next chunk of up to max (re, im) pairs; *z points at them.
+ * Runs on the prefetch thread (ChunkReadFn). */
+static size_t cstream_next(void* ctx, double* buf, size_t max, const double** z) {
+    CStreamSource* src = (CStreamSource*)ctx;
+    if (!src->fp) {
+        size_t n = src->bin.count - src->pos;
+        if (n > max) n = max;
+        *z = GemBinRows(&src->bin, src->pos, n, buf);
+        src->pos += n;
+        src->chunk_end[src->produced++ % CSTREAM_OFFSET_RING] = src->pos;
+        return n;
+    }
+    char line[256];
+    size_t n = 0;
+    while (n < max && fgets(line, sizeof(line), src->fp)) {
+        if (line[0] == '#' || line[0] == '\n') continue;
+        double re = 0, im = 0;
+        /* Accept "re im" or "re,im" */
+        char* comma = strchr(line, ',');
+        if (comma) { *comma = ' '; }
+        if (sscanf(line, "%lf %lf", &re, &im) != 2) continue;
+        buf[2*n]   = re;
+        buf[2*n+1] = im;
+        n++;
+    }
+    *z = buf;
+    src->chunk_end[src->produced++ % CSTREAM_OFFSET_RING] = (size_t)ftell(src->fp);
+    return n;
+}
+
+static void cstream_rewind(CStreamSource* src) {
+    if (src->fp) rewind(src->fp);
+    src->pos = 0;
+    src->produced = 0;
+}
+
+/* Continue from a position recorded in chunk_end */
+static int cstream_seek(CStreamSource* src, size_t off) {
+    src->produced = 0;
+    if (src->fp) return fseek(src->fp, (long)off, SEEK_SET) == 0 ? 0 : -1;
+    if (off > src->bin.count) return -1;
+    src->pos = off;
+    return 0;
+}
+
+/* Checkpoint of the streaming state: params (mu_re, mu_im, var) and the
+ * stats s0, s1_re, s1_im, s2 per component.  The caller fills the
+ * position fields of ck; input_size identifies the input file.  A failed
+ * write is reported and the fit goes on. */
+static void cstream_save(const char* path, Checkpoint* ck, int k, int type,
+                         int step, uint64_t input_size,
+                         const CCircMixtureResult* result,
+                         const double* s0, const double* s1_re,
+                         const double* s1_im, const double* s2)
+{
+    double* buf = (double*)malloc(sizeof(double) * 7 * (size_t)k);
+    int rc = -5;
+    if (buf) {
+        double* par = buf;
+        double* st = buf + 3 * k;
+        for (int jj = 0; jj < k; jj++) {
+            par[3*jj]     = result->components[jj].mu_re;
+            par[3*jj + 1] = result->components[jj].mu_im;
+            par[3*jj + 2] = result->components[jj].var;
+            st[jj]         = s0[jj];
+            st[k + jj]     = s1_re[jj];
+            st[2*k + jj]   = s1_im[jj];
+            st[3*k + jj]   = s2[jj];
+        }
+        ck->engine  = CKPT_COMPLEX_STREAMING;
+        ck->family  = type;
+        ck->k       = k;
+        ck->nparam  = 3;
+        ck->nstat   = 4;
+        ck->step    = (uint64_t)step;
+        ck->input_size = input_size;
+        ck->weights = result->mixing_weights;
+        ck->params  = par;
+        ck->stats   = st;
+        rc = CheckpointWrite(path, ck);
+        free(buf);
+    }
+    if (rc != 0)
+        fprintf(stderr, "  [stream] checkpoint write to %s failed (rc=%d)\n", path, rc);
+}
+
+static void cstream_close(CStreamSource* src) {
+    if (src->fp) fclose(src->fp);
+    else GemBinClose(&src->bin);
+}
+
 int UnmixComplexStreaming(const char* filename,
                           const ComplexStreamConfig* config,
                           CCircMixtureResult* result) {
@@ -978,43 +1328,77 @@ int UnmixComplexStreaming(const char* filename,
 
     memset(result, 0, sizeof(*result));
 
-    /* ── Pass 0: count lines and collect global stats for init ────── */
-    FILE* fp = fopen(filename, "r");
-    if (!fp) return -3;
+    CStreamSource src;
+    int src_rc = cstream_open(&src, filename);
+    if (src_rc != 0) return src_rc;
+
+    /* Resume: a checkpoint replaces the scan and the initialization and
+     * says where in which pass to continue */
+    const char* ckpath = config->checkpoint_path;
+    uint64_t input_size = CheckpointInputSize(filename);
+    Checkpoint ck;
+    int resumed = 0;
+    memset(&ck, 0, sizeof(ck));
+    if (ckpath && (src_rc = CheckpointRead(ckpath, &ck)) != -3) {
+        if (src_rc == 0 && (ck.engine != CKPT_COMPLEX_STREAMING || ck.family != (int)config->type ||
+                            ck.k != k || ck.nparam != 3 || ck.nstat != 4 ||
+                            ck.input_size != input_size))
+            src_rc = -1;
+        if (src_rc != 0) {
+            CheckpointRelease(&ck);
+            cstream_close(&src);
+            return src_rc;
+        }
+        resumed = 1;
+    }
+
+    /* Each pass reads through a prefetcher (reader thread + buffer ring) */
+    int nbuf = config->io_buffers;
+    double io_wait = 0, t_pass = 0;
+    ChunkPrefetch* pf = NULL;
+    const double* z;
+    size_t got;
+    size_t total_n = (size_t)ck.total_n;
 
-    size_t total_n = 0;
+    /* ── Pass 0: count lines and collect global stats for init ────── */
     double g_sum_re = 0, g_sum_im = 0;
     double g_sum2 = 0;
     double g_min_re = 1e30, g_max_re = -1e30;
     double g_min_im = 1e30, g_max_im = -1e30;
-    char line[256];
-    while (fgets(line, sizeof(line), fp)) {
-        if (line[0] == '#' || line[0] == '\n') continue;
-        double re = 0, im = 0;
-        /* Accept "re im" or "re,im" */
-        char* comma = strchr(line, ',');
-        if (comma) { *comma = ' '; }
-        if (sscanf(line, "%lf %lf", &re, &im) != 2) continue;
-        g_sum_re += re; g_sum_im += im;
-        g_sum2 += re*re + im*im;
-        if (re < g_min_re) g_min_re = re;
-        if (re > g_max_re) g_max_re = re;
-        if (im < g_min_im) g_min_im = im;
-        if (im > g_max_im) g_max_im = im;
-        total_n++;
+    if (!resumed) {
+        t_pass = WallSeconds();
+        pf = ChunkPrefetchStart(cstream_next, &src, (size_t)chunk_size, 2, nbuf);
+        if (!pf) goto stream_oom;
+        while ((got = ChunkPrefetchNext(pf, &z)) > 0) {
+            for (size_t i = 0; i < got; i++) {
+                double re = z[2*i], im = z[2*i+1];
+                g_sum_re += re; g_sum_im += im;
+                g_sum2 += re*re + im*im;
+                if (re < g_min_re) g_min_re = re;
+                if (re > g_max_re) g_max_re = re;
+                if (im < g_min_im) g_min_im = im;
+                if (im > g_max_im) g_max_im = im;
+            }
+            total_n += got;
+        }
+        ChunkPrefetchFinish(pf, &io_wait);
+        pf = NULL;
+        t_pass = WallSeconds() - t_pass;
     }
-    fclose(fp);
 
-    if (total_n == 0) return -4;
+    if (total_n == 0) { CheckpointRelease(&ck); cstream_close(&src); return -4; }
 
     double g_mean_re = g_sum_re / total_n;
     double g_mean_im = g_sum_im / total_n;
     double g_var = g_sum2 / total_n - (g_mean_re*g_mean_re + g_mean_im*g_mean_im);
     if (g_var < 1e-10) g_var = 1.0;
 
-    if (config->verbose)
+    if (config->verbose && !resumed) {
         printf("  [stream] n=%zu  mean=(%.4f,%.4f)  var=%.4f\n",
                total_n, g_mean_re, g_mean_im, g_var);
+        printf("  [stream] scan: io_wait=%.3fs  compute=%.3fs\n",
+               io_wait, t_pass - io_wait);
+    }
 
     /* ── Allocate result ─────────────────────────────────────────── */
     result->num_components = k;
@@ -1040,11 +1424,10 @@ int UnmixComplexStreaming(const char* filename,
     double* s1_re  = (double*)calloc(k, sizeof(double));
     double* s1_im  = (double*)calloc(k, sizeof(double));
     double* s2     = (double*)calloc(k, sizeof(double));
-    double* chunk  = (double*)malloc(2 * chunk_size * sizeof(double));
     double* c_resp = (double*)malloc((size_t)k * chunk_size * sizeof(double));
-    if (!s0 || !s1_re || !s1_im || !s2 || !chunk || !c_resp) {
+    if (!s0 || !s1_re || !s1_im || !s2 || !c_resp) {
         free(s0); free(s1_re); free(s1_im); free(s2);
-        free(chunk); free(c_resp);
+        free(c_resp);
         goto stream_oom;
     }
 
@@ -1059,30 +1442,68 @@ int UnmixComplexStreaming(const char* filename,
         s2[jj]    = result->mixing_weights[jj] * (var + mu2);
     }
 
-    double prev_ll  = -1e30;
-    int global_step = 0;
+    /* ...or take everything from the checkpoint */
+    Checkpoint at = ck;          /* position fields */
+    at.weights = at.params = at.stats = NULL;
+    if (resumed) {
+        for (int jj = 0; jj < k; jj++) {
+            result->mixing_weights[jj]   = ck.weights[jj];
+            result->components[jj].mu_re = ck.params[3*jj];
+            result->components[jj].mu_im = ck.params[3*jj + 1];
+            result->components[jj].var   = ck.params[3*jj + 2];
+            s0[jj]    = ck.stats[jj];
+            s1_re[jj] = ck.stats[k + jj];
+            s1_im[jj] = ck.stats[2*k + jj];
+            s2[jj]    = ck.stats[3*k + jj];
+        }
+        if (config->verbose)
+            printf("  [stream] resumed from %s: pass %d, row %llu, step %llu\n",
+                   ckpath, at.pass + 1, (unsigned long long)at.rows,
+                   (unsigned long long)at.step);
+    }
+    CheckpointRelease(&ck);
 
-    for (int pass = 0; pass < max_passes; pass++) {
-        fp = fopen(filename, "r");
-        if (!fp) break;
+    double prev_ll  = resumed ? at.prev_ll : -1e30;
+    double last_ll  = at.last_ll;
+    size_t last_n   = (size_t)at.last_n;
+    int global_step = (int)at.step;
+    int start_pass  = at.converged ? max_passes : at.pass;
 
+    for (int pass = start_pass; pass < max_passes; pass++) {
         double pass_ll = 0.0;
-        size_t pass_n  = 0;
+        size_t pass_n  = 0, rows = 0, nchunk = 0, chunk_idx = 0;
+
+        cstream_rewind(&src);
+        if (pass == start_pass && at.rows > 0) {
+            if (cstream_seek(&src, (size_t)at.offset) != 0) {
+                /* The recorded position is not in this input */
+                free(s0); free(s1_re); free(s1_im); free(s2);
+                free(c_resp);
+                cstream_close(&src);
+                free(result->mixing_weights); result->mixing_weights = NULL;
+                free(result->components);     result->components     = NULL;
+                return -1;
+            }
+            pass_ll = at.pass_ll;
+            pass_n  = (size_t)at.pass_n;
+            rows    = (size_t)at.rows;
+            chunk_idx = (size_t)at.chunks;
+        }
+        t_pass = WallSeconds();
+        pf = ChunkPrefetchStart(cstream_next, &src, (size_t)chunk_size, 2, nbuf);
+        if (!pf) {
+            free(s0); free(s1_re); free(s1_im); free(s2);
+            free(c_resp);
+            goto stream_oom;
+        }
 
         while (1) {
             /* Read a chunk */
-            int n_read = 0;
-            while (n_read < chunk_size && fgets(line, sizeof(line), fp)) {
-                if (line[0] == '#' || line[0] == '\n') continue;
-                double re = 0, im = 0;
-                char* comma = strchr(line, ',');
-                if (comma) { *comma = ' '; }
-                if (sscanf(line, "%lf %lf", &re, &im) != 2) continue;
-                chunk[2*n_read]   = re;
-                chunk[2*n_read+1] = im;
-                n_read++;
-            }
+            int n_read = (int)ChunkPrefetchNext(pf, &z);
             if (n_read == 0) break;
+            rows += (size_t)n_read;
+            nchunk++;
+            chunk_idx++;
 
             double eta = pow((double)(global_step + 2), -decay);
             global_step++;
@@ -1090,7 +1511,7 @@ int UnmixComplexStreaming(const char* filename,
             /* ── E-step on chunk ── */
             double chunk_ll = 0.0;
             for (int i = 0; i < n_read; i++) {
-                double re_i = chunk[2*i], im_i = chunk[2*i+1];
+                double re_i = z[2*i], im_i = z[2*i+1];
                 double max_logp = -1e30;
                 for (int jj = 0; jj < k; jj++) {
                     double lp = log(result->mixing_weights[jj])
@@ -1114,7 +1535,7 @@ int UnmixComplexStreaming(const char* filename,
                 double nw = 0, nwx_re = 0, nwx_im = 0, nwxx = 0;
                 for (int i = 0; i < n_read; i++) {
                     double r  = c_resp[jj * n_read + i];
-                    double re_i = chunk[2*i], im_i = chunk[2*i+1];
+                    double re_i = z[2*i], im_i = z[2*i+1];
                     nw     += r;
                     nwx_re += r * re_i;
                     nwx_im += r * im_i;
@@ -1147,44 +1568,87 @@ int UnmixComplexStreaming(const char* filename,
                 result->components[jj].mu_im = mu_im;
                 result->components[jj].var   = var;
             }
+
+            if (ckpath && config->checkpoint_every > 0 &&
+                chunk_idx % (size_t)config->checkpoint_every == 0) {
+                memset(&ck, 0, sizeof(ck));
+                ck.pass    = pass;
+                ck.rows    = rows;
+                ck.offset  = src.chunk_end[(nchunk - 1) % CSTREAM_OFFSET_RING];
+                ck.total_n = total_n;
+                ck.pass_ll = pass_ll;
+                ck.pass_n  = pass_n;
+                ck.chunks  = chunk_idx;
+                ck.prev_ll = prev_ll;
+                ck.last_ll = last_ll;
+                ck.last_n  = last_n;
+                cstream_save(ckpath, &ck, k, (int)config->type, global_step,
+                             input_size, result, s0, s1_re, s1_im, s2);
+            }
         }
-        fclose(fp);
+        ChunkPrefetchFinish(pf, &io_wait);
+        pf = NULL;
+        t_pass = WallSeconds() - t_pass;
 
+        last_ll = pass_ll;
+        last_n  = pass_n;
         double avg_ll = pass_ll / (pass_n > 0 ? (double)pass_n : 1.0);
         if (config->verbose)
-            printf("  [stream] pass %d/%d  avg_LL=%.6f  eta=%.4f\n",
-                   pass + 1, max_passes, avg_ll, pow((double)(global_step + 1), -decay));
+            printf("  [stream] pass %d/%d  avg_LL=%.6f  eta=%.4f  io_wait=%.3fs  compute=%.3fs\n",
+                   pass + 1, max_passes, avg_ll, pow((double)(global_step + 1), -decay),
+                   io_wait, t_pass - io_wait);
+
+        int converged = pass > 0 && fabs(avg_ll - prev_ll) < rtole;
+        prev_ll = avg_ll;
 
-        if (pass > 0 && fabs(avg_ll - prev_ll) < rtole) {
+        /* End-of-pass checkpoint: the next run starts the following pass */
+        if (ckpath) {
+            memset(&ck, 0, sizeof(ck));
+            ck.pass    = pass + 1;
+            ck.converged = converged;
+            ck.total_n = total_n;
+            ck.prev_ll = prev_ll;
+            ck.last_ll = last_ll;
+            ck.last_n  = last_n;
+            cstream_save(ckpath, &ck, k, (int)config->type, global_step,
+                         input_size, result, s0, s1_re, s1_im, s2);
+        }
+        if (converged) {
             if (config->verbose) printf("  [stream] converged at pass %d\n", pass + 1);
             break;
         }
-        prev_ll = avg_ll;
     }
 
-    /* ── Final full-pass LL ───────────────────────────────────────── */
-    fp = fopen(filename, "r");
+    /* ── Final LL: last EM pass's sum, or one more full pass ────────── */
     double final_ll = 0.0;
-    if (fp) {
-        while (fgets(line, sizeof(line), fp)) {
-            if (line[0] == '#' || line[0] == '\n') continue;
-            double re = 0, im = 0;
-            char* comma = strchr(line, ',');
-            if (comma) { *comma = ' '; }
-            if (sscanf(line, "%lf %lf", &re, &im) != 2) continue;
-            double max_logp = -1e30;
-            double lps[64];
-            for (int jj = 0; jj < k && jj < 64; jj++) {
-                lps[jj] = log(result->mixing_weights[jj])
-                        + ccirc_gauss_logpdf(re, im, &result->components[jj]);
-                if (lps[jj] > max_logp) max_logp = lps[jj];
+    if (config->ll_from_last_pass && last_n > 0) {
+        final_ll = last_ll;
+    } else {
+        cstream_rewind(&src);
+        pf = ChunkPrefetchStart(cstream_next, &src, (size_t)chunk_size, 2, nbuf);
+        if (!pf) {
+            free(s0); free(s1_re); free(s1_im); free(s2);
+            free(c_resp);
+            goto stream_oom;
+        }
+        while ((got = ChunkPrefetchNext(pf, &z)) > 0) {
+            for (size_t i = 0; i < got; i++) {
+                double re = z[2*i], im = z[2*i+1];
+                double max_logp = -1e30;
+                double lps[64];
+                for (int jj = 0; jj < k && jj < 64; jj++) {
+                    lps[jj] = log(result->mixing_weights[jj])
+                            + ccirc_gauss_logpdf(re, im, &result->components[jj]);
+                    if (lps[jj] > max_logp) max_logp = lps[jj];
+                }
+                double s = 0.0;
+                for (int jj = 0; jj < k && jj < 64; jj++) s += exp(lps[jj] - max_logp);
+                final_ll += max_logp + log(s);
             }
-            double s = 0.0;
-            for (int jj = 0; jj < k && jj < 64; jj++) s += exp(lps[jj] - max_logp);
-            final_ll += max_logp + log(s);
         }
-        fclose(fp);
+        ChunkPrefetchFinish(pf, NULL);
     }
+    cstream_close(&src);
 
     result->loglikelihood = final_ll;
     result->iterations    = global_step;
@@ -1193,11 +1657,13 @@ int UnmixComplexStreaming(const char* filename,
     result->aic = -2.0 * final_ll + 2.0 * nfree;
 
     free(s0); free(s1_re); free(s1_im); free(s2);
-    free(chunk); free(c_resp);
+    free(c_resp);
     return 0;
 
 stream_oom:
+    CheckpointRelease(&ck);
+    cstream_close(&src);
     free(result->mixing_weights); result->mixing_weights = NULL;
     free(result->components);     result->components     = NULL;
-    return -2;
+    return -5;
 }
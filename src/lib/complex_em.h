@@ -91,6 +91,9 @@ typedef struct {
  *
  * Model: f(z|μ,σ²) = (1/πσ²) exp(-|z-μ|²/σ²)
  *
+ * With SetEMAcceleration(1) (accel.h) this engine, UnmixComplexNonCircular
+ * and UnmixMVComplex run SQUAREM-accelerated EM.
+ *
  * @param data     Interleaved real/imag array, length 2*n
  * @param n        Number of complex observations
  * @param k        Number of mixture components
@@ -208,16 +211,29 @@ typedef struct {
     int verbose;
     double eta_decay;  /* Step-size decay exponent ∈ (0.5, 1] (default 0.6) */
     ComplexGaussType type; /* Only CGAUSS_CIRCULAR supported */
+    int io_buffers;    /* Read-ahead ring: 0 = default (3), 1 = no reader thread */
+    int ll_from_last_pass; /* 1: report the LL accumulated during the last EM
+                            * pass instead of an extra exact pass */
+    const char* checkpoint_path; /* Resume from / save to this file (NULL = off) */
+    int checkpoint_every;  /* Chunks between checkpoints; 0 = end of each pass */
 } ComplexStreamConfig;
 
 /**
  * Streaming EM for circular complex Gaussian mixture.
- * File format: one complex observation per line, "re im" or "re,im".
+ * File format: one complex observation per line, "re im" or "re,im", or a
+ * GEMBIN file (binfile.h) with two values per row: CI16 dim 1 or F64/F32
+ * dim 2.  Binary files are memory-mapped and read without parsing.
+ * As in UnmixStreaming, ll_from_last_pass skips the final LL pass; the
+ * reported LL then trails the exact one slightly until EM has converged.
+ * Checkpoints work as in UnmixStreaming; a resumed run also skips the
+ * initial scan, since the checkpoint carries the row count.
  *
  * @param filename  Path to IQ data file
  * @param config    Streaming configuration
  * @param result    Output (caller must call ReleaseCCircResult)
- * @return 0 on success, <0 on error
+ * @return 0 on success, <0 on error; -1 if the checkpoint is for another
+ *         model or for an input of a different size, -5 if buffers or the
+ *         reader thread cannot be allocated
  */
 int UnmixComplexStreaming(const char* filename, const ComplexStreamConfig* config,
                           CCircMixtureResult* result);
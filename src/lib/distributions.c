@@ -11,11 +11,16 @@
 #include <math.h>
 #include <float.h>
 #include <stdint.h>
+#ifdef _OPENMP
+#include <omp.h>
+#endif
 
 #include "distributions.h"
 #include "pearson.h"
 #include "gpu_estep.h"
 #include "simd_estep.h"
+#include "checkpoint.h"
+#include "walltime.h"
 
 /* Global GPU context — initialized on first use, NULL if unavailable */
 static GpuContext* g_gpu_ctx = NULL;
@@ -146,6 +151,141 @@ static void xorshift128p_seed(xorshift128p_state* st, uint64_t seed) {
     if (st->s[0] == 0 && st->s[1] == 0) st->s[0] = 1;
 }
 
+/* ====================================================================
+ * Subsampled initialization for very large n
+ *
+ * k-means++ seeding touches every point once per chosen center and
+ * Lloyd's refinement once per iteration per restart, so for n ≥ 10⁶ the
+ * init phase costs more than EM itself on well-separated data.  Seeding
+ * on a few thousand rows gives centers that are just as good (the D²
+ * distribution is estimated from the sample) and EM on the full data
+ * repairs any residual error in the first couple of iterations.
+ *
+ * The sample is stratified: row s is drawn uniformly from the stratum
+ * [s·n/m, (s+1)·n/m).  That keeps sorted or blocked inputs (common for
+ * generated benchmark files) represented proportionally, and needs only
+ * m random draws instead of a pass over all n rows.
+ * ==================================================================== */
+#define INIT_SUBSAMPLE_MIN   4096
+#define INIT_SUBSAMPLE_MAX   65536
+#define INIT_SUBSAMPLE_PER_KD 256
+
+static size_t g_init_subsample_threshold = GEMMULEM_INIT_SUBSAMPLE_THRESHOLD;
+
+void SetInitSubsampleThreshold(size_t threshold) {
+    g_init_subsample_threshold = threshold;
+}
+
+size_t GetInitSubsampleThreshold(void) {
+    return g_init_subsample_threshold;
+}
+
+size_t InitSubsampleSize(size_t n, int k, int d) {
+    if (g_init_subsample_threshold == 0 || n < g_init_subsample_threshold)
+        return 0;
+    if (k < 1) k = 1;
+    if (d < 1) d = 1;
+    size_t m = (size_t)INIT_SUBSAMPLE_PER_KD * (size_t)k * (size_t)d;
+    if (m < INIT_SUBSAMPLE_MIN) m = INIT_SUBSAMPLE_MIN;
+    if (m > INIT_SUBSAMPLE_MAX) m = INIT_SUBSAMPLE_MAX;
+    return m < n ? m : 0;
+}
+
+size_t InitSubsample(const double* data, size_t n, int d, int k, double** out) {
+    *out = NULL;
+    if (!data || d < 1) return 0;
+    size_t m = InitSubsampleSize(n, k, d);
+    if (m == 0) return 0;
+
+    double* xs = (double*)malloc(sizeof(double) * m * (size_t)d);
+    if (!xs) return 0;
+
+    xorshift128p_state rng;
+    xorshift128p_seed(&rng, (uint64_t)n * 0x9E3779B97F4A7C15ULL
+                            + (uint64_t)k * 7919ULL + (uint64_t)d);
+    double stratum = (double)n / (double)m;
+    for (size_t s = 0; s < m; s++) {
+        size_t i = (size_t)(((double)s + xorshift128p_double(&rng)) * stratum);
+        if (i >= n) i = n - 1;
+        memcpy(xs + s * (size_t)d, data + i * (size_t)d, sizeof(double) * (size_t)d);
+    }
+    *out = xs;
+    return m;
+}
+
+/* ====================================================================
+ * Coarse-to-fine multiresolution schedule
+ *
+ * Early EM iterations only move the parameters toward the basin of the
+ * optimum, and a 1% sample locates that basin about as well as the full
+ * data.  Fitting 1% → 10% → 100% with parameters carried forward leaves
+ * only the last few polishing iterations at full cost.
+ *
+ * Rows are selected by hashing their index, not by stride, so blocked
+ * inputs (rows grouped by cluster) are sampled uniformly, and the sample
+ * at each level contains the one before it.
+ * ==================================================================== */
+#define MULTIRES_RATIO       10
+#define MULTIRES_MIN_ROWS    2000
+#define MULTIRES_MIN_PER_KD  100
+
+static int g_multires_levels = 1;
+
+void SetMultiresLevels(int levels) {
+    if (levels < 1) levels = 1;
+    if (levels > GEMMULEM_MULTIRES_MAX_LEVELS) levels = GEMMULEM_MULTIRES_MAX_LEVELS;
+    g_multires_levels = levels;
+}
+
+int GetMultiresLevels(void) {
+    return g_multires_levels;
+}
+
+int MultiresSchedule(size_t n, int k, int d, size_t* sizes) {
+    if (k < 1) k = 1;
+    if (d < 1) d = 1;
+    size_t min_rows = (size_t)MULTIRES_MIN_PER_KD * (size_t)k * (size_t)d;
+    if (min_rows < MULTIRES_MIN_ROWS) min_rows = MULTIRES_MIN_ROWS;
+
+    int nlev = 0;
+    size_t div = 1;
+    for (int l = 1; l < g_multires_levels; l++) div *= MULTIRES_RATIO;
+    for (int l = 1; l < g_multires_levels; l++, div /= MULTIRES_RATIO) {
+        size_t m = n / div;
+        if (m >= min_rows) sizes[nlev++] = m;
+    }
+    return nlev;
+}
+
+/* splitmix64 finalizer: index → uniform 64-bit value */
+static inline uint64_t multires_hash(uint64_t i) {
+    uint64_t z = i * 0x9e3779b97f4a7c15ULL + 0x6a09e667f3bcc909ULL;
+    z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+    return z ^ (z >> 31);
+}
+
+size_t MultiresSubsample(const double* data, size_t n, int d, size_t m, double** out) {
+    *out = NULL;
+    if (!data || n == 0 || d < 1) return 0;
+    uint64_t cut = (m >= n) ? UINT64_MAX
+                 : (uint64_t)((double)m / (double)n * 18446744073709551616.0);
+
+    size_t cnt = 0;
+    for (size_t i = 0; i < n; i++)
+        if (multires_hash(i) < cut) cnt++;
+    if (cnt == 0) return 0;
+
+    double* xs = (double*)malloc(sizeof(double) * cnt * (size_t)d);
+    if (!xs) return 0;
+    size_t s = 0;
+    for (size_t i = 0; i < n; i++)
+        if (multires_hash(i) < cut)
+            memcpy(xs + (s++) * (size_t)d, data + i * (size_t)d, sizeof(double) * (size_t)d);
+    *out = xs;
+    return cnt;
+}
+
 static void gauss_init(const double* x, size_t n, int k, DistParams* out) {
     /*
      * gauss_init: k-means++ initialization with 10 independent restarts.
@@ -195,6 +335,19 @@ static void gauss_init(const double* x, size_t n, int k, DistParams* out) {
      */
     int km_restarts = 5;
 
+    /* Very large n: seed on a stratified subsample instead (see
+     * InitSubsample).  Cluster fractions in p[2] are sample fractions,
+     * which estimate the full-data fractions without bias. */
+    {
+        double* xs = NULL;
+        size_t m = InitSubsample(x, n, 1, k, &xs);
+        if (m > 0) {
+            gauss_init(xs, m, k, out);
+            free(xs);
+            return;
+        }
+    }
+
     /* Data-content hash: sample ~100 evenly-spaced points */
     unsigned dhash = 0x12345678u;
     {
@@ -1680,6 +1833,257 @@ const char* GetDistName(DistFamily family) {
 }
 
 
+/* ====================================================================
+ * Sufficient-statistic maps (streaming / online M-step)
+ *   T(x) per value; from_stats turns responsibility-weighted averages
+ *   t̄ = Σ r·T(x) / Σ r into parameters.  Each map reproduces the
+ *   family's estimate() on the same data, so a streaming fit converges
+ *   to the in-memory EM fixed point.
+ * ==================================================================== */
+static void ss_x_x2(double x, const DistParams* p, double* t) { (void)p; t[0] = x; t[1] = x*x; }
+static void ss_x(double x, const DistParams* p, double* t)    { (void)p; t[0] = x; }
+static void ss_x2(double x, const DistParams* p, double* t)   { (void)p; t[0] = x*x; }
+
+static void gauss_from_stats(const double* t, DistParams* out) {
+    double mu = t[0];
+    double var = t[1] - mu*mu;
+    if (var < 1e-10) var = 1e-10;
+    out->p[0] = mu; out->p[1] = var; out->nparams = 2;
+}
+
+static void expo_from_stats(const double* t, DistParams* out) {
+    out->p[0] = 1.0 / fmax(t[0], 1e-10); out->nparams = 1;
+}
+
+static void poisson_from_stats(const double* t, DistParams* out) {
+    out->p[0] = fmax(t[0], 1e-10); out->nparams = 1;
+}
+
+/* Gamma: T = {x, log x}; alpha solves log α − ψ(α) = log x̄ − mean(log x),
+ * Newton from Minka's closed-form start */
+static void gamma_stats(double x, const DistParams* p, double* t) { (void)p; t[0] = x; t[1] = log(x); }
+static void gamma_from_stats(const double* t, DistParams* out) {
+    double mu = fmax(t[0], 1e-10);
+    double s = log(mu) - t[1];
+    double alpha = out->p[0] > 0 ? out->p[0] : 1.0;
+    if (s > 0) {
+        alpha = (3 - s + sqrt((s - 3)*(s - 3) + 24*s)) / (12*s);
+        for (int it = 0; it < 10; it++) {
+            double step = (log(alpha) - digamma_approx(alpha) - s) /
+                          (1.0/alpha - trigamma_approx(alpha));
+            double alpha_new = alpha - step;
+            if (alpha_new <= 0) alpha_new = alpha * 0.5;
+            if (fabs(alpha_new - alpha) < 1e-8 * alpha) { alpha = alpha_new; break; }
+            alpha = alpha_new;
+        }
+    }
+    double beta = alpha / mu;
+    if (alpha < 0.01) alpha = 0.01;
+    if (beta < 0.01) beta = 0.01;
+    out->p[0] = alpha; out->p[1] = beta;
+    out->p[2] = lgamma(alpha);
+    out->nparams = 3;
+}
+
+static void lognorm_stats(double x, const DistParams* p, double* t) {
+    (void)p;
+    double lx = log(x);
+    t[0] = lx; t[1] = lx*lx;
+}
+
+/* Beta: moments, as beta_estimate */
+static void beta_from_stats(const double* t, DistParams* out) {
+    double mu = t[0];
+    double var = t[1] - mu*mu;
+    if (mu < 0.001) mu = 0.001;
+    if (mu > 0.999) mu = 0.999;
+    if (var < 1e-10) var = 1e-10;
+    if (var >= mu*(1-mu)) var = mu*(1-mu) * 0.99;
+    double common = mu*(1-mu)/var - 1;
+    double a = mu * common, b = (1-mu) * common;
+    if (a < 0.01) a = 0.01;
+    if (b < 0.01) b = 0.01;
+    out->p[0] = a; out->p[1] = b; out->nparams = 2;
+}
+
+/* Student-t (ECM, Peel & McLachlan 2000): with the latent precision
+ * u = (ν+1)/(ν+z²) at the current parameters, T = {u, u·x, u·x², log u − u}.
+ * μ and σ are the u-weighted moments; ν solves
+ *   1 + log(ν/2) − ψ(ν/2) + mean(log u − u) + ψ((ν₀+1)/2) − log((ν₀+1)/2) = 0
+ * by bisection (the left side decreases in ν) over the range studt_estimate uses. */
+static void studt_stats(double x, const DistParams* p, double* t) {
+    double sigma = p->p[1] > 1e-10 ? p->p[1] : 1e-10;
+    double nu = p->p[2] > 0 ? p->p[2] : 1;
+    double z = (x - p->p[0]) / sigma;
+    double u = (nu + 1) / (nu + z*z);
+    t[0] = u; t[1] = u*x; t[2] = u*x*x; t[3] = log(u) - u;
+}
+static void studt_from_stats(const double* t, DistParams* out) {
+    double nu0 = out->p[2] > 0 ? out->p[2] : 1;
+    double su = fmax(t[0], 1e-300);
+    double mu = t[1] / su;
+    double var = t[2] - t[1]*t[1] / su;
+    double sigma = sqrt(fmax(var, 1e-20));
+    if (sigma < 1e-10) sigma = 1e-10;
+
+    double c = 1 + t[3] + digamma_approx(0.5*(nu0 + 1)) - log(0.5*(nu0 + 1));
+    double lo = 1, hi = 200, nu;
+    if (log(0.5*hi) - digamma_approx(0.5*hi) + c >= 0) nu = hi;
+    else if (log(0.5*lo) - digamma_approx(0.5*lo) + c <= 0) nu = lo;
+    else {
+        for (int it = 0; it < 50 && hi - lo > 1e-6 * lo; it++) {
+            double mid = 0.5 * (lo + hi);
+            if (log(0.5*mid) - digamma_approx(0.5*mid) + c > 0) lo = mid;
+            else hi = mid;
+        }
+        nu = 0.5 * (lo + hi);
+    }
+    out->p[0] = mu; out->p[1] = sigma; out->p[2] = nu; out->nparams = 3;
+}
+
+static void invgauss_stats(double x, const DistParams* p, double* t) { (void)p; t[0] = x; t[1] = 1.0 / x; }
+static void invgauss_from_stats(const double* t, DistParams* out) {
+    double mu = fmax(t[0], 1e-10);
+    double inv_lam = t[1] - 1.0/mu;
+    double lam = (inv_lam > 1e-10) ? 1.0 / inv_lam : mu * mu;
+    if (lam < 1e-10) lam = 1e-10;
+    out->p[0] = mu; out->p[1] = lam; out->nparams = 2;
+}
+
+static void rayleigh_from_stats(const double* t, DistParams* out) {
+    out->p[0] = sqrt(fmax(0.5 * t[0], 1e-10)); out->nparams = 1;
+}
+
+static void chisq_from_stats(const double* t, DistParams* out) {
+    out->p[0] = fmax(t[0], 0.5); out->nparams = 1;
+}
+
+static void nakagami_stats(double x, const DistParams* p, double* t) {
+    (void)p;
+    double x2 = x*x;
+    t[0] = x2; t[1] = x2*x2;
+}
+static void nakagami_from_stats(const double* t, DistParams* out) {
+    double m = t[0]*t[0] / fmax(t[1] - t[0]*t[0], 1e-10);
+    out->p[0] = fmax(m, 0.5); out->p[1] = fmax(t[0], 1e-10); out->nparams = 2;
+}
+
+static void halfnorm_from_stats(const double* t, DistParams* out) {
+    out->p[0] = fmax(sqrt(fmax(t[0], 0)), 1e-10); out->nparams = 1;
+}
+
+static void maxwell_from_stats(const double* t, DistParams* out) {
+    out->p[0] = fmax(sqrt(fmax(t[0], 0) / 3), 1e-10); out->nparams = 1;
+}
+
+static void binomial_from_stats(const double* t, DistParams* out) {
+    double mu = t[0], var = t[1] - t[0]*t[0];
+    double est_n;
+    if (var < mu) est_n = mu*mu / fmax(mu - var, 1e-10); else est_n = fmax(mu, 1);
+    est_n = fmax(round(est_n), 1);
+    out->p[0] = est_n;
+    out->p[1] = fmax(1e-10, fmin(1-1e-10, mu/est_n));
+    out->nparams = 2;
+}
+
+static void negbinom_from_stats(const double* t, DistParams* out) {
+    double mu = t[0], var = t[1] - t[0]*t[0];
+    double p_est = (var > mu) ? mu/var : 0.5;
+    double r_est = mu*p_est/(1-p_est+1e-10);
+    out->p[0] = fmax(r_est, 0.5);
+    out->p[1] = fmax(1e-10, fmin(1-1e-10, p_est));
+    out->nparams = 2;
+}
+
+static void geometric_from_stats(const double* t, DistParams* out) {
+    out->p[0] = fmax(1e-10, fmin(1-1e-10, 1.0/(1 + t[0]))); out->nparams = 1;
+}
+
+static const DistSuffStats suffstats_table[DIST_COUNT] = {
+    [DIST_GAUSSIAN]    = { 2, 0, ss_x_x2,        gauss_from_stats },
+    [DIST_EXPONENTIAL] = { 1, 0, ss_x,           expo_from_stats },
+    [DIST_POISSON]     = { 1, 0, ss_x,           poisson_from_stats },
+    [DIST_GAMMA]       = { 2, 0, gamma_stats,    gamma_from_stats },
+    [DIST_LOGNORMAL]   = { 2, 0, lognorm_stats,  gauss_from_stats },
+    [DIST_BETA]        = { 2, 0, ss_x_x2,        beta_from_stats },
+    [DIST_STUDENT_T]   = { 4, 1, studt_stats,    studt_from_stats },
+    [DIST_INVGAUSS]    = { 2, 0, invgauss_stats, invgauss_from_stats },
+    [DIST_RAYLEIGH]    = { 1, 0, ss_x2,          rayleigh_from_stats },
+    [DIST_CHISQ]       = { 1, 0, ss_x,           chisq_from_stats },
+    [DIST_NAKAGAMI]    = { 2, 0, nakagami_stats, nakagami_from_stats },
+    [DIST_HALFNORMAL]  = { 1, 0, ss_x2,          halfnorm_from_stats },
+    [DIST_MAXWELL]     = { 1, 0, ss_x2,          maxwell_from_stats },
+    [DIST_BINOMIAL]    = { 2, 0, ss_x_x2,        binomial_from_stats },
+    [DIST_NEGBINOM]    = { 2, 0, ss_x_x2,        negbinom_from_stats },
+    [DIST_GEOMETRIC]   = { 1, 0, ss_x,           geometric_from_stats },
+};
+
+const DistSuffStats* GetDistSuffStats(DistFamily family) {
+    if (family < 0 || family >= DIST_COUNT || !suffstats_table[family].stats) return NULL;
+    return &suffstats_table[family];
+}
+
+void DistSuffStatsSum(DistFamily family, const double* x, size_t n, int k,
+                      const double* resp, const DistParams* params,
+                      double* scratch, double* stat)
+{
+    const DistSuffStats* ss = GetDistSuffStats(family);
+    const DistFunctions* df = GetDistFunctions(family);
+    int ns = ss->nstats;
+
+    /* T(x) once per value when it does not depend on the component;
+     * row ns holds 1 for in-domain values, 0 for values to skip */
+    if (scratch && !ss->uses_params) {
+        double t[DIST_MAX_STATS];
+        for (size_t i = 0; i < n; i++) {
+            int ok = isfinite(x[i]) && (!df->valid || df->valid(x[i]));
+            if (ok) ss->stats(x[i], NULL, t);
+            for (int s = 0; s < ns; s++) scratch[s*n + i] = ok ? t[s] : 0;
+            scratch[ns*n + i] = ok;
+        }
+    }
+
+    #ifdef _OPENMP
+    #pragma omp parallel for schedule(static) if(n * k > 100000)
+    #endif
+    for (int j = 0; j < k; j++) {
+        const double* r = resp + (size_t)j * n;
+        double acc[DIST_MAX_STATS + 1] = { 0 };
+        if (scratch && !ss->uses_params) {
+            const double* ok = scratch + ns*n;
+            for (size_t i = 0; i < n; i++) acc[0] += r[i] * ok[i];
+            for (int s = 0; s < ns; s++) {
+                const double* ts = scratch + s*n;
+                double a = 0;
+                for (size_t i = 0; i < n; i++) a += r[i] * ts[i];
+                acc[1 + s] = a;
+            }
+        } else {
+            double t[DIST_MAX_STATS];
+            for (size_t i = 0; i < n; i++) {
+                if (!isfinite(x[i]) || (df->valid && !df->valid(x[i]))) continue;
+                ss->stats(x[i], &params[j], t);
+                acc[0] += r[i];
+                for (int s = 0; s < ns; s++) acc[1 + s] += r[i] * t[s];
+            }
+        }
+        for (int s = 0; s <= ns; s++) stat[(size_t)s*k + j] = acc[s];
+    }
+}
+
+void DistParamsFromStats(DistFamily family, const double* stat, int k,
+                         DistParams* params)
+{
+    const DistSuffStats* ss = GetDistSuffStats(family);
+    for (int j = 0; j < k; j++) {
+        double sw = stat[j] > 1e-10 ? stat[j] : 1e-10;
+        double t[DIST_MAX_STATS];
+        for (int s = 0; s < ss->nstats; s++) t[s] = stat[(size_t)(1 + s)*k + j] / sw;
+        ss->from_stats(t, &params[j]);
+    }
+}
+
+
 /* ====================================================================
  * Generic Mixture EM
  * ==================================================================== */
@@ -1688,6 +2092,257 @@ static int UnmixGenericSingle(const double* data, size_t n, DistFamily family, i
                               int maxiter, double rtole, int verbose,
                               MixtureResult* result, unsigned init_seed);
 
+/* Working state of one run, kept between generic_em_run calls so the
+ * multi-start rounds continue a run instead of restarting it */
+typedef struct {
+    double* resp;        /* [k*n] responsibilities */
+    double* weights_j;   /* [n] one component's responsibilities */
+    double* theta0;      /* SQUAREM parameter vectors */
+    double* theta1;
+    double* theta2;
+    double  prev_ll;     /* LL of the last E-step */
+    int     iter;        /* EM iterations so far */
+    int     converged;
+} GenericEM;
+
+static int  generic_em_begin(const double* data, size_t n, DistFamily family, int k,
+                             int verbose, MixtureResult* result, unsigned init_seed,
+                             GenericEM* st);
+static void generic_em_run(const double* data, size_t n, int k, int maxiter,
+                           double rtole, int verbose, MixtureResult* result,
+                           GenericEM* st);
+static void generic_em_end(GenericEM* st, size_t n, MixtureResult* result);
+static void generic_em_free(GenericEM* st);
+
+/*
+ * Internal: UnmixGenericSingle behind the multiresolution schedule (see
+ * MultiresSchedule).  Coarse levels start from the family init and then
+ * hand their parameters to the next level in polish mode (seed 0); the
+ * last level always runs on the full data with tolerance rtole.  rtole on
+ * the LL of m rows is a per-row tolerance of rtole/m, n/m times looser
+ * than the full fit's, so the criterion tightens tenfold per level.  A
+ * level that fails hands over to the full-data fit from the family init.
+ * With no coarse levels this is exactly UnmixGenericSingle.
+ */
+static int UnmixGenericMultires(const double* data, size_t n, DistFamily family, int k,
+                                int maxiter, double rtole, int verbose,
+                                MixtureResult* result, unsigned init_seed)
+{
+    size_t sizes[GEMMULEM_MULTIRES_MAX_LEVELS];
+    int nlev = MultiresSchedule(n, k, 1, sizes);
+    int started = 0;
+    for (int l = 0; l < nlev; l++) {
+        double* sub = NULL;
+        size_t m = MultiresSubsample(data, n, 1, sizes[l], &sub);
+        if (m < (size_t)k) { free(sub); continue; }
+        double t_lev = WallSeconds();
+        int rc = UnmixGenericSingle(sub, m, family, k, maxiter, rtole, 0, result,
+                                    started ? 0 : init_seed);
+        free(sub);
+        if (rc != 0 || !isfinite(result->loglikelihood)) {
+            if (verbose)
+                printf("  [%s k=%d] multires level %d/%d failed (rc=%d); fitting the full data\n",
+                       GetDistName(family), k, l + 1, nlev + 1, rc);
+            if (rc == 0 || started) ReleaseMixtureResult(result);
+            started = 0;
+            break;
+        }
+        started = 1;
+        if (verbose)
+            printf("  [%s k=%d] multires level %d/%d: n=%zu  LL=%.4f  iters=%d  %.3f s\n",
+                   GetDistName(family), k, l + 1, nlev + 1, m,
+                   result->loglikelihood, result->iterations, WallSeconds() - t_lev);
+    }
+    int rc = UnmixGenericSingle(data, n, family, k, maxiter, rtole, verbose,
+                                result, started ? 0 : init_seed);
+    if (rc != 0 && started) ReleaseMixtureResult(result);
+    return rc;
+}
+
+/* ====================================================================
+ * Parallel multi-start with early pruning
+ *
+ * R restarts advance in lock-step rounds of MS_ROUND_ITERS EM iterations
+ * (restarts run concurrently within a round).  Each restart keeps its
+ * working state (GenericEM) across rounds, so it continues exactly as one
+ * uninterrupted run would, SQUAREM schedule included.  After each round
+ * every restart whose LL trails the leader by more than
+ * max(MS_PRUNE_ABS, MS_PRUNE_REL·|LL_leader|) is dropped, as is one that
+ * converged below the leader; restarts within the margin keep running
+ * until one is left or all have converged, and the leader is polished to
+ * rtole.  Restart 0 is the standard
+ * single-run start; restart r ≥ 1 initializes the family on a half-size
+ * random subsample drawn from xorshift128+ seeded by r, so every restart,
+ * and the pruning decisions taken between rounds, are the same for any
+ * thread count.
+ * ==================================================================== */
+#define MS_ROUND_ITERS 10
+#define MS_PRUNE_ABS   10.0
+#define MS_PRUNE_REL   1e-4
+
+static int g_num_restarts = 1;
+
+void SetNumRestarts(int restarts) {
+    g_num_restarts = restarts < 1 ? 1 : restarts;
+}
+
+int GetNumRestarts(void) {
+    return g_num_restarts;
+}
+
+#ifdef _OPENMP
+static int g_default_threads = 0;   /* OpenMP default, saved on first use */
+#endif
+
+void SetNumThreads(int threads) {
+#ifdef _OPENMP
+    if (g_default_threads == 0) g_default_threads = omp_get_max_threads();
+    omp_set_num_threads(threads > 0 ? threads : g_default_threads);
+#else
+    (void)threads;
+#endif
+}
+
+int GetNumThreads(void) {
+#ifdef _OPENMP
+    return omp_get_max_threads();
+#else
+    return 1;
+#endif
+}
+
+/* Start for restart r ≥ 1: family init on a random half of the data */
+static int multistart_init(const double* data, size_t n, const DistFunctions* df,
+                           int k, int r, MixtureResult* tr)
+{
+    size_t m = n / 2 > (size_t)k ? n / 2 : n;
+    double* sub = (double*)malloc(sizeof(double) * m);
+    tr->mixing_weights = (double*)malloc(sizeof(double) * k);
+    tr->params = (DistParams*)calloc(k, sizeof(DistParams));
+    if (!sub || !tr->mixing_weights || !tr->params) {
+        free(sub);
+        ReleaseMixtureResult(tr);
+        return -3;
+    }
+    xorshift128p_state rng;
+    xorshift128p_seed(&rng, 0x5EEDULL * (uint64_t)r + (uint64_t)n);
+    for (size_t i = 0; i < m; i++)
+        sub[i] = data[(size_t)(xorshift128p_double(&rng) * n) % n];
+    df->init_params(sub, m, k, tr->params);
+    free(sub);
+
+    tr->family = df->family;
+    tr->num_components = k;
+    if (df->family == DIST_GAUSSIAN) {
+        /* gauss_init stashes k-means cluster fractions in p[2] */
+        double wsum = 0;
+        for (int j = 0; j < k; j++) {
+            tr->mixing_weights[j] = fmax(tr->params[j].p[2], 1e-10);
+            tr->params[j].p[2] = 0;
+            wsum += tr->mixing_weights[j];
+        }
+        for (int j = 0; j < k; j++) tr->mixing_weights[j] /= wsum;
+    } else {
+        for (int j = 0; j < k; j++) tr->mixing_weights[j] = 1.0 / k;
+    }
+    return 0;
+}
+
+static int UnmixGenericMultistart(const double* data, size_t n, DistFamily family,
+                                  int k, int maxiter, double rtole, int verbose,
+                                  int R, MixtureResult* result)
+{
+    const DistFunctions* df = GetDistFunctions(family);
+    if (!df) return -2;
+
+    MixtureResult* tr = (MixtureResult*)calloc(R, sizeof(MixtureResult));
+    GenericEM* st = (GenericEM*)calloc(R, sizeof(GenericEM));
+    int* alive = (int*)malloc(sizeof(int) * R);
+    int* rcs   = (int*)calloc(R, sizeof(int));
+    int* list  = (int*)malloc(sizeof(int) * R);
+    if (!tr || !st || !alive || !rcs || !list) {
+        free(tr); free(st); free(alive); free(rcs); free(list);
+        return -3;
+    }
+    for (int r = 0; r < R; r++) alive[r] = 1;
+    unsigned seed0 = 0xCAFE + (unsigned)k + (unsigned)(n & 0xFFFF);
+
+    int n_alive = R, leader = 0;
+    double t0 = WallSeconds();
+    for (int round = 0; ; round++) {
+        int nl = 0;
+        for (int r = 0; r < R; r++)
+            if (alive[r] && !st[r].converged && st[r].iter < maxiter) list[nl++] = r;
+        if (nl == 0 || n_alive == 1) break;
+
+        #ifdef _OPENMP
+        #pragma omp parallel for schedule(dynamic, 1)
+        #endif
+        for (int q = 0; q < nl; q++) {
+            int r = list[q];
+            int rc = 0;
+            if (round == 0) {
+                if (r == 0)
+                    rc = generic_em_begin(data, n, family, k, 0, &tr[r], seed0, &st[r]);
+                else {
+                    rc = multistart_init(data, n, df, k, r, &tr[r]);
+                    if (rc == 0)
+                        rc = generic_em_begin(data, n, family, k, 0, &tr[r], 0, &st[r]);
+                }
+            }
+            rcs[r] = rc;
+            if (rc == 0) {
+                int cap = maxiter - st[r].iter < MS_ROUND_ITERS ? maxiter
+                                                                : st[r].iter + MS_ROUND_ITERS;
+                generic_em_run(data, n, k, cap, rtole, 0, &tr[r], &st[r]);
+                tr[r].loglikelihood = st[r].prev_ll;
+            }
+        }
+
+        /* Prune (serial, in restart order) */
+        double best = -HUGE_VAL;
+        for (int r = 0; r < R; r++) {
+            if (alive[r] && rcs[r] != 0) {
+                alive[r] = 0;
+                n_alive--;
+                ReleaseMixtureResult(&tr[r]);
+            }
+            if (alive[r] && tr[r].loglikelihood > best) { best = tr[r].loglikelihood; leader = r; }
+        }
+        if (n_alive == 0) break;
+        double margin = fmax(MS_PRUNE_ABS, MS_PRUNE_REL * fabs(best));
+        for (int r = 0; r < R; r++) {
+            if (!alive[r] || r == leader) continue;
+            /* A converged restart below the leader can no longer win */
+            if (tr[r].loglikelihood < best - margin ||
+                (st[r].converged && tr[r].loglikelihood < best)) {
+                alive[r] = 0;
+                n_alive--;
+                generic_em_free(&st[r]);
+                ReleaseMixtureResult(&tr[r]);
+            }
+        }
+        if (verbose)
+            printf("  [%s k=%d] multistart round %d: %d/%d alive  leader #%d LL=%.4f  %.3f s\n",
+                   df->name, k, round, n_alive, R, leader, best, WallSeconds() - t0);
+    }
+
+    int rc = n_alive > 0 ? 0 : (rcs[0] != 0 ? rcs[0] : -3);
+    if (rc == 0) {
+        /* Polish the winner to rtole with the remaining iteration budget */
+        generic_em_run(data, n, k, maxiter, rtole, verbose, &tr[leader], &st[leader]);
+        generic_em_end(&st[leader], n, &tr[leader]);
+        *result = tr[leader];
+        memset(&tr[leader], 0, sizeof(MixtureResult));
+    }
+    for (int r = 0; r < R; r++) {
+        generic_em_free(&st[r]);
+        ReleaseMixtureResult(&tr[r]);
+    }
+    free(tr); free(st); free(alive); free(rcs); free(list);
+    return rc;
+}
+
 /*
  * UnmixGeneric — main public entry point for univariate mixture EM.
  *
@@ -1722,6 +2377,12 @@ static int UnmixGenericSingle(const double* data, size_t n, DistFamily family, i
  *   For slow-converging non-Gaussian families (Gamma, etc.), SQUAREM
  *   acceleration extrapolates the EM sequence every 3 iterations.
  *
+ * MULTIRESOLUTION (SetMultiresLevels > 1):
+ *   EM first runs on nested 1/10ᴸ⁻¹ … 1/10 subsamples, whose per-row
+ *   tolerance is n/m times looser than the full fit's, and hands its
+ *   parameters down to the full data, so most iterations are cheap (see
+ *   UnmixGenericMultires).
+ *
  * RETURN VALUES:
  *   0  — converged successfully, `result` populated
  *  -1  — invalid arguments
@@ -1755,7 +2416,14 @@ int UnmixGeneric(const double* data, size_t n, DistFamily family, int k,
      *   - Full data captures the actual density structure
      *   - 30 Lloyd iterations converge k-means reliably
      *   - Zero restart overhead — straight to EM
-     * Non-Gaussian families also use single-run (family-specific init). */
+     * Non-Gaussian families also use single-run (family-specific init).
+     * SetNumRestarts(R > 1) switches to the parallel pruned multi-start. */
+    if (g_num_restarts > 1) {
+        int rc = UnmixGenericMultistart(data, n, family, k, maxiter, rtole,
+                                        verbose, g_num_restarts, result);
+        free(clean);
+        return rc;
+    }
     int n_init = 1;
     double loose_tol = rtole;
     double tight_tol = rtole;
@@ -1773,8 +2441,8 @@ int UnmixGeneric(const double* data, size_t n, DistFamily family, int k,
         /* Cap iterations for loose phase only when doing multi-restart (n_init>1).
          * For single-run (n_init=1), use full maxiter — no cap! */
         int loose_maxiter = (n_init > 1) ? (maxiter < 60 ? maxiter : 60) : maxiter;
-        int rc = UnmixGenericSingle(data, n, family, k, loose_maxiter, loose_tol,
-                                     0, &trial, seed);
+        int rc = UnmixGenericMultires(data, n, family, k, loose_maxiter, loose_tol,
+                                      n_init == 1 ? verbose : 0, &trial, seed);
         if (rc == 0 && trial.loglikelihood > best_ll) {
             if (best.mixing_weights) ReleaseMixtureResult(&best);
             best = trial;
@@ -1823,10 +2491,14 @@ int UnmixGeneric(const double* data, size_t n, DistFamily family, int k,
     return 0;
 }
 
-static int UnmixGenericSingle(const double* data, size_t n, DistFamily family, int k,
-                              int maxiter, double rtole, int verbose,
-                              MixtureResult* result, unsigned init_seed)
+/* Validate, initialize result (init_seed 0: polish the parameters already
+ * in result) and allocate the working state of one run */
+static int generic_em_begin(const double* data, size_t n, DistFamily family, int k,
+                            int verbose, MixtureResult* result, unsigned init_seed,
+                            GenericEM* st)
 {
+    memset(st, 0, sizeof(*st));
+    st->prev_ll = -1e30;
     if (!data || n == 0 || k <= 0 || !result) return -1;
 
     const DistFunctions* df = GetDistFunctions(family);
@@ -1847,7 +2519,17 @@ static int UnmixGenericSingle(const double* data, size_t n, DistFamily family, i
             return -3;
         }
 
+        double t_init = WallSeconds();
         df->init_params(data, n, k, result->params);
+        if (verbose) {
+            size_t m = (family == DIST_GAUSSIAN) ? InitSubsampleSize(n, k, 1) : 0;
+            if (m > 0)
+                printf("  [%s k=%d] init %.3f s (subsample %zu of %zu)\n",
+                       df->name, k, WallSeconds() - t_init, m, n);
+            else
+                printf("  [%s k=%d] init %.3f s\n",
+                       df->name, k, WallSeconds() - t_init);
+        }
 
         /* For Gaussian: use k-means cluster fractions from init (stashed in p[2]).
          * This matches sklearn which initializes weights from cluster sizes.
@@ -1883,36 +2565,43 @@ static int UnmixGenericSingle(const double* data, size_t n, DistFamily family, i
     }
 
     /* Responsibility matrix: r[j*n + i] = P(component j | data_i) */
-    double* resp = (double*)malloc(sizeof(double) * k * n);
-    double* weights_j = (double*)malloc(sizeof(double) * n);
-    if (!resp || !weights_j) {
-        free(resp); free(weights_j);
-        if (init_seed != 0) {
-            free(result->mixing_weights); result->mixing_weights = NULL;
-            free(result->params);         result->params = NULL;
-        }
-        return -3;
-    }
-
-    double prev_ll = -1e30;
-    int iter;
+    st->resp = (double*)malloc(sizeof(double) * k * n);
+    st->weights_j = (double*)malloc(sizeof(double) * n);
 
     /* SQUAREM acceleration: pack all parameters into a flat vector for extrapolation.
      * Layout: [w_0..w_{k-1}, p_0[0]..p_0[nparams-1], p_1[0]..., ...] */
-    int nparams_per = df->num_params;
-    int ntheta = k + k * nparams_per;  /* weights + all params */
-    double* theta0 = (double*)malloc(sizeof(double) * ntheta);
-    double* theta1 = (double*)malloc(sizeof(double) * ntheta);
-    double* theta2 = (double*)malloc(sizeof(double) * ntheta);
-    if (!theta0 || !theta1 || !theta2) {
-        free(theta0); free(theta1); free(theta2);
-        free(resp); free(weights_j);
+    int ntheta = k + k * df->num_params;  /* weights + all params */
+    st->theta0 = (double*)malloc(sizeof(double) * ntheta);
+    st->theta1 = (double*)malloc(sizeof(double) * ntheta);
+    st->theta2 = (double*)malloc(sizeof(double) * ntheta);
+    if (!st->resp || !st->weights_j || !st->theta0 || !st->theta1 || !st->theta2) {
+        generic_em_free(st);
         if (init_seed != 0) {
             free(result->mixing_weights); result->mixing_weights = NULL;
             free(result->params);         result->params = NULL;
         }
         return -3;
     }
+    return 0;
+}
+
+/* Advance a run until it converges or st->iter reaches maxiter; may be
+ * called again with a larger maxiter to continue where it stopped */
+static void generic_em_run(const double* data, size_t n, int k, int maxiter,
+                           double rtole, int verbose, MixtureResult* result,
+                           GenericEM* st)
+{
+    const DistFunctions* df = GetDistFunctions(result->family);
+    DistFamily family = result->family;
+    double* resp = st->resp;
+    double* weights_j = st->weights_j;
+    double* theta0 = st->theta0;
+    double* theta1 = st->theta1;
+    double* theta2 = st->theta2;
+    int nparams_per = df->num_params;
+    int ntheta = k + k * nparams_per;
+    double prev_ll = st->prev_ll;
+    int iter;
 
     /* Helper to pack current state into theta */
     #define PACK_THETA(th) do { \
@@ -1933,7 +2622,7 @@ static int UnmixGenericSingle(const double* data, size_t n, DistFamily family, i
                 if (isfinite(_v)) result->params[_j].p[_q] = _v; } \
     } while(0)
 
-    for (iter = 0; iter < maxiter; iter++) {
+    for (iter = st->iter; iter < maxiter && !st->converged; iter++) {
         /* ---- E-step: compute responsibilities ---- */
         /* Precompute log-weights to avoid repeated log in inner loop */
         double logw[64]; /* k <= 64 */
@@ -1966,7 +2655,11 @@ static int UnmixGenericSingle(const double* data, size_t n, DistFamily family, i
          *    OpenMP-parallelized when n > 5000 and compiled with -fopenmp.
          */
         int used_gpu = 0;
-        if (family == DIST_GAUSSIAN && n >= 50000) {
+        int gpu_ok = 1;
+        #ifdef _OPENMP
+        gpu_ok = !omp_in_parallel();  /* one GPU context: not shared by restarts */
+        #endif
+        if (family == DIST_GAUSSIAN && n >= 50000 && gpu_ok) {
             GpuContext* gpu = get_gpu();
             if (gpu) {
                 /* Convert to float32 for GPU (halves memory bandwidth) */
@@ -2050,6 +2743,7 @@ static int UnmixGenericSingle(const double* data, size_t n, DistFamily family, i
         /* Check convergence */
         if (iter > 0 && fabs(ll - prev_ll) < rtole) {
             prev_ll = ll;
+            st->converged = 1;
             iter++;
             break;
         }
@@ -2206,7 +2900,18 @@ static int UnmixGenericSingle(const double* data, size_t n, DistFamily family, i
     #undef PACK_THETA
     #undef UNPACK_THETA
 
-    result->iterations = iter;
+    st->iter = iter;
+    st->prev_ll = prev_ll;
+}
+
+/* Record iterations, LL and BIC/AIC of a finished run in result and free
+ * its working state */
+static void generic_em_end(GenericEM* st, size_t n, MixtureResult* result)
+{
+    const DistFunctions* df = GetDistFunctions(result->family);
+    int k = result->num_components;
+    double prev_ll = st->prev_ll;
+    result->iterations = st->iter;
     result->loglikelihood = prev_ll;
 
     /* BIC = -2*LL + p*log(n), where p = k*(num_params + 1) - 1 */
@@ -2214,10 +2919,26 @@ static int UnmixGenericSingle(const double* data, size_t n, DistFamily family, i
     result->bic = -2.0 * prev_ll + num_free * log((double)n);
     result->aic = -2.0 * prev_ll + 2.0 * num_free;
 
-    free(resp);
-    free(weights_j);
-    free(theta0); free(theta1); free(theta2);
+    generic_em_free(st);
+}
+
+static void generic_em_free(GenericEM* st)
+{
+    free(st->resp);
+    free(st->weights_j);
+    free(st->theta0); free(st->theta1); free(st->theta2);
+    memset(st, 0, sizeof(*st));
+}
 
+static int UnmixGenericSingle(const double* data, size_t n, DistFamily family, int k,
+                              int maxiter, double rtole, int verbose,
+                              MixtureResult* result, unsigned init_seed)
+{
+    GenericEM st;
+    int rc = generic_em_begin(data, n, family, k, verbose, result, init_seed, &st);
+    if (rc != 0) return rc;
+    generic_em_run(data, n, k, maxiter, rtole, verbose, result, &st);
+    generic_em_end(&st, n, result);
     return 0;
 }
 
@@ -3623,6 +4344,65 @@ static uint64_t xorshift64(uint64_t* state) {
     return x;
 }
 
+static const char* g_online_ckpt_path = NULL;
+static int g_online_ckpt_every = 0;
+
+void SetOnlineCheckpoint(const char* path, int every) {
+    g_online_ckpt_path = path;
+    g_online_ckpt_every = every < 0 ? 0 : every;
+}
+
+#define ONLINE_CKPT_NPARAM (DIST_MAX_PARAMS + 1)   /* p[], nparams */
+#define ONLINE_SEED 12345678901234ULL            /* mini-batch sampler */
+
+/* Checkpoint fingerprint of an UnmixOnline problem: every value and the
+ * settings that shape the trajectory besides family and k */
+static uint64_t online_fingerprint(const double* data, size_t n, int batch_size) {
+    uint64_t h = multires_hash(ONLINE_SEED ^ (uint64_t)batch_size);
+    for (size_t i = 0; i < n; i++) {
+        uint64_t bits;
+        memcpy(&bits, &data[i], sizeof(bits));
+        h = multires_hash(h ^ bits);
+    }
+    return h;
+}
+
+/* Online EM state → checkpoint: params packed as p[], nparams; stats
+ * as kept in UnmixOnline.  A failed write is reported and EM goes on. */
+static void online_save(const char* path, DistFamily family, int k, size_t n,
+                        uint64_t fingerprint, int iter, uint64_t rng, double prev_ll,
+                        const MixtureResult* result, const double* suf, int nstat)
+{
+    double* packed = (double*)malloc(sizeof(double) * k * ONLINE_CKPT_NPARAM);
+    int rc = -5;
+    if (packed) {
+        for (int j = 0; j < k; j++) {
+            double* q = packed + (size_t)j * ONLINE_CKPT_NPARAM;
+            memcpy(q, result->params[j].p, sizeof(double) * DIST_MAX_PARAMS);
+            q[DIST_MAX_PARAMS] = result->params[j].nparams;
+        }
+        Checkpoint ck;
+        memset(&ck, 0, sizeof(ck));
+        ck.engine = CKPT_ONLINE;
+        ck.family = (int)family;
+        ck.k = k;
+        ck.nparam = ONLINE_CKPT_NPARAM;
+        ck.nstat = nstat;
+        ck.step = (uint64_t)iter;
+        ck.total_n = n;
+        ck.fingerprint = fingerprint;
+        ck.rng = rng;
+        ck.prev_ll = prev_ll;
+        ck.weights = result->mixing_weights;
+        ck.params = packed;
+        ck.stats = (double*)suf;
+        rc = CheckpointWrite(path, &ck);
+        free(packed);
+    }
+    if (rc != 0)
+        fprintf(stderr, "  [online] checkpoint write to %s failed (rc=%d)\n", path, rc);
+}
+
 int UnmixOnline(const double* data, size_t n, DistFamily family, int k,
                 int maxiter, double rtole, int batch_size, int verbose,
                 MixtureResult* result)
@@ -3654,32 +4434,104 @@ int UnmixOnline(const double* data, size_t n, DistFamily family, int k,
     df->init_params(data, n, k, result->params);
     for (int j = 0; j < k; j++) result->mixing_weights[j] = 1.0 / k;
 
-    /* Running sufficient statistics: weighted mean and variance per component */
-    double* suf_w = (double*)calloc(k, sizeof(double));   /* sum of weights */
-    double* suf_wx = (double*)calloc(k, sizeof(double));  /* sum of w*x */
-    double* suf_wxx = (double*)calloc(k, sizeof(double)); /* sum of w*x² */
-
-    /* Initialize sufficient stats from first pass */
-    for (int j = 0; j < k; j++) {
-        suf_w[j] = 1.0 / k;
-        suf_wx[j] = result->params[j].p[0] / k;
-        suf_wxx[j] = (result->params[j].p[0] * result->params[j].p[0] +
-                       (result->params[j].nparams >= 2 ? result->params[j].p[1] : 1.0)) / k;
-    }
+    /* Running sufficient statistics per component: Σr, then the family's
+     * statistic map (GetDistSuffStats); families without a map keep
+     * Σr·x, Σr·x² and refit each mini-batch */
+    const DistSuffStats* ss = GetDistSuffStats(family);
+    int nstat = ss ? 1 + ss->nstats : 3;
+    double* suf = (double*)calloc((size_t)nstat * k, sizeof(double));
+    double* suf_w = suf;          /* sum of weights */
+    double* suf_wx = suf + k;     /* sum of w*x */
+    double* suf_wxx = suf + 2*k;  /* sum of w*x² */
 
     double* batch_resp = (double*)malloc(sizeof(double) * k * batch_size);
     double* batch_w = (double*)malloc(sizeof(double) * batch_size);
+    double* batch_x = (double*)malloc(sizeof(double) * batch_size);
+    double* batch_stat = (double*)malloc(sizeof(double) * nstat * k);
     int* batch_idx = (int*)malloc(sizeof(int) * batch_size);
 
-    uint64_t rng_state = 12345678901234ULL;  /* seed */
+    /* Initialize sufficient stats: with a map, one E-step over evenly
+     * spaced values, a batch at a time; otherwise from the initial
+     * means and variances */
+    if (ss) {
+        size_t step = n / batch_size > 16 ? n / (16 * (size_t)batch_size) : 1;
+        size_t used = 0;
+        for (size_t i = 0; i < n && used < 16 * (size_t)batch_size; ) {
+            int nb = 0;
+            for (; nb < batch_size && i < n; nb++, i += step) batch_x[nb] = data[i];
+            for (int b = 0; b < nb; b++) {
+                double total = 0;
+                for (int j = 0; j < k; j++) {
+                    double lp = df->logpdf ? df->logpdf(batch_x[b], &result->params[j])
+                                           : log(df->pdf(batch_x[b], &result->params[j]) + 1e-300);
+                    double p = result->mixing_weights[j] * exp(lp);
+                    if (p < PDF_FLOOR) p = PDF_FLOOR;
+                    batch_resp[j * nb + b] = p;
+                    total += p;
+                }
+                for (int j = 0; j < k; j++) batch_resp[j * nb + b] /= total;
+            }
+            DistSuffStatsSum(family, batch_x, nb, k, batch_resp, result->params,
+                             NULL, batch_stat);
+            for (int q = 0; q < nstat * k; q++) suf[q] += batch_stat[q];
+            used += nb;
+        }
+        for (int q = 0; q < nstat * k; q++) suf[q] /= (double)used;
+    } else {
+        for (int j = 0; j < k; j++) {
+            suf_w[j] = 1.0 / k;
+            suf_wx[j] = result->params[j].p[0] / k;
+            suf_wxx[j] = (result->params[j].p[0] * result->params[j].p[0] +
+                           (result->params[j].nparams >= 2 ? result->params[j].p[1] : 1.0)) / k;
+        }
+    }
+
+    uint64_t rng_state = ONLINE_SEED;
     double prev_ll = -1e30;
+    int iter0 = 0;
+
+    /* Resume from a checkpoint of the same problem */
+    const char* ckpath = g_online_ckpt_path;
+    uint64_t fingerprint = ckpath ? online_fingerprint(data, n, batch_size) : 0;
+    if (ckpath) {
+        Checkpoint ck;
+        int rc = CheckpointRead(ckpath, &ck);
+        if (rc == 0 && (ck.engine != CKPT_ONLINE || ck.family != (int)family ||
+                        ck.k != k || ck.nparam != ONLINE_CKPT_NPARAM ||
+                        ck.nstat != nstat || ck.total_n != n ||
+                        ck.fingerprint != fingerprint))
+            rc = -1;
+        if (rc == 0) {
+            for (int j = 0; j < k; j++) {
+                const double* q = ck.params + (size_t)j * ONLINE_CKPT_NPARAM;
+                memcpy(result->params[j].p, q, sizeof(double) * DIST_MAX_PARAMS);
+                result->params[j].nparams = (int)q[DIST_MAX_PARAMS];
+                result->mixing_weights[j] = ck.weights[j];
+            }
+            memcpy(suf, ck.stats, sizeof(double) * nstat * k);
+            iter0 = (int)ck.step;
+            rng_state = ck.rng;
+            prev_ll = ck.prev_ll;
+            if (verbose) printf("  [online] resumed from %s at iter %d\n", ckpath, iter0);
+        }
+        CheckpointRelease(&ck);
+        if (rc != 0 && rc != -3) {
+            free(suf); free(batch_resp); free(batch_w); free(batch_x);
+            free(batch_stat); free(batch_idx);
+            free(result->mixing_weights); result->mixing_weights = NULL;
+            free(result->params);         result->params = NULL;
+            free(clean_online);
+            return -1;
+        }
+    }
 
-    for (int iter = 0; iter < maxiter; iter++) {
+    for (int iter = iter0; iter < maxiter; iter++) {
         double eta = pow(iter + 2.0, -0.6);  /* Cappé step size */
 
         /* Sample mini-batch */
         for (int b = 0; b < batch_size; b++) {
             batch_idx[b] = (int)(xorshift64(&rng_state) % n);
+            batch_x[b] = data[batch_idx[b]];
         }
 
         /* E-step on mini-batch */
@@ -3701,54 +4553,46 @@ int UnmixOnline(const double* data, size_t n, DistFamily family, int k,
         ll /= batch_size;
 
         /* Stochastic M-step: update sufficient statistics */
-        for (int j = 0; j < k; j++) {
-            double new_w = 0, new_wx = 0, new_wxx = 0;
-            for (int b = 0; b < batch_size; b++) {
-                double r = batch_resp[j * batch_size + b];
-                double x = data[batch_idx[b]];
-                new_w += r;
-                new_wx += r * x;
-                new_wxx += r * x * x;
+        if (ss) {
+            DistSuffStatsSum(family, batch_x, batch_size, k, batch_resp,
+                             result->params, NULL, batch_stat);
+        } else {
+            for (int j = 0; j < k; j++) {
+                double new_w = 0, new_wx = 0, new_wxx = 0;
+                for (int b = 0; b < batch_size; b++) {
+                    double r = batch_resp[j * batch_size + b];
+                    double x = batch_x[b];
+                    new_w += r;
+                    new_wx += r * x;
+                    new_wxx += r * x * x;
+                }
+                batch_stat[j] = new_w;
+                batch_stat[k + j] = new_wx;
+                batch_stat[2*k + j] = new_wxx;
             }
-            new_w /= batch_size;
-            new_wx /= batch_size;
-            new_wxx /= batch_size;
-
-            /* Blend with running stats */
-            suf_w[j] = (1 - eta) * suf_w[j] + eta * new_w;
-            suf_wx[j] = (1 - eta) * suf_wx[j] + eta * new_wx;
-            suf_wxx[j] = (1 - eta) * suf_wxx[j] + eta * new_wxx;
         }
+        /* Blend with running stats */
+        for (int q = 0; q < nstat * k; q++)
+            suf[q] = (1 - eta) * suf[q] + eta * (batch_stat[q] / batch_size);
 
         /* Reconstruct parameters from sufficient statistics */
         double wsum = 0;
         for (int j = 0; j < k; j++) wsum += suf_w[j];
-        for (int j = 0; j < k; j++) {
+        for (int j = 0; j < k; j++)
             result->mixing_weights[j] = fmax(suf_w[j] / wsum, 1e-10);
-            double mu = suf_wx[j] / fmax(suf_w[j], 1e-10);
-            double var = suf_wxx[j] / fmax(suf_w[j], 1e-10) - mu * mu;
-            if (var < 1e-10) var = 1e-10;
-
-            /* For Gaussian: directly set mean/variance
-             * For others: use sufficient stats as pseudo-data for MLE */
-            if (family == DIST_GAUSSIAN) {
-                result->params[j].p[0] = mu;
-                result->params[j].p[1] = var;
-                result->params[j].nparams = 2;
-            } else {
-                /* General: construct weighted pseudo-data from batch */
+        if (ss) {
+            DistParamsFromStats(family, suf, k, result->params);
+        } else {
+            /* No map: refit on the weighted mini-batch and blend */
+            for (int j = 0; j < k; j++) {
                 for (int b = 0; b < batch_size; b++)
                     batch_w[b] = batch_resp[j * batch_size + b];
-                double* batch_data = (double*)malloc(sizeof(double) * batch_size);
-                for (int b = 0; b < batch_size; b++) batch_data[b] = data[batch_idx[b]];
                 DistParams old = result->params[j];
-                df->estimate(batch_data, batch_w, batch_size, &result->params[j]);
-                /* Blend with previous parameters */
+                df->estimate(batch_x, batch_w, batch_size, &result->params[j]);
                 for (int q = 0; q < result->params[j].nparams; q++) {
                     if (!isfinite(result->params[j].p[q])) result->params[j].p[q] = old.p[q];
                     else result->params[j].p[q] = (1-eta)*old.p[q] + eta*result->params[j].p[q];
                 }
-                free(batch_data);
             }
         }
 
@@ -3758,6 +4602,10 @@ int UnmixOnline(const double* data, size_t n, DistFamily family, int k,
 
         if (iter > 5 && fabs(ll - prev_ll) < rtole) break;
         prev_ll = ll;
+
+        if (ckpath && g_online_ckpt_every > 0 && (iter + 1) % g_online_ckpt_every == 0)
+            online_save(ckpath, family, k, n, fingerprint, iter + 1, rng_state, prev_ll, result,
+                        suf, nstat);
     }
 
     /* Compute final log-likelihood on full data */
@@ -3777,13 +4625,225 @@ int UnmixOnline(const double* data, size_t n, DistFamily family, int k,
     result->bic = -2*ll + nfree * log((double)n);
     result->aic = -2*ll + 2*nfree;
 
-    free(suf_w); free(suf_wx); free(suf_wxx);
-    free(batch_resp); free(batch_w); free(batch_idx);
+    free(suf);
+    free(batch_resp); free(batch_w); free(batch_x); free(batch_stat); free(batch_idx);
     free(clean_online);
     return 0;
 }
 
 
+/* ════════════════════════════════════════════════════════════════════
+ * Incremental EM (Neal & Hinton 1998)
+ *
+ * The data is dealt into B blocks (round-robin over 256-row chunks, so
+ * blocked inputs still give every block a representative mix).  Each
+ * block keeps its own sufficient statistics Sᵦ = Σᵢ∈ᵦ rᵢⱼ·(1, x, x²);
+ * the global S = Σᵦ Sᵦ.  A step redoes the E-step for one block, swaps
+ * its old Sᵦ out of S and the new one in, and runs the closed-form
+ * M-step — so parameters move B times per pass instead of once.  Every
+ * step increases the EM free energy, giving the batch fixed point.
+ *
+ * Only families whose M-step is a function of (N, Σx, Σx²) qualify:
+ * Gaussian, Exponential and Poisson.
+ * ════════════════════════════════════════════════════════════════════ */
+
+#define INCR_CHUNK      256
+#define INCR_NSTAT      3     /* N, Σx, Σx² per component */
+#define INCR_DEF_BLOCKS 32
+
+static int incr_family_ok(DistFamily f) {
+    return f == DIST_GAUSSIAN || f == DIST_EXPONENTIAL || f == DIST_POISSON;
+}
+
+/* M-step from global statistics (x shifted by `shift` for Gaussian) */
+static void incr_mstep(DistFamily family, int k, const double* S, double shift,
+                       MixtureResult* r)
+{
+    double ntot = 0;
+    for (int j = 0; j < k; j++) ntot += S[j * INCR_NSTAT];
+    for (int j = 0; j < k; j++) {
+        const double* sj = &S[j * INCR_NSTAT];
+        double nj = sj[0];
+        r->mixing_weights[j] = fmax(nj / ntot, 1e-10);
+        if (nj < 1e-10) continue;   /* empty: keep previous params */
+        double m = sj[1] / nj;
+        if (family == DIST_GAUSSIAN) {
+            double var = sj[2] / nj - m * m;
+            if (var < 1e-10) var = 1e-10;
+            r->params[j].p[0] = m + shift;
+            r->params[j].p[1] = var;
+        } else if (family == DIST_EXPONENTIAL) {
+            r->params[j].p[0] = 1.0 / fmax(m, 1e-10);
+        } else {
+            r->params[j].p[0] = fmax(m, 1e-10);
+        }
+    }
+    double wsum = 0;
+    for (int j = 0; j < k; j++) wsum += r->mixing_weights[j];
+    for (int j = 0; j < k; j++) r->mixing_weights[j] /= wsum;
+}
+
+int UnmixIncremental(const double* data, size_t n, DistFamily family, int k,
+                     int maxiter, double rtole, int nblocks, int verbose,
+                     MixtureResult* result)
+{
+    if (!data || n == 0 || k <= 0 || !result) return -1;
+    memset(result, 0, sizeof(*result));
+    if (!incr_family_ok(family)) return -2;
+    const DistFunctions* df = GetDistFunctions(family);
+    if (!df) return -2;
+
+    size_t clean_n;
+    double* clean = sanitize_data(data, n, &clean_n);
+    if (!clean || clean_n < (size_t)k) { free(clean); return -1; }
+    data = clean;
+    n = clean_n;
+
+    size_t nchunks = (n + INCR_CHUNK - 1) / INCR_CHUNK;
+    if (nblocks <= 0) nblocks = INCR_DEF_BLOCKS;
+    if ((size_t)nblocks > nchunks) nblocks = (int)nchunks;
+
+    result->family = family;
+    result->num_components = k;
+    result->mixing_weights = (double*)malloc(sizeof(double) * k);
+    result->params = (DistParams*)calloc(k, sizeof(DistParams));
+    double* bstat = (double*)calloc((size_t)nblocks * k * INCR_NSTAT, sizeof(double));
+    double* gstat = (double*)calloc((size_t)k * INCR_NSTAT, sizeof(double));
+    double* nstat = (double*)malloc(sizeof(double) * k * INCR_NSTAT);
+    double* lps   = (double*)malloc(sizeof(double) * k);
+    double* logw  = (double*)malloc(sizeof(double) * k * 4);
+    double* ca = logw + k, *cb = logw + 2 * k, *cm = logw + 3 * k;
+    if (!result->mixing_weights || !result->params || !bstat || !gstat ||
+        !nstat || !lps || !logw) {
+        free(bstat); free(gstat); free(nstat); free(lps); free(logw);
+        ReleaseMixtureResult(result);
+        free(clean);
+        return -3;
+    }
+
+    /* Gaussian statistics are accumulated about the data mean so that
+     * Σx²/N − (Σx/N)² does not cancel for offset data */
+    double shift = 0;
+    if (family == DIST_GAUSSIAN) {
+        for (size_t i = 0; i < n; i++) shift += data[i];
+        shift /= n;
+    }
+
+    df->init_params(data, n, k, result->params);
+    if (family == DIST_GAUSSIAN) {
+        /* gauss_init stashes k-means cluster fractions in p[2] */
+        double wsum = 0;
+        for (int j = 0; j < k; j++) {
+            result->mixing_weights[j] = fmax(result->params[j].p[2], 1e-10);
+            result->params[j].p[2] = 0;
+            wsum += result->mixing_weights[j];
+        }
+        for (int j = 0; j < k; j++) result->mixing_weights[j] /= wsum;
+    } else {
+        for (int j = 0; j < k; j++) result->mixing_weights[j] = 1.0 / k;
+    }
+
+    double prev_ll = -1e30;
+    int epoch;
+    for (epoch = 0; epoch < maxiter; epoch++) {
+        double ll = 0;
+        for (int b = 0; b < nblocks; b++) {
+            /* Gaussian: lp = ca − cb·(x − μ)², constants hoisted per step */
+            for (int j = 0; j < k; j++) {
+                logw[j] = log(result->mixing_weights[j]);
+                if (family == DIST_GAUSSIAN) {
+                    double var = result->params[j].p[1];
+                    ca[j] = logw[j] - 0.5 * log(2 * M_PI * var);
+                    cb[j] = 0.5 / var;
+                    cm[j] = result->params[j].p[0];
+                }
+            }
+            memset(nstat, 0, sizeof(double) * k * INCR_NSTAT);
+
+            /* ---- E-step on block b ---- */
+            for (size_t c = (size_t)b; c < nchunks; c += (size_t)nblocks) {
+                size_t i1 = (c + 1) * INCR_CHUNK < n ? (c + 1) * INCR_CHUNK : n;
+                for (size_t i = c * INCR_CHUNK; i < i1; i++) {
+                    double x = data[i];
+                    double max_lp = -1e300;
+                    if (family == DIST_GAUSSIAN) {
+                        for (int j = 0; j < k; j++) {
+                            double z = x - cm[j];
+                            lps[j] = ca[j] - cb[j] * z * z;
+                            if (lps[j] > max_lp) max_lp = lps[j];
+                        }
+                    } else {
+                        for (int j = 0; j < k; j++) {
+                            lps[j] = logw[j] + (df->logpdf ? df->logpdf(x, &result->params[j])
+                                                : log(df->pdf(x, &result->params[j]) + 1e-300));
+                            if (lps[j] > max_lp) max_lp = lps[j];
+                        }
+                    }
+                    double total = 0;
+                    for (int j = 0; j < k; j++) {
+                        lps[j] = exp(lps[j] - max_lp);
+                        total += lps[j];
+                    }
+                    ll += max_lp + log(total);
+                    double xs = x - shift, inv = 1.0 / total;
+                    for (int j = 0; j < k; j++) {
+                        double rij = lps[j] * inv;
+                        nstat[j * INCR_NSTAT + 0] += rij;
+                        nstat[j * INCR_NSTAT + 1] += rij * xs;
+                        nstat[j * INCR_NSTAT + 2] += rij * xs * xs;
+                    }
+                }
+            }
+
+            /* ---- Swap block statistics, then M-step ---- */
+            double* old = &bstat[(size_t)b * k * INCR_NSTAT];
+            for (int q = 0; q < k * INCR_NSTAT; q++) {
+                gstat[q] += nstat[q] - old[q];
+                old[q] = nstat[q];
+            }
+            incr_mstep(family, k, gstat, shift, result);
+        }
+
+        /* Rebuild S from the blocks once per pass so that rounding from the
+         * running differences cannot accumulate */
+        memset(gstat, 0, sizeof(double) * k * INCR_NSTAT);
+        for (int b = 0; b < nblocks; b++)
+            for (int q = 0; q < k * INCR_NSTAT; q++)
+                gstat[q] += bstat[(size_t)b * k * INCR_NSTAT + q];
+
+        if (verbose)
+            printf("  [%s k=%d incr B=%d] pass %d  LL=%.4f  delta=%.2e\n",
+                   df->name, k, nblocks, epoch, ll, ll - prev_ll);
+        if (epoch > 0 && fabs(ll - prev_ll) < rtole) { epoch++; break; }
+        prev_ll = ll;
+    }
+
+    /* The pass LL mixes parameters from B steps; report the exact LL */
+    double ll = 0;
+    for (size_t i = 0; i < n; i++) {
+        double max_lp = -1e300;
+        for (int j = 0; j < k; j++) {
+            lps[j] = log(result->mixing_weights[j])
+                   + (df->logpdf ? df->logpdf(data[i], &result->params[j])
+                                 : log(df->pdf(data[i], &result->params[j]) + 1e-300));
+            if (lps[j] > max_lp) max_lp = lps[j];
+        }
+        double total = 0;
+        for (int j = 0; j < k; j++) total += exp(lps[j] - max_lp);
+        ll += max_lp + log(total);
+    }
+    result->loglikelihood = ll;
+    result->iterations = epoch;
+    int nfree = df->num_params * k + k - 1;
+    result->bic = -2 * ll + nfree * log((double)n);
+    result->aic = -2 * ll + 2 * nfree;
+
+    free(bstat); free(gstat); free(nstat); free(lps); free(logw);
+    free(clean);
+    return 0;
+}
+
+
 void ReleaseAdaptiveResult(AdaptiveResult* r) {
     if (!r) return;
     if (r->mixing_weights) { free(r->mixing_weights); r->mixing_weights = NULL; }
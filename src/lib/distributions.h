@@ -131,6 +131,54 @@ const DistFunctions* GetDistFunctions(DistFamily family);
  */
 const char* GetDistName(DistFamily family);
 
+/* ====================================================================
+ * Sufficient-statistic M-step for the streaming and online engines
+ * ==================================================================== */
+
+#define DIST_MAX_STATS 4
+
+/* Families whose M-step sees the data only through responsibility-weighted
+ * averages of a few functions T(x): the exponential families, the moment
+ * fits (Beta, Binomial, ...) and Student-t through its ECM statistics.
+ * Streaming engines keep running averages of T per component, so each
+ * chunk updates the parameters in O(k) with no refit on the chunk. */
+typedef struct {
+    int nstats;         /* statistics per value, ≤ DIST_MAX_STATS */
+    int uses_params;    /* T depends on the component (Student-t) */
+    /* T(x) for an in-domain value; p is the component (NULL allowed
+     * unless uses_params) */
+    void (*stats)(double x, const DistParams* p, double* t);
+    /* Parameters from t̄ = Σ r·T(x) / Σ r; out holds the current
+     * parameters on entry (the ECM starting point) */
+    void (*from_stats)(const double* t, DistParams* out);
+} DistSuffStats;
+
+/**
+ * Statistic map for a family.
+ * @return map, or NULL if the family has none (the engines then refit
+ *         each chunk with estimate() and blend)
+ */
+const DistSuffStats* GetDistSuffStats(DistFamily family);
+
+/**
+ * Statistic sums over a block for a family with a map: stat[j] = Σ r_ji
+ * and stat[(1+s)·k + j] = Σ r_ji·T_s(x_i), with resp laid out k × n.
+ * Values outside the family's domain are skipped.
+ *
+ * @param scratch  (nstats+1)·n doubles, or NULL to evaluate T inside the
+ *                 per-component loop
+ */
+void DistSuffStatsSum(DistFamily family, const double* x, size_t n, int k,
+                      const double* resp, const DistParams* params,
+                      double* scratch, double* stat);
+
+/**
+ * M-step from statistic sums (or running averages) in the layout of
+ * DistSuffStatsSum; updates params in place.
+ */
+void DistParamsFromStats(DistFamily family, const double* stat, int k,
+                         DistParams* params);
+
 /**
  * Generic mixture EM: unmix data into k components of the given family.
  *
@@ -148,6 +196,23 @@ int UnmixGeneric(const double* data, size_t n, DistFamily family, int k,
                  int maxiter, double rtole, int verbose,
                  MixtureResult* result);
 
+/**
+ * Number of EM restarts used by UnmixGeneric (default 1).  With R > 1 the
+ * restarts run concurrently (OpenMP) a few iterations at a time; those
+ * trailing the leader's LL by more than a margin are dropped and only the
+ * winner is run to convergence.  Results do not depend on thread count.
+ */
+void SetNumRestarts(int restarts);
+int  GetNumRestarts(void);
+
+/**
+ * Threads used by the OpenMP-parallel engines (0 = the OpenMP default,
+ * OMP_NUM_THREADS or one per core).  Applies to OpenMP regions started
+ * from the calling thread.  GetNumThreads returns the count in effect.
+ */
+void SetNumThreads(int threads);
+int  GetNumThreads(void);
+
 /**
  * Model selection: try all distribution families (or a subset) with
  * component counts from k_min to k_max, return the best by BIC.
@@ -258,18 +323,109 @@ int SpectralInit(const double* data, size_t n, int k,
 
 /**
  * Online/Stochastic EM: mini-batch processing for large datasets.
- * Uses Cappé & Moulines (2009) step-size schedule.
+ * Uses Cappé & Moulines (2009) step-size schedule on running averages of
+ * the family's sufficient statistics (GetDistSuffStats).
  */
 int UnmixOnline(const double* data, size_t n, DistFamily family, int k,
                 int maxiter, double rtole, int batch_size, int verbose,
                 MixtureResult* result);
 
+/**
+ * Checkpointing for UnmixOnline: every `every` iterations (0 = never) the
+ * running sufficient statistics, parameters, iteration count and sampler
+ * state are written to path (checkpoint.h).  If path already holds a
+ * checkpoint for the same family, k, batch size and data (a fingerprint of
+ * every value is stored), UnmixOnline resumes from it and follows the same
+ * trajectory as an uninterrupted run; a checkpoint of another problem is
+ * refused with -1.  path must
+ * stay valid while UnmixOnline runs; NULL turns checkpointing off.
+ */
+void SetOnlineCheckpoint(const char* path, int every);
+
+/**
+ * Incremental EM (Neal & Hinton 1998): B blocks with cached per-block
+ * sufficient statistics; each step redoes one block's E-step, updates the
+ * global statistics by difference and runs the closed-form M-step.
+ * Converges to the same fixed point as batch EM, with much faster early
+ * progress.  Gaussian, Exponential and Poisson only.
+ *
+ * @param maxiter  Maximum passes over the data (each pass = B steps)
+ * @param nblocks  Number of blocks B (0 = default 32)
+ * @return 0 on success, -1 bad args, -2 unsupported family, -3 alloc failure
+ */
+int UnmixIncremental(const double* data, size_t n, DistFamily family, int k,
+                     int maxiter, double rtole, int nblocks, int verbose,
+                     MixtureResult* result);
+
 /**
  * Set global data pointer for KDE distribution (needed for PDF computation).
  * Must be called before using DIST_KDE in any EM function.
  */
 void KDE_SetData(const double* data, size_t n);
 
+/**
+ * Subsampled initialization for very large n.
+ *
+ * When n >= threshold, the k-means++ / furthest-point seeding used by the
+ * Gaussian, multivariate and complex engines runs on a stratified uniform
+ * subsample of InitSubsampleSize(n, k, d) rows instead of all n rows.
+ * EM itself always runs on the full data.  threshold = 0 disables the
+ * subsample stage.  Default: GEMMULEM_INIT_SUBSAMPLE_THRESHOLD.
+ */
+#define GEMMULEM_INIT_SUBSAMPLE_THRESHOLD 1000000
+void   SetInitSubsampleThreshold(size_t threshold);
+size_t GetInitSubsampleThreshold(void);
+
+/**
+ * Number of rows the init stage would sample for (n, k, d), or 0 when the
+ * full data is used.  Grows with k·d, clamped to [4096, 65536].
+ */
+size_t InitSubsampleSize(size_t n, int k, int d);
+
+/**
+ * Draw the init subsample: one row per stratum of n/m consecutive rows,
+ * deterministic in (n, k, d).  Each drawn row stands for n/m rows, so
+ * cluster fractions computed on the sample estimate full-data fractions.
+ *
+ * @param data  Row-major data, d doubles per row
+ * @param out   Output: malloc'd buffer of m·d doubles (caller frees)
+ * @return m, or 0 if subsampling does not apply (or allocation failed)
+ */
+size_t InitSubsample(const double* data, size_t n, int d, int k, double** out);
+
+/**
+ * Coarse-to-fine multiresolution EM.
+ *
+ * With levels = L > 1, UnmixGeneric and UnmixMVGaussian first fit on
+ * nested random subsamples of n/10^(L-1), …, n/10 rows, carrying the
+ * parameters forward, and finish on the full data.  Every level stops when
+ * its LL changes by less than rtole; on m rows that is a per-row tolerance
+ * n/m times looser than the full fit's, tightening tenfold per level.  A
+ * level that fails falls back to the full-data fit.
+ * Levels smaller than max(2000, 100·k·d) rows are skipped.  L = 1 (the
+ * default) disables the schedule.
+ */
+#define GEMMULEM_MULTIRES_MAX_LEVELS 6
+void SetMultiresLevels(int levels);
+int  GetMultiresLevels(void);
+
+/**
+ * Subsample sizes for the coarse levels of the current schedule, smallest
+ * first (sizes must hold GEMMULEM_MULTIRES_MAX_LEVELS entries).
+ * @return number of coarse levels (0 = fit the full data directly)
+ */
+int MultiresSchedule(size_t n, int k, int d, size_t* sizes);
+
+/**
+ * Draw a subsample of about m rows: row i is kept iff a hash of i falls
+ * below m/n, so samples for increasing m are nested and independent of
+ * the row order.
+ *
+ * @param out  Output: malloc'd buffer of rows (caller frees)
+ * @return number of rows drawn, or 0 on allocation failure
+ */
+size_t MultiresSubsample(const double* data, size_t n, int d, size_t m, double** out);
+
 /**
  * Release memory.
  */
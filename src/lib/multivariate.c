@@ -9,8 +9,15 @@
 #include <string.h>
 #include <math.h>
 #include <float.h>
+#ifdef _OPENMP
+#include <omp.h>
+#endif
 
 #include "multivariate.h"
+#include "distributions.h"
+#include "simd_mv.h"
+#include "accel.h"
+#include "walltime.h"
 
 #ifndef M_PI
 #define M_PI 3.14159265358979323846
@@ -18,6 +25,11 @@
 
 #define MV_PDF_FLOOR 1e-300
 #define MV_COV_REG   1e-6    /* Regularization added to diagonal */
+#define MV_STACK_DIM 64      /* mahalanobis_sq() keeps y on the stack up to this d */
+#define MV_TILE_DOUBLES 4096 /* E-step tile: d × B doubles, 32 KB, stays in L1/L2 */
+#define MV_PAR_ROWS   2048        /* rows per parallel block, at least */
+#define MV_PAR_BLOCKS 256         /* ... and at most this many blocks */
+#define MV_PAR_BYTES  (64u << 20) /* cap on the blocks' M-step partials */
 
 /* ════════════════════════════════════════════════════════════════════
  * Linear algebra helpers (no LAPACK dependency)
@@ -52,30 +64,108 @@ static double log_det_cholesky(const double* L, int d) {
     return 2.0 * ld;
 }
 
-/* Solve L*y = b (forward substitution, L lower triangular) */
-static void solve_lower(const double* L, int d, const double* b, double* y) {
+/* Compute (x-μ)^T Σ^{-1} (x-μ) using Cholesky factor: forward substitution
+ * on x-μ in one sweep, with y on the stack unless d > MV_STACK_DIM */
+static double mahalanobis_sq(const double* x, const double* mean,
+                              const double* L_chol, int d) {
+    double buf[MV_STACK_DIM];
+    double* y = d <= MV_STACK_DIM ? buf : (double*)malloc(sizeof(double) * d);
+    if (!y) return HUGE_VAL;
+
+    double mah = 0;
     for (int i = 0; i < d; i++) {
-        double s = b[i];
-        for (int j = 0; j < i; j++) s -= L[i*d+j] * y[j];
-        y[i] = s / L[i*d+i];
+        const double* Li = L_chol + (size_t)i * d;
+        double s = x[i] - mean[i];
+        for (int j = 0; j < i; j++) s -= Li[j] * y[j];
+        y[i] = s / Li[i];
+        mah += y[i] * y[i];
     }
+
+    if (y != buf) free(y);
+    return mah;
 }
 
-/* Compute (x-μ)^T Σ^{-1} (x-μ) using Cholesky factor */
-static double mahalanobis_sq(const double* x, const double* mean,
-                              const double* L_chol, int d) {
-    double* diff = (double*)malloc(sizeof(double) * d);
-    double* y = (double*)malloc(sizeof(double) * d);
+/* Points per E-step tile: the d × B transposed tile fits MV_TILE_DOUBLES,
+ * B a multiple of 8 in [8, 256] */
+static int mv_tile_points(int d) {
+    int b = MV_TILE_DOUBLES / (d > 0 ? d : 1) / 8 * 8;
+    return b < 8 ? 8 : b > 256 ? 256 : b;
+}
 
-    for (int i = 0; i < d; i++) diff[i] = x[i] - mean[i];
-    solve_lower(L_chol, d, diff, y);
+/* Squared Mahalanobis distances of the nb ≤ B rows of X from one
+ * component.  The centred tile is held transposed, Y = (X − μ)ᵀ as d × B
+ * with the points along the unit stride, and L·Y = (X − μ)ᵀ is solved row
+ * by row for the whole tile, so every inner loop is a vectorizable axpy
+ * over points and L is read once per tile instead of once per point.
+ * Same operations in the same order as mahalanobis_sq(). */
+static void mv_tile_mahalanobis(const double* X, int nb, int d, const double* mean,
+                                const double* L, int B, double* Y, double* mah) {
+    for (int a = 0; a < d; a++) {
+        double* ya = Y + (size_t)a * B;
+        double ma = mean[a];
+        for (int b = 0; b < nb; b++) ya[b] = X[(size_t)b * d + a] - ma;
+    }
+    for (int b = 0; b < nb; b++) mah[b] = 0;
+    for (int a = 0; a < d; a++) {
+        double* ya = Y + (size_t)a * B;
+        const double* La = L + (size_t)a * d;
+        for (int c = 0; c < a; c++) {
+            const double lac = La[c];
+            const double* yc = Y + (size_t)c * B;
+            #ifdef _OPENMP
+            #pragma omp simd
+            #endif
+            for (int b = 0; b < nb; b++) ya[b] -= lac * yc[b];
+        }
+        const double laa = La[a];
+        #ifdef _OPENMP
+        #pragma omp simd
+        #endif
+        for (int b = 0; b < nb; b++) {
+            ya[b] /= laa;
+            mah[b] += ya[b] * ya[b];
+        }
+    }
+}
 
-    double mah = 0;
-    for (int i = 0; i < d; i++) mah += y[i] * y[i];
+/* Scratch doubles for mv_gauss_estep(): one tile transposed, plus k × B
+ * log-densities */
+static size_t mv_estep_scratch(int d, int k) {
+    return (size_t)mv_tile_points(d) * ((size_t)d + (size_t)k);
+}
 
-    free(diff);
-    free(y);
-    return mah;
+/* Scratch doubles for mv_scatter_full(): one scaled tile (d × B) */
+static size_t mv_scatter_scratch(int d) {
+    return (size_t)mv_tile_points(d) * (size_t)d;
+}
+
+/* Weighted centred scatter of the m rows of X for all k components:
+ * S_j += Σ_i w_ij (x_i − μ_j)(x_i − μ_j)ᵀ, upper triangle of each d × d
+ * S_j (S is k × d × d), with w_ij = resp[i·k+j] · u[i·k+j] (u may be NULL).
+ * Rows go B at a time, so the tile stays in cache across all components.
+ * For each component the tile is centred and scaled by √w into Z (B × d),
+ * and S_j += Zᵀ·Z runs as a register-blocked SYRK (simd_mv_syrk). */
+static void mv_scatter_full(const double* X, size_t m, int d, int k,
+                            const double* resp, const double* u,
+                            const double* mu, double* S, double* Z) {
+    int B = mv_tile_points(d);
+    for (size_t i0 = 0; i0 < m; i0 += (size_t)B) {
+        int nb = (int)(m - i0 < (size_t)B ? m - i0 : (size_t)B);
+        const double* Xt = X + i0 * d;
+        for (int j = 0; j < k; j++) {
+            const double* mj = mu + (size_t)j * d;
+            double* Sj = S + (size_t)j * d * d;
+            for (int t = 0; t < nb; t++) {
+                size_t q = (i0 + t) * k + j;
+                double w = u ? resp[q] * u[q] : resp[q];
+                double sw = sqrt(w > 0 ? w : 0);
+                const double* xt = Xt + (size_t)t * d;
+                double* zt = Z + (size_t)t * d;
+                for (int a = 0; a < d; a++) zt[a] = sw * (xt[a] - mj[a]);
+            }
+            simd_mv_syrk(Z, nb, d, Sj);
+        }
+    }
 }
 
 
@@ -93,6 +183,260 @@ double mvgauss_pdf(const double* x, const MVGaussParams* p) {
     return exp(lp);
 }
 
+/* Packed diagonal/spherical parameters for mv_gauss_estep(): means (k × d),
+ * inverse variances (k × d), the per-component constant
+ * log w_j − ½(d log 2π + log|Σ_j|) (k), and the common inverse variance
+ * when all d are equal, else 0 (k).  A spherical model starts from the
+ * per-dimension data variances, so the first E-step is not spherical. */
+static size_t mv_diag_len(int d, int k) {
+    return (size_t)k * (2 * (size_t)d + 2);
+}
+
+/* Component j of the packed parameters: mean, inverse variances, and the
+ * common inverse variance when all d are equal (else 0) */
+static void mv_diag_pack_comp(int d, int k, int j, const double* mean,
+                              const double* cov, double* dg) {
+    double* ivj = dg + (size_t)k * d + (size_t)j * d;
+    double* sph = dg + 2 * (size_t)k * d + k;
+    memcpy(dg + (size_t)j * d, mean, sizeof(double) * d);
+    sph[j] = 1.0 / (cov[0] + MV_COV_REG);
+    for (int a = 0; a < d; a++) {
+        ivj[a] = 1.0 / (cov[a*d+a] + MV_COV_REG);
+        if (ivj[a] != sph[j]) sph[j] = 0;
+    }
+}
+
+static void mv_diag_pack(const MVMixtureResult* r, double* dg) {
+    int d = r->dim, k = r->num_components;
+    double* base = dg + 2 * (size_t)k * d;
+    for (int j = 0; j < k; j++) {
+        const MVGaussParams* c = &r->components[j];
+        mv_diag_pack_comp(d, k, j, c->mean, c->cov, dg);
+        base[j] = log(r->mixing_weights[j]) - 0.5 * (d * log(2 * M_PI) + c->log_det);
+    }
+}
+
+/* Copy a tile of nb rows into Y transposed (d × B), for the diagonal kernels */
+static void mv_tile_transpose(const double* Xt, int nb, int d, int B, double* Y) {
+    for (int a = 0; a < d; a++) {
+        double* ya = Y + (size_t)a * B;
+        for (int b = 0; b < nb; b++) ya[b] = Xt[(size_t)b * d + a];
+    }
+}
+
+/* Squared Mahalanobis distances of the nb rows of the tile Xt from
+ * component j.  With dg (diagonal and spherical covariances) Y already
+ * holds the transposed tile and the distance is a weighted sum of squares;
+ * otherwise L is the Cholesky factor, solved by the fixed-d kernel or by
+ * mv_tile_mahalanobis() with Y as scratch. */
+static void mv_tile_distance(const double* Xt, int nb, int d, int k, int B, int j,
+                             const double* dg, const double* mean, const double* L,
+                             double* Y, double* mah) {
+    if (dg) {
+        const double* ivj = dg + (size_t)k * d + (size_t)j * d;
+        double sph = dg[2 * (size_t)k * d + k + j];
+        if (sph > 0) simd_mv_sph_mahalanobis(Y, B, nb, d, dg + (size_t)j * d, sph, mah);
+        else simd_mv_diag_mahalanobis(Y, B, nb, d, dg + (size_t)j * d, ivj, mah);
+    } else if (simd_mv_fixed_dim(d)) {
+        simd_mv_mahalanobis_fixed(Xt, nb, d, mean, L, mah);
+    } else {
+        mv_tile_mahalanobis(Xt, nb, d, mean, L, B, Y, mah);
+    }
+}
+
+/* Packed COV_LOWRANK parameters (mv_lr_pack), per component:
+ * mean d | Ψ⁻¹ d | G = Ψ⁻¹W d × q | L_M q × q | M⁻¹ q × q | G·M⁻¹ d × q | base,
+ * with M = I + WᵀΨ⁻¹W and L_M its Cholesky factor */
+static size_t mv_lr_stride(int d, int q) {
+    return 2 * (size_t)d + 2 * (size_t)d * q + 2 * (size_t)q * q + 1;
+}
+
+/* Woodbury: δ² = x̃ᵀΨ⁻¹x̃ − vᵀM⁻¹v with x̃ = x − μ and v = Gᵀx̃, so
+ * δ² = x̃ᵀΨ⁻¹x̃ − ‖L_M⁻¹v‖², O(dq) per point.  v holds q doubles. */
+static void mv_lr_distance(const double* Xt, int nb, int d, int q,
+                           const double* pj, double* v, double* mah) {
+    const double* mean = pj;
+    const double* ipsi = pj + d;
+    const double* G = pj + 2 * (size_t)d;
+    const double* LM = G + (size_t)d * q;
+    for (int b = 0; b < nb; b++) {
+        const double* x = Xt + (size_t)b * d;
+        double s = 0;
+        for (int c = 0; c < q; c++) v[c] = 0;
+        for (int a = 0; a < d; a++) {
+            double z = x[a] - mean[a];
+            const double* Ga = G + (size_t)a * q;
+            s += z * z * ipsi[a];
+            #ifdef _OPENMP
+            #pragma omp simd
+            #endif
+            for (int c = 0; c < q; c++) v[c] += z * Ga[c];
+        }
+        for (int c = 0; c < q; c++) {
+            const double* Lc = LM + (size_t)c * q;
+            double t = v[c];
+            for (int e = 0; e < c; e++) t -= Lc[e] * v[e];
+            v[c] = t / Lc[c];
+            s -= v[c] * v[c];
+        }
+        mah[b] = s > 0 ? s : 0;
+    }
+}
+
+/* Blocked E-step over the m rows of X: responsibilities into resp (m × k,
+ * row-major), returns their log-likelihood.  Tiles of B points go through
+ * mv_tile_distance() for each component, then a log-sum-exp per point;
+ * scratch holds mv_estep_scratch(d, k) doubles, so nothing is allocated.
+ * With dg (mv_diag_pack(), diagonal and spherical covariances) the tile is
+ * transposed once for all components and there is no triangular solve;
+ * for COV_LOWRANK dg is mv_lr_pack() and distances use mv_lr_distance();
+ * for COV_TIED dg is mv_tied_pack(): the tile is whitened once about the
+ * data mean, Y = L⁻¹(X − x̄)ᵀ, and each component costs one inner product
+ * per point against its whitened mean, ‖y − m_j‖² = ‖y‖² − 2m_j·y + ‖m_j‖². */
+static double mv_gauss_estep(const double* X, size_t m, int d, int k,
+                             const MVMixtureResult* r, const double* dg,
+                             double* resp, double* scratch) {
+    int B = mv_tile_points(d);
+    double* Y = scratch;
+    double* lp = scratch + (size_t)B * d;     /* k × B */
+    double ll = 0;
+    for (size_t i0 = 0; i0 < m; i0 += (size_t)B) {
+        int nb = (int)(m - i0 < (size_t)B ? m - i0 : (size_t)B);
+        const double* Xt = X + i0 * d;
+        if (r->cov_type == COV_TIED) {
+            const double* base = dg + (size_t)k * d;
+            /* ‖y‖² lands in row 0 of lp, which is rewritten last */
+            mv_tile_mahalanobis(Xt, nb, d, base + k, r->components[0].cov_chol, B, Y, lp);
+            for (int j = k - 1; j >= 0; j--) {
+                const double* mj = dg + (size_t)j * d;
+                double* lpj = lp + (size_t)j * B;
+                for (int b = 0; b < nb; b++) lpj[b] = base[j] - 0.5 * lp[b];
+                for (int a = 0; a < d; a++) {
+                    const double* ya = Y + (size_t)a * B;
+                    const double ma = mj[a];
+                    #ifdef _OPENMP
+                    #pragma omp simd
+                    #endif
+                    for (int b = 0; b < nb; b++) lpj[b] += ma * ya[b];
+                }
+            }
+        } else if (r->cov_type == COV_LOWRANK) {
+            int q = r->components[0].rank;
+            size_t stride = mv_lr_stride(d, q);
+            for (int j = 0; j < k; j++) {
+                const double* pj = dg + (size_t)j * stride;
+                double* lpj = lp + (size_t)j * B;
+                double base = pj[stride - 1];
+                mv_lr_distance(Xt, nb, d, q, pj, Y, lpj);
+                for (int b = 0; b < nb; b++) lpj[b] = base - 0.5 * lpj[b];
+            }
+        } else {
+            if (dg) mv_tile_transpose(Xt, nb, d, B, Y);
+            for (int j = 0; j < k; j++) {
+                const MVGaussParams* c = &r->components[j];
+                double* lpj = lp + (size_t)j * B;
+                double base = dg ? dg[2 * (size_t)k * d + j]
+                            : log(r->mixing_weights[j]) - 0.5 * (d * log(2 * M_PI) + c->log_det);
+                mv_tile_distance(Xt, nb, d, k, B, j, dg, c->mean, c->cov_chol, Y, lpj);
+                for (int b = 0; b < nb; b++) lpj[b] = base - 0.5 * lpj[b];
+            }
+        }
+        for (int b = 0; b < nb; b++) {
+            double* ri = resp + (i0 + b) * k;
+            double max_lp = -1e300;
+            for (int j = 0; j < k; j++)
+                if (lp[(size_t)j * B + b] > max_lp) max_lp = lp[(size_t)j * B + b];
+            double total = 0;
+            for (int j = 0; j < k; j++) {
+                ri[j] = exp(lp[(size_t)j * B + b] - max_lp);
+                total += ri[j];
+            }
+            for (int j = 0; j < k; j++) ri[j] /= total;
+            ll += max_lp + log(total);
+        }
+    }
+    return ll;
+}
+
+
+/* ════════════════════════════════════════════════════════════════════
+ * Parallel row blocks for the batch engines
+ *
+ * The rows are cut into blocks whose number depends only on n and the
+ * partial size, never on the thread count.  Blocks run concurrently
+ * (OpenMP); each M-step sum is accumulated per block and the blocks are
+ * merged in order, as is the LL, so a fit gives the same result for any
+ * number of threads (SetNumThreads).
+ * ════════════════════════════════════════════════════════════════════ */
+
+typedef struct {
+    size_t  nblk, rows;    /* blocks; rows per block (the last may be short) */
+    int     nthreads;
+    size_t  scr_len;       /* scratch doubles per thread */
+    size_t  part_len;      /* partial-sum doubles per block */
+    double* scratch;       /* nthreads × scr_len */
+    double* part;          /* nblk × part_len */
+    double* sum;           /* part_len: the merged partials */
+    double* bll;           /* nblk block log-likelihoods */
+} MVPar;
+
+static void mv_par_free(MVPar* p) {
+    free(p->scratch); free(p->part); free(p->sum); free(p->bll);
+    p->scratch = p->part = p->sum = p->bll = NULL;
+}
+
+/* @return 0, or -3 on allocation failure */
+static int mv_par_init(MVPar* p, size_t n, size_t scr_len, size_t part_len) {
+    memset(p, 0, sizeof(*p));
+    size_t rows = (n + MV_PAR_BLOCKS - 1) / MV_PAR_BLOCKS;
+    if (rows < MV_PAR_ROWS) rows = MV_PAR_ROWS;
+    while ((n + rows - 1) / rows > 1 &&
+           (n + rows - 1) / rows * part_len * sizeof(double) > MV_PAR_BYTES)
+        rows *= 2;
+    p->rows = rows;
+    p->nblk = (n + rows - 1) / rows;
+    int nt = 1;
+#ifdef _OPENMP
+    nt = omp_get_max_threads();
+#endif
+    if ((size_t)nt > p->nblk) nt = (int)p->nblk;
+    p->nthreads = nt > 1 ? nt : 1;
+    p->scr_len = scr_len;
+    p->part_len = part_len;
+    p->scratch = (double*)malloc(sizeof(double) * scr_len * p->nthreads);
+    p->part = (double*)malloc(sizeof(double) * part_len * p->nblk);
+    p->sum = (double*)malloc(sizeof(double) * part_len);
+    p->bll = (double*)malloc(sizeof(double) * p->nblk);
+    if (!p->scratch || !p->part || !p->sum || !p->bll) {
+        mv_par_free(p);
+        return -3;
+    }
+    return 0;
+}
+
+static double* mv_par_scratch(const MVPar* p) {
+#ifdef _OPENMP
+    return p->scratch + (size_t)omp_get_thread_num() * p->scr_len;
+#else
+    return p->scratch;
+#endif
+}
+
+/* The first len doubles of every block's partial, summed in block order */
+static void mv_par_merge(MVPar* p, size_t len) {
+    memset(p->sum, 0, sizeof(double) * len);
+    for (size_t b = 0; b < p->nblk; b++) {
+        const double* q = p->part + b * p->part_len;
+        for (size_t i = 0; i < len; i++) p->sum[i] += q[i];
+    }
+}
+
+static double mv_par_ll(const MVPar* p) {
+    double ll = 0;
+    for (size_t b = 0; b < p->nblk; b++) ll += p->bll[b];
+    return ll;
+}
+
 
 /* ════════════════════════════════════════════════════════════════════
  * Allocation helpers
@@ -104,249 +448,1440 @@ static void alloc_mvparams(MVGaussParams* p, int d) {
     p->cov = (double*)calloc(d * d, sizeof(double));
     p->cov_chol = (double*)calloc(d * d, sizeof(double));
     p->log_det = 0;
+    p->rank = 0;
+    p->loadings = p->psi = NULL;
+}
+
+static void free_mvparams(MVGaussParams* p) {
+    free(p->mean); free(p->cov); free(p->cov_chol);
+    free(p->loadings); free(p->psi);
+    p->mean = p->cov = p->cov_chol = NULL;
+    p->loadings = p->psi = NULL;
+}
+
+static int update_cholesky(MVGaussParams* p) {
+    int d = p->dim;
+    /* Add regularization to diagonal */
+    for (int i = 0; i < d; i++)
+        p->cov[i*d+i] += MV_COV_REG;
+
+    int rc = cholesky(p->cov, d, p->cov_chol);
+    if (rc != 0) return -1;
+    p->log_det = log_det_cholesky(p->cov_chol, d);
+
+    /* Remove regularization from stored cov */
+    for (int i = 0; i < d; i++)
+        p->cov[i*d+i] -= MV_COV_REG;
+    return 0;
+}
+
+
+/* Diagonal and spherical covariances: the Cholesky factor is the square
+ * root of the (regularized) diagonal, so skip the O(d³) factorization.
+ * Only the diagonals of cov and cov_chol are written; the rest stay zero. */
+static int update_diagonal(MVGaussParams* p) {
+    int d = p->dim;
+    double ld = 0;
+    for (int i = 0; i < d; i++) {
+        double v = p->cov[i*d+i] + MV_COV_REG;
+        if (v <= 0) return -1;
+        p->cov_chol[i*d+i] = sqrt(v);
+        ld += log(v);
+    }
+    p->log_det = ld;
+    return 0;
+}
+
+
+/* ════════════════════════════════════════════════════════════════════
+ * Low-rank-plus-diagonal covariance (COV_LOWRANK)
+ *
+ * Σ_j = W_j W_jᵀ + Ψ_j with W_j d × q: a mixture of factor analyzers
+ * (Ghahramani & Hinton 1996).  The E-step never forms Σ_j; with
+ * M = I + WᵀΨ⁻¹W (q × q) the Woodbury identity gives the distance and
+ * the determinant lemma log|Σ| = log|M| + Σ log ψ_a.  The M-step is the
+ * exact EM step of the factor model, taking the labels and z as missing
+ * data at the E-step parameters: with x̃ = x − μ_old,
+ * E[z|x] = M⁻¹Gᵀx̃ and E[zzᵀ|x] = M⁻¹ + E[z]E[z]ᵀ, μ and W are solved
+ * jointly through the augmented latent ẑ = [z; 1]:
+ *   [W b] ← [A  Σ r x̃] (Σ r E[ẑẑᵀ])⁻¹,  A = Σ r x̃ E[z]ᵀ,  μ ← μ_old + b
+ *   ψ_a ← (Σ r x̃_a² − ([W b] [A  Σ r x̃]ᵀ)_aa) / N
+ * so the LL never decreases.  Every pass over the data is O(n·d·q) per
+ * component.
+ * ════════════════════════════════════════════════════════════════════ */
+
+static int g_lowrank_dim = 0;   /* 0: ⌈√d⌉ */
+
+void SetLowRankDim(int q) { g_lowrank_dim = q > 0 ? q : 0; }
+int  GetLowRankDim(void) { return g_lowrank_dim; }
+
+static int mv_lowrank_q(int d) {
+    int q = g_lowrank_dim > 0 ? g_lowrank_dim : (int)ceil(sqrt((double)d));
+    if (q > d - 1) q = d - 1;
+    return q < 1 ? 1 : q;
+}
+
+/* In-place inverse of the SPD q × q matrix with Cholesky factor L */
+static void chol_inverse(const double* L, int q, double* inv) {
+    for (int col = 0; col < q; col++) {
+        double* x = inv + (size_t)col * q;   /* column col, stored as row */
+        for (int c = 0; c < q; c++) {
+            double t = c == col ? 1.0 : 0.0;
+            for (int e = 0; e < c; e++) t -= L[c*q+e] * x[e];
+            x[c] = t / L[c*q+c];
+        }
+        for (int c = q - 1; c >= 0; c--) {
+            double t = x[c];
+            for (int e = c + 1; e < q; e++) t -= L[e*q+c] * x[e];
+            x[c] = t / L[c*q+c];
+        }
+    }
+}
+
+/* Pack the E-step/M-step constants (layout: mv_lr_stride) from W, Ψ and
+ * the current weights; also sets each component's log_det */
+static void mv_lr_pack(MVMixtureResult* r, double* lr) {
+    int d = r->dim, k = r->num_components, q = r->components[0].rank;
+    size_t stride = mv_lr_stride(d, q);
+    for (int j = 0; j < k; j++) {
+        MVGaussParams* c = &r->components[j];
+        double* pj = lr + (size_t)j * stride;
+        double* ipsi = pj + d;
+        double* G = pj + 2 * (size_t)d;
+        double* LM = G + (size_t)d * q;
+        double* Minv = LM + (size_t)q * q;
+        double* Bt = Minv + (size_t)q * q;
+        memcpy(pj, c->mean, sizeof(double) * d);
+        double ld = 0;
+        for (int a = 0; a < d; a++) {
+            double v = c->psi[a] + MV_COV_REG;
+            ipsi[a] = 1.0 / v;
+            ld += log(v);
+            for (int e = 0; e < q; e++) G[a*q+e] = ipsi[a] * c->loadings[a*q+e];
+        }
+        /* M = I + WᵀG, built in Minv's slot, then factored into LM */
+        memset(Minv, 0, sizeof(double) * q * q);
+        for (int a = 0; a < d; a++) {
+            const double* Wa = c->loadings + (size_t)a * q;
+            const double* Ga = G + (size_t)a * q;
+            for (int e = 0; e < q; e++)
+                for (int f = 0; f < q; f++) Minv[e*q+f] += Wa[e] * Ga[f];
+        }
+        for (int e = 0; e < q; e++) Minv[e*q+e] += 1.0;
+        cholesky(Minv, q, LM);   /* I + PSD: always succeeds */
+        ld += log_det_cholesky(LM, q);
+        chol_inverse(LM, q, Minv);
+        for (int a = 0; a < d; a++)
+            for (int f = 0; f < q; f++) {
+                double t = 0;
+                for (int e = 0; e < q; e++) t += G[a*q+e] * Minv[e*q+f];
+                Bt[a*q+f] = t;
+            }
+        c->log_det = ld;
+        pj[stride - 1] = log(r->mixing_weights[j]) - 0.5 * (d * log(2 * M_PI) + ld);
+    }
+}
+
+/* Per component j, at S + j·(dq + q² + d + q): A = Σ r x̃ E[z]ᵀ (d × q),
+ * Σ r E[z]E[z]ᵀ (q × q), Σ r x̃² (d) and Σ r E[z] (q), with x̃ = x − μ_j
+ * about the E-step mean packed in lr.  z holds d + q doubles. */
+static void mv_lr_scatter(const double* X, size_t m, int d, int k, int q,
+                          const double* resp, const double* lr,
+                          double* S, double* z) {
+    size_t stride = mv_lr_stride(d, q);
+    size_t clen = (size_t)d * q + (size_t)q * q + d + q;
+    double* ez = z + d;
+    for (size_t i = 0; i < m; i++) {
+        const double* x = X + i * d;
+        for (int j = 0; j < k; j++) {
+            double r = resp[i * k + j];
+            if (r == 0) continue;
+            const double* mj = lr + (size_t)j * stride;
+            const double* Bt = mj + 2 * (size_t)d + (size_t)d * q + 2 * (size_t)q * q;
+            double* A = S + (size_t)j * clen;
+            double* Bq = A + (size_t)d * q;
+            double* D = Bq + (size_t)q * q;
+            double* sz = D + d;
+            for (int c = 0; c < q; c++) ez[c] = 0;
+            for (int a = 0; a < d; a++) {
+                z[a] = x[a] - mj[a];
+                const double* Ba = Bt + (size_t)a * q;
+                #ifdef _OPENMP
+                #pragma omp simd
+                #endif
+                for (int c = 0; c < q; c++) ez[c] += z[a] * Ba[c];
+            }
+            for (int a = 0; a < d; a++) {
+                double rz = r * z[a];
+                double* Aa = A + (size_t)a * q;
+                #ifdef _OPENMP
+                #pragma omp simd
+                #endif
+                for (int c = 0; c < q; c++) Aa[c] += rz * ez[c];
+                D[a] += rz * z[a];
+            }
+            for (int c = 0; c < q; c++) {
+                double rc = r * ez[c];
+                for (int e = 0; e < q; e++) Bq[c*q+e] += rc * ez[e];
+                sz[c] += rc;
+            }
+        }
+    }
+}
+
+/* μ, W and Ψ of one component from its merged statistics S
+ * (mv_lr_scatter) and its E-step pack pj (mean μ₀, M⁻¹).  c->mean holds
+ * the weighted mean, so Σ r x̃ = N(mean − μ₀).  With ẑ = [z; 1] and
+ * x̃ = [W b]ẑ + ε the update is one EM step of the factor model:
+ *   [W b] = [A  Σ r x̃] C⁻¹,  C = [N·M⁻¹ + Σ r E[z]E[z]ᵀ  Σ r E[z]; ·  N],
+ * μ = μ₀ + b.  w holds 2(q+1)² + q + 1 doubles. */
+static void mv_lr_update(MVGaussParams* c, double nj, const double* S,
+                         const double* pj, double* w) {
+    int d = c->dim, q = c->rank, p = q + 1;
+    const double* mu0 = pj;
+    const double* Minv = pj + 2 * (size_t)d + (size_t)d * q + (size_t)q * q;
+    const double* A = S;
+    const double* Bq = A + (size_t)d * q;
+    const double* D = Bq + (size_t)q * q;
+    const double* sz = D + d;
+    double* C = w;
+    double* LC = w + (size_t)p * p;
+    double* t = LC + (size_t)p * p;
+    for (int e = 0; e < q; e++) {
+        for (int f = 0; f < q; f++) C[e*p+f] = nj * Minv[e*q+f] + Bq[e*q+f];
+        C[e*p+q] = C[q*p+e] = sz[e];
+    }
+    C[q*p+q] = nj;
+    if (cholesky(C, p, LC) != 0) return;   /* keep W and Ψ; μ is the weighted mean */
+    for (int a = 0; a < d; a++) {
+        const double* Aa = A + (size_t)a * q;
+        double ta = nj * (c->mean[a] - mu0[a]);   /* Σ r x̃_a */
+        double* Wa = c->loadings + (size_t)a * q;
+        /* Solve C·w̃ᵀ = [A_a ta]ᵀ: forward then back substitution */
+        for (int e = 0; e < p; e++) {
+            double s = e < q ? Aa[e] : ta;
+            for (int f = 0; f < e; f++) s -= LC[e*p+f] * t[f];
+            t[e] = s / LC[e*p+e];
+        }
+        for (int e = p - 1; e >= 0; e--) {
+            double s = t[e];
+            for (int f = e + 1; f < p; f++) s -= LC[f*p+e] * t[f];
+            t[e] = s / LC[e*p+e];
+        }
+        double wa = t[q] * ta;
+        for (int e = 0; e < q; e++) {
+            Wa[e] = t[e];
+            wa += t[e] * Aa[e];
+        }
+        c->mean[a] = mu0[a] + t[q];
+        double v = (D[a] - wa) / nj;
+        c->psi[a] = v > 0 ? v : 0;
+    }
+}
+
+/* cov = WWᵀ + Ψ and its Cholesky factor, for callers of the result */
+static void mv_lr_finish(MVMixtureResult* r) {
+    int d = r->dim;
+    for (int j = 0; j < r->num_components; j++) {
+        MVGaussParams* c = &r->components[j];
+        int q = c->rank;
+        for (int a = 0; a < d; a++)
+            for (int b = a; b < d; b++) {
+                double v = a == b ? c->psi[a] : 0;
+                for (int e = 0; e < q; e++) v += c->loadings[a*q+e] * c->loadings[b*q+e];
+                c->cov[a*d+b] = c->cov[b*d+a] = v;
+            }
+        update_cholesky(c);
+    }
+}
+
+
+/* ════════════════════════════════════════════════════════════════════
+ * Tied covariance (COV_TIED)
+ *
+ * One Σ = LLᵀ for all components: one factorization per iteration, and
+ * the E-step whitens each point once (mv_gauss_estep).  The M-step needs
+ * no second pass over the data: with Σ_j r_ij = 1 the pooled
+ * within-component scatter is the total scatter about the data mean x̄,
+ * fixed for the fit, less the between-component scatter,
+ *   nΣ = T − Σ_j N_j (μ_j − x̄)(μ_j − x̄)ᵀ,  T = Σ_i (x_i − x̄)(x_i − x̄)ᵀ.
+ * ════════════════════════════════════════════════════════════════════ */
+
+/* Packed E-step constants: whitened means m_j = L⁻¹(μ_j − x̄) (k × d) |
+ * base_j with −½‖m_j‖² folded in (k) | x̄ (d), the centre of the whitened
+ * tile.  Centring keeps ‖y‖² − 2m_j·y + ‖m_j‖² from cancelling when the
+ * data sit far from the origin. */
+static void mv_tied_pack(const MVMixtureResult* r, const double* xbar, double* dg) {
+    int d = r->dim, k = r->num_components;
+    const MVGaussParams* c0 = &r->components[0];
+    const double* L = c0->cov_chol;
+    double* base = dg + (size_t)k * d;
+    for (int j = 0; j < k; j++) {
+        const double* mu = r->components[j].mean;
+        double* m = dg + (size_t)j * d;
+        double mm = 0;
+        for (int a = 0; a < d; a++) {
+            double t = mu[a] - xbar[a];
+            for (int c = 0; c < a; c++) t -= L[a*d+c] * m[c];
+            m[a] = t / L[a*d+a];
+            mm += m[a] * m[a];
+        }
+        base[j] = log(r->mixing_weights[j]) - 0.5 * (d * log(2 * M_PI) + c0->log_det + mm);
+    }
+    memcpy(base + k, xbar, sizeof(double) * d);
+}
+
+/* Shared covariance from the upper triangle of nΣ (or the identity if it
+ * is not positive definite), factored once and copied to every component.
+ * S may be component 0's cov: only its upper triangle is read. */
+static void mv_tied_share(MVMixtureResult* r, const double* S, double n) {
+    int d = r->dim;
+    MVGaussParams* c0 = &r->components[0];
+    for (int a = 0; a < d; a++)
+        for (int b = a; b < d; b++)
+            c0->cov[a*d+b] = c0->cov[b*d+a] = S[a*d+b] / n;
+    if (update_cholesky(c0) != 0) {
+        memset(c0->cov, 0, sizeof(double) * d * d);
+        for (int a = 0; a < d; a++) c0->cov[a*d+a] = 1.0;
+        update_cholesky(c0);
+    }
+    for (int j = 1; j < r->num_components; j++) {
+        MVGaussParams* c = &r->components[j];
+        memcpy(c->cov, c0->cov, sizeof(double) * d * d);
+        memcpy(c->cov_chol, c0->cov_chol, sizeof(double) * d * d);
+        c->log_det = c0->log_det;
+    }
+}
+
+/* Per-iteration E-step constants for every covariance type but COV_FULL;
+ * xbar, the data mean, is only read for COV_TIED */
+static void mv_estep_pack(MVMixtureResult* r, const double* xbar, double* dg) {
+    if (r->cov_type == COV_LOWRANK) mv_lr_pack(r, dg);
+    else if (r->cov_type == COV_TIED) mv_tied_pack(r, xbar, dg);
+    else mv_diag_pack(r, dg);
+}
+
+
+/* ════════════════════════════════════════════════════════════════════
+ * SQUAREM coordinates (accel.h)
+ *
+ * Packed per fit: the k weights, then per component the mean and its
+ * covariance as the lower triangle of the Cholesky factor with log
+ * diagonal (COV_FULL; COV_TIED once, for component 0), the log diagonal
+ * of the factor (diagonal, spherical), or W and log(Ψ + reg) (low rank).
+ * Any extrapolated vector maps back to SPD covariances.
+ * ════════════════════════════════════════════════════════════════════ */
+
+static size_t mv_accel_cov_len(int d, int full) {
+    return full ? (size_t)d * (d + 1) / 2 : (size_t)d;
+}
+
+static double* mv_accel_pack_cov(const double* L, int d, int full, double* th) {
+    for (int a = 0; a < d; a++) {
+        if (full)
+            for (int b = 0; b < a; b++) *th++ = L[a*d+b];
+        *th++ = log(L[a*d+a]);
+    }
+    return th;
+}
+
+/* cov = LLᵀ less the regularization update_cholesky/update_diagonal add
+ * back; L is written to the (stale) factor, which the caller refactors */
+static const double* mv_accel_unpack_cov(const double* th, int d, int full,
+                                         double* cov, double* L) {
+    for (int a = 0; a < d; a++) {
+        if (full)
+            for (int b = 0; b < a; b++) L[a*d+b] = *th++;
+        L[a*d+a] = exp(*th++);
+    }
+    for (int a = 0; a < d; a++) {
+        if (!full) {
+            cov[a*d+a] = L[a*d+a] * L[a*d+a] - MV_COV_REG;
+            continue;
+        }
+        for (int b = 0; b <= a; b++) {
+            double v = 0;
+            for (int c = 0; c <= b; c++) v += L[a*d+c] * L[b*d+c];
+            cov[a*d+b] = cov[b*d+a] = v;
+        }
+        cov[a*d+a] -= MV_COV_REG;
+    }
+    return th;
+}
+
+static size_t mv_gauss_accel_len(int d, int k, CovType cov_type, int q) {
+    size_t per = cov_type == COV_LOWRANK ? (size_t)d * q + d
+               : cov_type == COV_TIED ? 0
+               : mv_accel_cov_len(d, cov_type == COV_FULL);
+    size_t len = (size_t)k * (1 + d + per);
+    return cov_type == COV_TIED ? len + mv_accel_cov_len(d, 1) : len;
+}
+
+static void mv_gauss_accel_pack(const MVMixtureResult* r, double* th) {
+    int d = r->dim, k = r->num_components;
+    CovType t = r->cov_type;
+    memcpy(th, r->mixing_weights, sizeof(double) * k);
+    th += k;
+    for (int j = 0; j < k; j++) {
+        const MVGaussParams* c = &r->components[j];
+        memcpy(th, c->mean, sizeof(double) * d);
+        th += d;
+        if (t == COV_LOWRANK) {
+            memcpy(th, c->loadings, sizeof(double) * d * c->rank);
+            th += (size_t)d * c->rank;
+            for (int a = 0; a < d; a++) *th++ = log(c->psi[a] + MV_COV_REG);
+        } else if (t != COV_TIED) {
+            th = mv_accel_pack_cov(c->cov_chol, d, t == COV_FULL, th);
+        }
+    }
+    if (t == COV_TIED) mv_accel_pack_cov(r->components[0].cov_chol, d, 1, th);
+}
+
+/* Inverse of mv_gauss_accel_pack, projecting onto the feasible set */
+static void mv_gauss_accel_unpack(MVMixtureResult* r, const double* th) {
+    int d = r->dim, k = r->num_components;
+    CovType t = r->cov_type;
+    memcpy(r->mixing_weights, th, sizeof(double) * k);
+    EMAccelProjectWeights(r->mixing_weights, k);
+    th += k;
+    for (int j = 0; j < k; j++) {
+        MVGaussParams* c = &r->components[j];
+        memcpy(c->mean, th, sizeof(double) * d);
+        th += d;
+        if (t == COV_LOWRANK) {
+            memcpy(c->loadings, th, sizeof(double) * d * c->rank);
+            th += (size_t)d * c->rank;
+            for (int a = 0; a < d; a++) {
+                double v = exp(*th++) - MV_COV_REG;
+                c->psi[a] = v > 0 ? v : 0;
+            }
+        } else if (t != COV_TIED) {
+            th = mv_accel_unpack_cov(th, d, t == COV_FULL, c->cov, c->cov_chol);
+            int rc = t == COV_FULL ? update_cholesky(c) : update_diagonal(c);
+            if (rc != 0) {
+                memset(c->cov, 0, sizeof(double) * d * d);
+                for (int a = 0; a < d; a++) c->cov[a*d+a] = 1.0;
+                update_cholesky(c);
+            }
+        }
+    }
+    if (t == COV_TIED) {
+        MVGaussParams* c0 = &r->components[0];
+        mv_accel_unpack_cov(th, d, 1, c0->cov, c0->cov_chol);
+        mv_tied_share(r, c0->cov, 1.0);
+    }
+}
+
+
+/* ─── Initialization shared by the Gaussian and Student-t engines ───
+ * Furthest-point seeding (first center = middle row) and per-dimension
+ * global variance.  For very large n both run on a stratified subsample
+ * from InitSubsample(); EM afterwards always sees the full data.
+ * Writes centers[k·d] and global_var[d]; returns the subsample size, or
+ * 0 when the full data was used. */
+static size_t mv_init_seed(const double* data, size_t n, int d, int k,
+                           double* centers, double* global_var)
+{
+    double* sample = NULL;
+    size_t m = InitSubsample(data, n, d, k, &sample);
+    if (m > 0) {
+        data = sample;
+        n = m;
+    }
+
+    size_t first = n / 2;
+    memcpy(&centers[0], &data[first * d], sizeof(double) * d);
+
+    /* Remaining centers: furthest-point heuristic */
+    double* min_dist = (double*)malloc(sizeof(double) * n);
+    for (size_t i = 0; i < n; i++) min_dist[i] = 1e30;
+
+    for (int j = 1; j < k; j++) {
+        /* Update min distances to nearest existing center */
+        const double* prev = &centers[(j-1) * d];
+        for (size_t i = 0; i < n; i++) {
+            double dist = 0;
+            for (int dd = 0; dd < d; dd++) {
+                double diff = data[i*d+dd] - prev[dd];
+                dist += diff * diff;
+            }
+            if (dist < min_dist[i]) min_dist[i] = dist;
+        }
+        /* Pick point with max min_dist */
+        size_t best = 0;
+        for (size_t i = 1; i < n; i++)
+            if (min_dist[i] > min_dist[best]) best = i;
+        memcpy(&centers[j * d], &data[best * d], sizeof(double) * d);
+    }
+    free(min_dist);
+
+    /* Global per-dimension variance for the starting covariances */
+    double* global_mean = (double*)calloc(d, sizeof(double));
+    memset(global_var, 0, sizeof(double) * d);
+    for (size_t i = 0; i < n; i++)
+        for (int dd = 0; dd < d; dd++)
+            global_mean[dd] += data[i*d+dd];
+    for (int dd = 0; dd < d; dd++) global_mean[dd] /= n;
+    for (size_t i = 0; i < n; i++)
+        for (int dd = 0; dd < d; dd++) {
+            double diff = data[i*d+dd] - global_mean[dd];
+            global_var[dd] += diff * diff;
+        }
+    for (int dd = 0; dd < d; dd++) global_var[dd] /= n;
+    free(global_mean);
+
+    free(sample);
+    return m;
+}
+
+/* Free parameters of a k-component MV Gaussian mixture, for BIC/AIC;
+ * q is the COV_LOWRANK rank (W is identified up to a q × q rotation) */
+static int mv_gauss_nfree(int k, int d, int q, CovType cov_type) {
+    switch (cov_type) {
+        case COV_FULL:      return k * (d + d*(d+1)/2) + k - 1;
+        case COV_DIAGONAL:  return k * (d + d) + k - 1;
+        case COV_SPHERICAL: return k * (d + 1) + k - 1;
+        case COV_LOWRANK:   return k * (d + d*q - q*(q-1)/2 + d) + k - 1;
+        case COV_TIED:      return k * d + d*(d+1)/2 + k - 1;
+        default:            return k * (d + d*(d+1)/2) + k - 1;
+    }
+}
+
+/* ─── EM iterations from the parameters already in result ───
+ * Shared by every level of the multiresolution schedule; the final call
+ * runs on the full data and sets iterations, LL, BIC and AIC. */
+static int mv_gauss_em(const double* data, size_t n, int d, int k,
+                       CovType cov_type, int maxiter, double rtole,
+                       int verbose, MVMixtureResult* result)
+{
+    /* Responsibilities: n × k */
+    double* resp = (double*)malloc(sizeof(double) * n * k);
+    double* nj = (double*)malloc(sizeof(double) * k);
+    double* mu = (double*)malloc(sizeof(double) * k * d);   /* packed means */
+    int q = cov_type == COV_LOWRANK ? result->components[0].rank : 0;
+    size_t dg_len = q ? (size_t)k * mv_lr_stride(d, q) : mv_diag_len(d, k);
+    double* dg = cov_type == COV_FULL ? NULL : (double*)malloc(sizeof(double) * dg_len);
+    double* lw = q ? (double*)malloc(sizeof(double) * (2 * (q + 1) * (q + 1) + q + 1)) : NULL;
+    int tied = cov_type == COV_TIED;
+    size_t clen = cov_type == COV_FULL ? (size_t)d * d
+                : q ? (size_t)d * q + (size_t)q * q + d + q : (size_t)d;
+    size_t len1 = (size_t)k * (1 + d);
+    size_t plen = len1 > k * clen ? len1 : k * clen;
+    double* tot = tied ? (double*)malloc(sizeof(double) * (2 * d * d + d)) : NULL;
+    MVPar par;
+    if (!resp || !nj || !mu || (cov_type != COV_FULL && !dg) || (q && !lw) || (tied && !tot) ||
+        mv_par_init(&par, n, mv_estep_scratch(d, k), plen) != 0) {
+        free(resp); free(nj); free(mu); free(dg); free(lw); free(tot);
+        return -3;
+    }
+    long nblk = (long)par.nblk;
+    double prev_ll = -1e30;
+    int fixed = simd_mv_fixed_dim(d);   /* unrolled covariance kernel */
+    size_t th_len = mv_gauss_accel_len(d, k, cov_type, q);
+    EMAccel* acc = EMAccelStart(th_len);
+    double* th = acc ? (double*)malloc(sizeof(double) * th_len) : NULL;
+    if (acc && !th) { EMAccelFinish(acc, NULL); acc = NULL; }
+
+    /* COV_TIED: x̄ and the total scatter T (upper triangle) once per fit */
+    double* xbar = tot ? tot + 2 * (size_t)d * d : NULL;
+    if (tied) {
+        memset(xbar, 0, sizeof(double) * d);
+        for (size_t i = 0; i < n; i++)
+            for (int a = 0; a < d; a++) xbar[a] += data[i * d + a];
+        for (int a = 0; a < d; a++) xbar[a] /= (double)n;
+        /* Unit weights: the responsibilities are not needed yet */
+        for (size_t i = 0; i < par.rows && i < n; i++) resp[i] = 1.0;
+        memset(tot, 0, sizeof(double) * d * d);
+        for (long b = 0; b < nblk; b++) {
+            size_t i0 = (size_t)b * par.rows;
+            size_t m = n - i0 < par.rows ? n - i0 : par.rows;
+            if (fixed) simd_mv_scatter_fixed(data + i0 * d, m, d, 1, resp, NULL, xbar, tot);
+            else mv_scatter_full(data + i0 * d, m, d, 1, resp, NULL, xbar, tot, mv_par_scratch(&par));
+        }
+    }
+
+    /* ─── EM loop ─── */
+    int iter;
+    for (iter = 0; iter < maxiter; iter++) {
+
+        /* ─── E-step (blocked, log-sum-exp per point), blocks in parallel ─── */
+        if (dg) mv_estep_pack(result, xbar, dg);
+        #ifdef _OPENMP
+        #pragma omp parallel for schedule(dynamic, 1) num_threads(par.nthreads) if(par.nthreads > 1)
+        #endif
+        for (long b = 0; b < nblk; b++) {
+            size_t i0 = (size_t)b * par.rows;
+            size_t m = n - i0 < par.rows ? n - i0 : par.rows;
+            par.bll[b] = mv_gauss_estep(data + i0 * d, m, d, k, result, dg, resp + i0 * k,
+                                        mv_par_scratch(&par));
+        }
+        double ll = mv_par_ll(&par);
+        if (EMAccelCheck(acc, ll, th)) {
+            /* The extrapolation lost likelihood: E-step again from u₂ */
+            mv_gauss_accel_unpack(result, th);
+            continue;
+        }
+
+        double delta = fabs(ll - prev_ll);
+        if (verbose) {
+            printf("  [MV-Gauss k=%d d=%d] iter %d  LL=%.4f  delta=%.2e\n",
+                   k, d, iter, ll, delta);
+        }
+
+        if (iter > 0 && delta < rtole) {
+            iter++;
+            break;
+        }
+        prev_ll = ll;
+
+        /* ─── M-step: per-block sums, merged in block order ─── */
+        /* Σr and Σr·x */
+        #ifdef _OPENMP
+        #pragma omp parallel for schedule(dynamic, 1) num_threads(par.nthreads) if(par.nthreads > 1)
+        #endif
+        for (long b = 0; b < nblk; b++) {
+            double* s1 = par.part + (size_t)b * par.part_len;
+            size_t i0 = (size_t)b * par.rows;
+            size_t i1 = i0 + par.rows < n ? i0 + par.rows : n;
+            memset(s1, 0, sizeof(double) * len1);
+            for (size_t i = i0; i < i1; i++) {
+                const double* xi = &data[i * d];
+                const double* ri = &resp[i * k];
+                for (int j = 0; j < k; j++) {
+                    double r = ri[j];
+                    double* sx = s1 + k + (size_t)j * d;
+                    s1[j] += r;
+                    for (int dd = 0; dd < d; dd++) sx[dd] += r * xi[dd];
+                }
+            }
+        }
+        mv_par_merge(&par, len1);
+        for (int j = 0; j < k; j++) {
+            nj[j] = par.sum[j];
+            if (nj[j] < 1e-10) {
+                result->mixing_weights[j] = 1e-10;
+                continue;
+            }
+            result->mixing_weights[j] = nj[j] / n;
+            for (int dd = 0; dd < d; dd++)
+                result->components[j].mean[dd] = par.sum[k + (size_t)j * d + dd] / nj[j];
+        }
+
+        if (tied) {
+            /* nΣ = T − Σ_j N_j (μ_j − x̄)(μ_j − x̄)ᵀ, no pass over the data */
+            double* S = tot + (size_t)d * d;
+            memcpy(S, tot, sizeof(double) * d * d);
+            for (int j = 0; j < k; j++) {
+                const double* mj = result->components[j].mean;
+                for (int a = 0; a < d; a++) {
+                    double ra = nj[j] * (mj[a] - xbar[a]);
+                    for (int b = a; b < d; b++) S[a*d+b] -= ra * (mj[b] - xbar[b]);
+                }
+            }
+            mv_tied_share(result, S, (double)n);
+        } else {
+            /* Centred second moments: upper triangle (full, tiled SYRK),
+             * diagonal, or the factor-analysis statistics (low rank) */
+            for (int j = 0; j < k; j++)
+                memcpy(mu + (size_t)j * d, result->components[j].mean, sizeof(double) * d);
+            #ifdef _OPENMP
+            #pragma omp parallel for schedule(dynamic, 1) num_threads(par.nthreads) if(par.nthreads > 1)
+            #endif
+            for (long b = 0; b < nblk; b++) {
+                double* s2 = par.part + (size_t)b * par.part_len;
+                double* xc = mv_par_scratch(&par);
+                size_t i0 = (size_t)b * par.rows;
+                size_t i1 = i0 + par.rows < n ? i0 + par.rows : n;
+                memset(s2, 0, sizeof(double) * k * clen);
+                if (cov_type == COV_FULL) {
+                    if (fixed) simd_mv_scatter_fixed(data + i0 * d, i1 - i0, d, k, resp + i0 * k, NULL, mu, s2);
+                    else mv_scatter_full(data + i0 * d, i1 - i0, d, k, resp + i0 * k, NULL, mu, s2, xc);
+                    continue;
+                }
+                if (q) {
+                    mv_lr_scatter(data + i0 * d, i1 - i0, d, k, q, resp + i0 * k, dg, s2, xc);
+                    continue;
+                }
+                for (size_t i = i0; i < i1; i++) {
+                    const double* xi = &data[i * d];
+                    for (int j = 0; j < k; j++) {
+                        double r = resp[i * k + j];
+                        const double* mj = mu + (size_t)j * d;
+                        double* sj = s2 + (size_t)j * clen;
+                        for (int dd = 0; dd < d; dd++) {
+                            double diff = xi[dd] - mj[dd];
+                            sj[dd] += r * diff * diff;
+                        }
+                    }
+                }
+            }
+            mv_par_merge(&par, k * clen);
+
+            for (int j = 0; j < k; j++) {
+                if (nj[j] < 1e-10) continue;
+                const double* sj = par.sum + (size_t)j * clen;
+                double* cov = result->components[j].cov;
+                if (q) {
+                    mv_lr_update(&result->components[j], nj[j], sj,
+                                 dg + (size_t)j * mv_lr_stride(d, q), lw);
+                    continue;
+                }
+                if (cov_type == COV_FULL) {
+                    /* Symmetrize and normalize */
+                    for (int a = 0; a < d; a++)
+                        for (int b = a; b < d; b++)
+                            cov[a*d+b] = cov[b*d+a] = sj[a*d+b] / nj[j];
+                } else if (cov_type == COV_DIAGONAL) {
+                    for (int dd = 0; dd < d; dd++) cov[dd*d+dd] = sj[dd] / nj[j];
+                } else { /* COV_SPHERICAL */
+                    double total_var = 0;
+                    for (int dd = 0; dd < d; dd++) total_var += sj[dd];
+                    total_var /= (nj[j] * d);
+                    for (int dd = 0; dd < d; dd++) cov[dd*d+dd] = total_var;
+                }
+
+                /* Update Cholesky */
+                int rc = cov_type == COV_FULL ? update_cholesky(&result->components[j])
+                                              : update_diagonal(&result->components[j]);
+                if (rc != 0) {
+                    /* Reset to identity if Cholesky fails */
+                    memset(cov, 0, sizeof(double) * d * d);
+                    for (int dd = 0; dd < d; dd++) cov[dd*d+dd] = 1.0;
+                    update_cholesky(&result->components[j]);
+                }
+            }
+        }
+
+        /* Normalize weights */
+        double wsum = 0;
+        for (int j = 0; j < k; j++) wsum += result->mixing_weights[j];
+        for (int j = 0; j < k; j++) result->mixing_weights[j] /= wsum;
+
+        if (acc) {
+            mv_gauss_accel_pack(result, th);
+            if (EMAccelUpdate(acc, th)) mv_gauss_accel_unpack(result, th);
+        }
+    }
+    if (EMAccelSettle(acc, th)) mv_gauss_accel_unpack(result, th);
+
+    result->iterations = iter;
+    result->loglikelihood = prev_ll;
+    int rejected, tried = EMAccelFinish(acc, &rejected);
+    if (verbose && tried)
+        printf("  [MV-Gauss k=%d d=%d] SQUAREM: %d extrapolations, %d rejected\n",
+               k, d, tried, rejected);
+
+    /* Compute BIC/AIC */
+    if (q) mv_lr_finish(result);
+    int nfree = mv_gauss_nfree(k, d, q, cov_type);
+    result->bic = -2 * result->loglikelihood + nfree * log((double)n);
+    result->aic = -2 * result->loglikelihood + 2 * nfree;
+
+    free(resp); free(nj); free(mu); free(dg); free(lw); free(tot); free(th);
+    mv_par_free(&par);
+    return 0;
+}
+
+/* ════════════════════════════════════════════════════════════════════
+ * Multivariate Gaussian Mixture EM
+ * ════════════════════════════════════════════════════════════════════ */
+
+/* ─── Allocate result and seed the parameters (see mv_init_seed) ─── */
+static void mv_gauss_setup(const double* data, size_t n, int d, int k,
+                           CovType cov_type, int verbose, MVMixtureResult* result)
+{
+    /* Allocate result */
+    result->num_components = k;
+    result->dim = d;
+    result->cov_type = cov_type;
+    result->mixing_weights = (double*)malloc(sizeof(double) * k);
+    result->components = (MVGaussParams*)malloc(sizeof(MVGaussParams) * k);
+
+    for (int j = 0; j < k; j++) {
+        alloc_mvparams(&result->components[j], d);
+        result->mixing_weights[j] = 1.0 / k;
+    }
+
+    /* ─── Initialization: K-means++ style ─── */
+    {
+        double* centers = (double*)malloc(sizeof(double) * k * d);
+        double* global_var = (double*)malloc(sizeof(double) * d);
+        double t_init = WallSeconds();
+        size_t m = mv_init_seed(data, n, d, k, centers, global_var);
+
+        for (int j = 0; j < k; j++) {
+            MVGaussParams* c = &result->components[j];
+            memcpy(c->mean, &centers[j * d], sizeof(double) * d);
+            memset(c->cov, 0, sizeof(double) * d * d);
+            for (int dd = 0; dd < d; dd++)
+                c->cov[dd*d+dd] = global_var[dd] / k;
+            update_cholesky(c);
+            if (cov_type == COV_LOWRANK) {
+                /* Ψ the diagonal start; W small and deterministic, so the
+                 * factors break symmetry without moving Σ far from Ψ */
+                int q = mv_lowrank_q(d);
+                c->rank = q;
+                c->psi = (double*)malloc(sizeof(double) * d);
+                c->loadings = (double*)malloc(sizeof(double) * d * q);
+                for (int dd = 0; dd < d; dd++) {
+                    c->psi[dd] = global_var[dd] / k;
+                    double s = 0.1 * sqrt(c->psi[dd]);
+                    for (int e = 0; e < q; e++) {
+                        unsigned h = (unsigned)(dd * 73856093) ^ (unsigned)(e * 19349663)
+                                   ^ (unsigned)(j * 83492791);
+                        h ^= h >> 13; h *= 0x5bd1e995u; h ^= h >> 15;
+                        c->loadings[dd*q+e] = s * ((double)(h & 0xffff) / 32767.5 - 1.0);
+                    }
+                }
+            }
+        }
+        free(centers);
+        free(global_var);
+
+        if (verbose) {
+            printf("  [MV-Gauss k=%d d=%d] init %.3f s", k, d, WallSeconds() - t_init);
+            if (m > 0) printf(" (subsample %zu of %zu)", m, n);
+            printf("\n");
+        }
+    }
+}
+
+
+/* kd-tree EM on the full data (below, with the incremental engine's M-step) */
+static int mv_gauss_kdem(const double* data, size_t n, int d, int k,
+                         CovType cov_type, int maxiter, double rtole,
+                         int verbose, MVMixtureResult* result);
+
+int UnmixMVGaussian(const double* data, size_t n, int d, int k,
+                    CovType cov_type, int maxiter, double rtole,
+                    int verbose, MVMixtureResult* result)
+{
+    if (!data || n == 0 || d <= 0 || k <= 0 || !result) return -1;
+
+    mv_gauss_setup(data, n, d, k, cov_type, verbose, result);
+
+    /* ─── Coarse-to-fine: EM on nested subsamples, then the full data.
+     * rtole on the LL of m rows is a per-row tolerance of rtole/m, n/m
+     * times looser than the full fit's, tightening tenfold per level.
+     * A level that fails (e.g. a degenerate subsample) hands over to the
+     * full-data fit from a fresh initialization. ─── */
+    size_t sizes[GEMMULEM_MULTIRES_MAX_LEVELS];
+    int nlev = MultiresSchedule(n, k, d, sizes);
+    for (int l = 0; l < nlev; l++) {
+        double* sub = NULL;
+        size_t m = MultiresSubsample(data, n, d, sizes[l], &sub);
+        if (m == 0) break;
+        double t_lev = WallSeconds();
+        int rc = mv_gauss_em(sub, m, d, k, cov_type, maxiter, rtole, 0, result);
+        free(sub);
+        if (rc != 0 || !isfinite(result->loglikelihood)) {
+            if (verbose)
+                printf("  [MV-Gauss k=%d d=%d] multires level %d/%d failed (rc=%d); "
+                       "fitting the full data\n", k, d, l + 1, nlev + 1, rc);
+            ReleaseMVMixtureResult(result);
+            mv_gauss_setup(data, n, d, k, cov_type, 0, result);
+            break;
+        }
+        if (verbose)
+            printf("  [MV-Gauss k=%d d=%d] multires level %d/%d: n=%zu  LL=%.4f  iters=%d  %.3f s\n",
+                   k, d, l + 1, nlev + 1, m, result->loglikelihood,
+                   result->iterations, WallSeconds() - t_lev);
+    }
+
+    int rc;
+    if (GetMVKdTreeTolerance() > 0 && d <= MV_KDTREE_MAX_DIM && cov_type != COV_LOWRANK)
+        rc = mv_gauss_kdem(data, n, d, k, cov_type, maxiter, rtole, verbose, result);
+    else
+        rc = mv_gauss_em(data, n, d, k, cov_type, maxiter, rtole, verbose, result);
+    if (rc != 0) ReleaseMVMixtureResult(result);
+    return rc;
+}
+
+
+/* ════════════════════════════════════════════════════════════════════
+ * Incremental MV Gaussian EM (Neal & Hinton 1998)
+ *
+ * Same block scheme as UnmixIncremental: rows are dealt round-robin in
+ * 256-row chunks to B blocks, each block caches Sᵦ = Σᵢ∈ᵦ rᵢⱼ·(1, x, xxᵀ)
+ * per component, and every block E-step is followed by the closed-form
+ * M-step on S = Σᵦ Sᵦ.  Statistics are taken about the global mean so
+ * that S₂/N − μμᵀ does not cancel for offset data.
+ * ════════════════════════════════════════════════════════════════════ */
+
+#define MV_INCR_CHUNK      256
+#define MV_INCR_DEF_BLOCKS 32
+
+static void mv_incr_mstep(int d, int k, CovType cov_type, const double* S,
+                          const double* shift, MVMixtureResult* r)
+{
+    size_t ns = 1 + (size_t)d + (size_t)d * d;
+    double ntot = 0;
+    for (int j = 0; j < k; j++) ntot += S[j * ns];
+    /* COV_TIED: pooled scatter (upper triangle) gathered in component 0 */
+    double* pool = r->components[0].cov;
+    if (cov_type == COV_TIED) memset(pool, 0, sizeof(double) * d * d);
+    for (int j = 0; j < k; j++) {
+        const double* sj = &S[j * ns];
+        const double* s1 = sj + 1;
+        const double* s2 = sj + 1 + d;
+        MVGaussParams* c = &r->components[j];
+        double nj = sj[0];
+        r->mixing_weights[j] = nj / ntot > 1e-10 ? nj / ntot : 1e-10;
+        if (nj < 1e-10) continue;   /* empty: keep previous params */
+
+        for (int a = 0; a < d; a++) c->mean[a] = s1[a] / nj;
+        if (cov_type == COV_TIED) {
+            for (int a = 0; a < d; a++)
+                for (int b = a; b < d; b++)
+                    pool[a*d+b] += s2[a*d+b] - nj * c->mean[a] * c->mean[b];
+            for (int a = 0; a < d; a++) c->mean[a] += shift[a];
+            continue;
+        }
+        if (cov_type == COV_FULL) {
+            for (int a = 0; a < d; a++)
+                for (int b = a; b < d; b++) {
+                    double v = s2[a*d+b] / nj - c->mean[a] * c->mean[b];
+                    c->cov[a*d+b] = c->cov[b*d+a] = v;
+                }
+        } else if (cov_type == COV_DIAGONAL) {
+            for (int a = 0; a < d; a++)
+                c->cov[a*d+a] = s2[a*d+a] / nj - c->mean[a] * c->mean[a];
+        } else { /* COV_SPHERICAL */
+            double tv = 0;
+            for (int a = 0; a < d; a++)
+                tv += s2[a*d+a] / nj - c->mean[a] * c->mean[a];
+            for (int a = 0; a < d; a++) c->cov[a*d+a] = tv / d;
+        }
+        for (int a = 0; a < d; a++) c->mean[a] += shift[a];
+
+        if ((cov_type == COV_FULL ? update_cholesky(c) : update_diagonal(c)) != 0) {
+            memset(c->cov, 0, sizeof(double) * d * d);
+            for (int a = 0; a < d; a++) c->cov[a*d+a] = 1.0;
+            update_cholesky(c);
+        }
+    }
+    if (cov_type == COV_TIED) mv_tied_share(r, pool, ntot);
+    double wsum = 0;
+    for (int j = 0; j < k; j++) wsum += r->mixing_weights[j];
+    for (int j = 0; j < k; j++) r->mixing_weights[j] /= wsum;
+}
+
+int UnmixMVGaussianIncremental(const double* data, size_t n, int d, int k,
+                               CovType cov_type, int maxiter, double rtole,
+                               int nblocks, int verbose, MVMixtureResult* result)
+{
+    if (!data || n == 0 || d <= 0 || k <= 0 || !result) return -1;
+    if (cov_type == COV_LOWRANK) return -1;   /* no fixed-size statistics */
+
+    size_t nchunks = (n + MV_INCR_CHUNK - 1) / MV_INCR_CHUNK;
+    if (nblocks <= 0) nblocks = MV_INCR_DEF_BLOCKS;
+    if ((size_t)nblocks > nchunks) nblocks = (int)nchunks;
+    size_t ns = 1 + (size_t)d + (size_t)d * d;
+    size_t kns = (size_t)k * ns;
+
+    double* bstat = (double*)calloc((size_t)nblocks * kns, sizeof(double));
+    double* gstat = (double*)calloc(kns, sizeof(double));
+    double* nstat = (double*)malloc(sizeof(double) * kns);
+    int tile = mv_tile_points(d);
+    double* lps   = (double*)malloc(sizeof(double) * k * tile);   /* tile × k resp */
+    double* scr   = (double*)malloc(sizeof(double) * mv_estep_scratch(d, k));
+    double* shift = (double*)calloc(d, sizeof(double));
+    double* xc    = (double*)malloc(sizeof(double) * d);
+    double* dg    = cov_type == COV_FULL ? NULL
+                  : (double*)malloc(sizeof(double) * mv_diag_len(d, k));
+    if (!bstat || !gstat || !nstat || !lps || !scr || !shift || !xc ||
+        (cov_type != COV_FULL && !dg)) {
+        free(bstat); free(gstat); free(nstat); free(lps); free(scr); free(shift); free(xc);
+        free(dg);
+        return -3;
+    }
+
+    for (size_t i = 0; i < n; i++)
+        for (int a = 0; a < d; a++) shift[a] += data[i*d+a];
+    for (int a = 0; a < d; a++) shift[a] /= n;
+
+    mv_gauss_setup(data, n, d, k, cov_type, verbose, result);
+    if (dg) mv_estep_pack(result, shift, dg);
+
+    double prev_ll = -1e30;
+    int epoch;
+    for (epoch = 0; epoch < maxiter; epoch++) {
+        double ll = 0;
+        for (int b = 0; b < nblocks; b++) {
+            memset(nstat, 0, sizeof(double) * kns);
+
+            /* ─── E-step on block b ─── */
+            for (size_t c = (size_t)b; c < nchunks; c += (size_t)nblocks) {
+                size_t i1 = (c + 1) * MV_INCR_CHUNK < n ? (c + 1) * MV_INCR_CHUNK : n;
+                for (size_t i = c * MV_INCR_CHUNK; i < i1; i++) {
+                    const double* xi = &data[i * d];
+                    size_t t = (i - c * MV_INCR_CHUNK) % (size_t)tile;
+                    if (t == 0) {
+                        size_t m = i1 - i < (size_t)tile ? i1 - i : (size_t)tile;
+                        ll += mv_gauss_estep(xi, m, d, k, result, dg, lps, scr);
+                    }
+
+                    for (int a = 0; a < d; a++) xc[a] = xi[a] - shift[a];
+                    for (int j = 0; j < k; j++) {
+                        double rij = lps[t * k + j];
+                        double* sj = &nstat[j * ns];
+                        sj[0] += rij;
+                        for (int a = 0; a < d; a++) sj[1 + a] += rij * xc[a];
+                        double* s2 = sj + 1 + d;
+                        if (cov_type == COV_FULL || cov_type == COV_TIED) {
+                            for (int a = 0; a < d; a++) {
+                                double ra = rij * xc[a];
+                                for (int bb = a; bb < d; bb++) s2[a*d+bb] += ra * xc[bb];
+                            }
+                        } else {
+                            for (int a = 0; a < d; a++) s2[a*d+a] += rij * xc[a] * xc[a];
+                        }
+                    }
+                }
+            }
+
+            /* ─── Swap block statistics, then M-step ─── */
+            double* old = &bstat[(size_t)b * kns];
+            for (size_t q = 0; q < kns; q++) {
+                gstat[q] += nstat[q] - old[q];
+                old[q] = nstat[q];
+            }
+            mv_incr_mstep(d, k, cov_type, gstat, shift, result);
+            if (dg) mv_estep_pack(result, shift, dg);
+        }
+
+        /* Rebuild S from the blocks once per pass (no drift from differences) */
+        memset(gstat, 0, sizeof(double) * kns);
+        for (int b = 0; b < nblocks; b++)
+            for (size_t q = 0; q < kns; q++) gstat[q] += bstat[(size_t)b * kns + q];
+
+        if (verbose)
+            printf("  [MV-Gauss k=%d d=%d incr B=%d] pass %d  LL=%.4f  delta=%.2e\n",
+                   k, d, nblocks, epoch, ll, ll - prev_ll);
+        if (epoch > 0 && fabs(ll - prev_ll) < rtole) { epoch++; break; }
+        prev_ll = ll;
+    }
+
+    /* The pass LL mixes parameters from B steps; report the exact LL */
+    double ll = 0;
+    for (size_t i = 0; i < n; i += (size_t)tile) {
+        size_t m = n - i < (size_t)tile ? n - i : (size_t)tile;
+        ll += mv_gauss_estep(&data[i * d], m, d, k, result, dg, lps, scr);
+    }
+    result->iterations = epoch;
+    result->loglikelihood = ll;
+    int nfree = mv_gauss_nfree(k, d, 0, cov_type);
+    result->bic = -2 * ll + nfree * log((double)n);
+    result->aic = -2 * ll + 2 * nfree;
+
+    free(bstat); free(gstat); free(nstat); free(lps); free(scr); free(shift); free(xc);
+    free(dg);
+    return 0;
+}
+
+
+/* ════════════════════════════════════════════════════════════════════
+ * kd-tree EM (Moore 1999, "Very fast EM-based mixture model clustering
+ * using multiresolution kd-trees")
+ *
+ * The rows are sorted once into a kd-tree whose nodes cache their count
+ * N, bounding box, centroid c and scatter C = Σ (x − c)(x − c)ᵀ.  Each
+ * iteration walks the tree from the root.  Over a node's box, interval
+ * arithmetic on y = L_j⁻¹(x − μ_j) bounds every component's log-density,
+ * hence every responsibility; when all k bounds are narrower than the
+ * tolerance τ the whole node takes the responsibilities of its centroid,
+ * and its statistics enter the M-step through N, c and C alone:
+ *   Σᵢ (xᵢ − μ)(xᵢ − μ)ᵀ = C + N (c − μ)(c − μ)ᵀ.
+ * Leaves that stay ambiguous run the blocked E-step on their rows.  Where
+ * clusters are well separated most of the data is assigned a node at a
+ * time, so an iteration costs far fewer than n density evaluations.  The
+ * per-iteration LL is the free energy of those assignments; the final
+ * LL is exact.
+ * ════════════════════════════════════════════════════════════════════ */
+
+#define MV_KD_LEAF 32   /* rows per leaf, at most */
+
+static double g_kd_tolerance = 0;   /* 0: kd-tree EM off */
+
+void   SetMVKdTreeTolerance(double tau) { g_kd_tolerance = tau > 0 ? tau : 0; }
+double GetMVKdTreeTolerance(void) { return g_kd_tolerance; }
+
+typedef struct {
+    size_t begin, end;   /* rows [begin, end) of the tree-ordered copy */
+    int left, right;     /* children, -1 for a leaf */
+} MVKdNode;
+
+typedef struct {
+    int d, nnodes;
+    MVKdNode* node;
+    double* geo;         /* per node: box lo d | box hi d | centroid d | scatter d × d */
+    double* X;           /* rows in tree order */
+} MVKdTree;
+
+static size_t mv_kd_geo_len(int d) { return 3 * (size_t)d + (size_t)d * d; }
+
+/* Reorder rows [b, e) of X so that row nth has the nth smallest
+ * coordinate dim, smaller ones before it and larger ones after */
+static void mv_kd_select(double* X, int d, int dim, size_t b, size_t e, size_t nth) {
+    while (e - b > 1) {
+        double piv = X[(b + (e - b - 1) / 2) * d + dim];
+        size_t i = b, j = e - 1;
+        for (;;) {   /* Hoare partition: [b, j] ≤ piv ≤ [j + 1, e) */
+            while (X[i * d + dim] < piv) i++;
+            while (X[j * d + dim] > piv) j--;
+            if (i >= j) break;
+            double* xi = X + i * d;
+            double* xj = X + j * d;
+            for (int a = 0; a < d; a++) { double t = xi[a]; xi[a] = xj[a]; xj[a] = t; }
+            i++; j--;
+        }
+        if (nth <= j) e = j + 1;
+        else b = j + 1;
+    }
+}
+
+/* Build the subtree over rows [b, e) of t->X, sorting them in place: split
+ * the widest box side at the median, then fill the node's statistics from
+ * its rows (leaf) or by merging its children's */
+static int mv_kd_build(MVKdTree* t, size_t b, size_t e) {
+    int d = t->d, id = t->nnodes++;
+    MVKdNode* nd = &t->node[id];
+    double* g = t->geo + (size_t)id * mv_kd_geo_len(d);
+    double *lo = g, *hi = g + d, *c = g + 2 * d, *C = g + 3 * d;
+    nd->begin = b;
+    nd->end = e;
+    nd->left = nd->right = -1;
+    for (int a = 0; a < d; a++) { lo[a] = DBL_MAX; hi[a] = -DBL_MAX; }
+    const double* X = t->X;
+    for (size_t i = b; i < e; i++)
+        for (int a = 0; a < d; a++) {
+            double v = X[i * d + a];
+            if (v < lo[a]) lo[a] = v;
+            if (v > hi[a]) hi[a] = v;
+        }
+    int dim = 0;
+    for (int a = 1; a < d; a++)
+        if (hi[a] - lo[a] > hi[dim] - lo[dim]) dim = a;
+
+    if (e - b <= MV_KD_LEAF || hi[dim] == lo[dim]) {
+        memset(c, 0, sizeof(double) * (d + (size_t)d * d));
+        for (size_t i = b; i < e; i++)
+            for (int a = 0; a < d; a++) c[a] += X[i * d + a];
+        for (int a = 0; a < d; a++) c[a] /= (double)(e - b);
+        for (size_t i = b; i < e; i++) {
+            const double* x = X + i * d;
+            for (int a = 0; a < d; a++)
+                for (int bb = 0; bb < d; bb++) C[a*d+bb] += (x[a] - c[a]) * (x[bb] - c[bb]);
+        }
+        return id;
+    }
+
+    size_t mid = b + (e - b) / 2;
+    mv_kd_select(t->X, d, dim, b, e, mid);
+    nd->left = mv_kd_build(t, b, mid);
+    nd->right = mv_kd_build(t, mid, e);
+    const double* gl = t->geo + (size_t)nd->left * mv_kd_geo_len(d);
+    const double* gr = t->geo + (size_t)nd->right * mv_kd_geo_len(d);
+    double nl = (double)(mid - b), nr = (double)(e - mid);
+    for (int a = 0; a < d; a++) c[a] = (nl * gl[2*d+a] + nr * gr[2*d+a]) / (nl + nr);
+    for (int a = 0; a < d; a++)
+        for (int bb = 0; bb < d; bb++) {
+            double dl = (gl[2*d+a] - c[a]) * (gl[2*d+bb] - c[bb]);
+            double dr = (gr[2*d+a] - c[a]) * (gr[2*d+bb] - c[bb]);
+            C[a*d+bb] = gl[3*d+a*d+bb] + gr[3*d+a*d+bb] + nl * dl + nr * dr;
+        }
+    return id;
 }
 
-static void free_mvparams(MVGaussParams* p) {
-    free(p->mean); free(p->cov); free(p->cov_chol);
-    p->mean = p->cov = p->cov_chol = NULL;
+static void mv_kd_free(MVKdTree* t) {
+    free(t->node); free(t->geo); free(t->X);
+    t->node = NULL; t->geo = t->X = NULL;
 }
 
-static int update_cholesky(MVGaussParams* p) {
-    int d = p->dim;
-    /* Add regularization to diagonal */
-    for (int i = 0; i < d; i++)
-        p->cov[i*d+i] += MV_COV_REG;
-
-    int rc = cholesky(p->cov, d, p->cov_chol);
-    if (rc != 0) return -1;
-    p->log_det = log_det_cholesky(p->cov_chol, d);
-
-    /* Remove regularization from stored cov */
-    for (int i = 0; i < d; i++)
-        p->cov[i*d+i] -= MV_COV_REG;
+/* @return 0, or -3 on allocation failure */
+static int mv_kd_init(MVKdTree* t, const double* data, size_t n, int d) {
+    size_t cap = 4 * (n / MV_KD_LEAF) + 4;   /* leaves hold ≥ MV_KD_LEAF/2 rows */
+    t->d = d;
+    t->nnodes = 0;
+    t->node = (MVKdNode*)malloc(sizeof(MVKdNode) * cap);
+    t->geo = (double*)malloc(sizeof(double) * cap * mv_kd_geo_len(d));
+    t->X = (double*)malloc(sizeof(double) * n * d);
+    if (!t->node || !t->geo || !t->X) {
+        mv_kd_free(t);
+        return -3;
+    }
+    memcpy(t->X, data, sizeof(double) * n * d);
+    mv_kd_build(t, 0, n);
     return 0;
 }
 
+/* State of one pass over the tree.  Statistics go to S in the layout of
+ * mv_incr_mstep(): per component N | Σ(x − x̄) | Σ(x − x̄)(x − x̄)ᵀ; the
+ * rows of ambiguous leaves add their scatter to Sx (k × d × d) through the
+ * blocked M-step kernels, merged into S after the pass. */
+typedef struct {
+    const MVKdTree* t;
+    const MVMixtureResult* r;
+    const double* dg;     /* mv_estep_pack(), or NULL for COV_FULL */
+    const double* Linv;   /* k × d × d, L_j⁻¹ */
+    const double* Sinv;   /* k × d × d, Σ_j⁻¹ */
+    const double* base;   /* k: log w_j − ½(d log 2π + log|Σ_j|) */
+    const double* shift;  /* x̄ */
+    const double* shiftk; /* x̄ repeated k times, the kernels' centres */
+    double tau;
+    double* S;
+    double* Sx;
+    double* lo;           /* k: log-density bounds, then responsibilities */
+    double* hi;
+    double* xc;           /* d */
+    double* lps;          /* tile × k */
+    double* scr;          /* mv_estep_scratch() */
+    double ll;
+    size_t pruned, exact; /* rows assigned per node / per row */
+} MVKdPass;
+
+/* δ² bounds of component j over the box: y = L⁻¹(x − μ) row by row in
+ * interval arithmetic */
+static void mv_kd_bounds(const double* Lj, const double* mu, const double* lo,
+                         const double* hi, int d, double* dmin, double* dmax) {
+    double s0 = 0, s1 = 0;
+    for (int a = 0; a < d; a++) {
+        const double* La = Lj + (size_t)a * d;
+        double ymin = 0, ymax = 0;
+        for (int c = 0; c <= a; c++) {
+            double u0 = La[c] * (lo[c] - mu[c]), u1 = La[c] * (hi[c] - mu[c]);
+            ymin += u0 < u1 ? u0 : u1;
+            ymax += u0 < u1 ? u1 : u0;
+        }
+        if (ymin > 0) s0 += ymin * ymin;
+        else if (ymax < 0) s0 += ymax * ymax;
+        s1 += ymin * ymin > ymax * ymax ? ymin * ymin : ymax * ymax;
+    }
+    *dmin = s0;
+    *dmax = s1;
+}
 
-/* ════════════════════════════════════════════════════════════════════
- * Multivariate Gaussian Mixture EM
- * ════════════════════════════════════════════════════════════════════ */
-
-int UnmixMVGaussian(const double* data, size_t n, int d, int k,
-                    CovType cov_type, int maxiter, double rtole,
-                    int verbose, MVMixtureResult* result)
-{
-    if (!data || n == 0 || d <= 0 || k <= 0 || !result) return -1;
+static double mv_kd_delta2(const double* Lj, const double* mu, const double* x, int d) {
+    double s = 0;
+    for (int a = 0; a < d; a++) {
+        const double* La = Lj + (size_t)a * d;
+        double y = 0;
+        for (int c = 0; c <= a; c++) y += La[c] * (x[c] - mu[c]);
+        s += y * y;
+    }
+    return s;
+}
 
-    /* Allocate result */
-    result->num_components = k;
-    result->dim = d;
-    result->cov_type = cov_type;
-    result->mixing_weights = (double*)malloc(sizeof(double) * k);
-    result->components = (MVGaussParams*)malloc(sizeof(MVGaussParams) * k);
+/* Add w·(rows with count N, centroid c, scatter C) to component j */
+static void mv_kd_accum(double* Sj, int d, double w, double N, const double* c,
+                        const double* C, const double* shift, double* xc) {
+    double* s1 = Sj + 1;
+    double* s2 = Sj + 1 + d;
+    for (int a = 0; a < d; a++) xc[a] = c[a] - shift[a];
+    Sj[0] += w * N;
+    for (int a = 0; a < d; a++) {
+        double wa = w * N * xc[a];
+        s1[a] += wa;
+        for (int b = a; b < d; b++) s2[a*d+b] += w * C[a*d+b] + wa * xc[b];
+    }
+}
 
+static void mv_kd_visit(MVKdPass* p, int id) {
+    const MVKdTree* t = p->t;
+    const MVMixtureResult* r = p->r;
+    int d = t->d, k = r->num_components;
+    size_t dd = (size_t)d * d, ns = 1 + (size_t)d + dd;
+    const MVKdNode* nd = &t->node[id];
+    const double* g = t->geo + (size_t)id * mv_kd_geo_len(d);
+    const double *blo = g, *bhi = g + d, *c = g + 2 * d, *C = g + 3 * d;
+    double N = (double)(nd->end - nd->begin);
+
+    /* Responsibility bounds: r_j ≥ e^lo_j / (e^lo_j + Σ_{i≠j} e^hi_i) and
+     * r_j ≤ e^hi_j / (e^hi_j + Σ_{i≠j} e^lo_i) */
+    double mx = -DBL_MAX;
     for (int j = 0; j < k; j++) {
-        alloc_mvparams(&result->components[j], d);
-        result->mixing_weights[j] = 1.0 / k;
+        double dmin, dmax;
+        const double* mu = r->components[j].mean;
+        mv_kd_bounds(p->Linv + j * dd, mu, blo, bhi, d, &dmin, &dmax);
+        p->lo[j] = p->base[j] - 0.5 * dmax;
+        p->hi[j] = p->base[j] - 0.5 * dmin;
+        if (p->hi[j] > mx) mx = p->hi[j];
+    }
+    double sl = 0, sh = 0;
+    for (int j = 0; j < k; j++) {
+        p->lo[j] = exp(p->lo[j] - mx);
+        p->hi[j] = exp(p->hi[j] - mx);
+        sl += p->lo[j];
+        sh += p->hi[j];
+    }
+    int tight = 1;
+    for (int j = 0; j < k && tight; j++) {
+        double rmin = p->lo[j] / (p->lo[j] + sh - p->hi[j]);
+        double rmax = p->hi[j] / (p->hi[j] + sl - p->lo[j]);
+        if (rmax - rmin > p->tau) tight = 0;
     }
 
-    /* ─── Initialization: K-means++ style ─── */
-    {
-        /* Pick first center randomly (use data point n/2) */
-        int first = (int)(n / 2);
-        memcpy(result->components[0].mean, &data[first * d], sizeof(double) * d);
-
-        /* Pick remaining centers: furthest-point heuristic */
-        double* min_dist = (double*)malloc(sizeof(double) * n);
-        for (size_t i = 0; i < n; i++) min_dist[i] = 1e30;
-
-        for (int j = 1; j < k; j++) {
-            /* Update min distances to nearest existing center */
-            for (size_t i = 0; i < n; i++) {
-                double dist = 0;
-                for (int dd = 0; dd < d; dd++) {
-                    double diff = data[i*d+dd] - result->components[j-1].mean[dd];
-                    dist += diff * diff;
-                }
-                if (dist < min_dist[i]) min_dist[i] = dist;
-            }
-            /* Pick point with max min_dist */
-            size_t best = 0;
-            for (size_t i = 1; i < n; i++)
-                if (min_dist[i] > min_dist[best]) best = i;
-            memcpy(result->components[j].mean, &data[best * d], sizeof(double) * d);
+    if (tight) {
+        /* Whole node at its centroid's responsibilities; the free energy
+         * Σ_j r_j Σᵢ log(w_j p_j(xᵢ)) − N Σ_j r_j log r_j goes to the LL */
+        double* lp = p->lo;
+        double m = -DBL_MAX, s = 0;
+        for (int j = 0; j < k; j++) {
+            lp[j] = p->base[j] - 0.5 * mv_kd_delta2(p->Linv + j * dd, r->components[j].mean, c, d);
+            if (lp[j] > m) m = lp[j];
+        }
+        for (int j = 0; j < k; j++) s += exp(lp[j] - m);
+        for (int j = 0; j < k; j++) {
+            double rj = exp(lp[j] - m) / s;
+            if (rj == 0) continue;
+            const double* Si = p->Sinv + j * dd;
+            double tr = 0;
+            for (size_t e = 0; e < dd; e++) tr += Si[e] * C[e];
+            p->ll += rj * (N * lp[j] - 0.5 * tr - N * log(rj));
+            mv_kd_accum(p->S + j * ns, d, rj, N, c, C, p->shift, p->xc);
         }
-        free(min_dist);
+        p->pruned += nd->end - nd->begin;
+        return;
+    }
+    if (nd->left >= 0) {
+        mv_kd_visit(p, nd->left);
+        mv_kd_visit(p, nd->right);
+        return;
+    }
 
-        /* Initialize covariances from global variance */
-        double* global_var = (double*)calloc(d, sizeof(double));
-        double* global_mean = (double*)calloc(d, sizeof(double));
-        for (size_t i = 0; i < n; i++)
-            for (int dd = 0; dd < d; dd++)
-                global_mean[dd] += data[i*d+dd];
-        for (int dd = 0; dd < d; dd++) global_mean[dd] /= n;
-        for (size_t i = 0; i < n; i++)
-            for (int dd = 0; dd < d; dd++) {
-                double diff = data[i*d+dd] - global_mean[dd];
-                global_var[dd] += diff * diff;
+    /* Ambiguous leaf: exact responsibilities row by row, a tile at a time
+     * (a leaf of duplicate rows can exceed MV_KD_LEAF) */
+    size_t tile = (size_t)mv_tile_points(d);
+    for (size_t i0 = nd->begin; i0 < nd->end; i0 += tile) {
+        size_t m = nd->end - i0 < tile ? nd->end - i0 : tile;
+        const double* X = t->X + i0 * d;
+        p->ll += mv_gauss_estep(X, m, d, k, r, p->dg, p->lps, p->scr);
+        for (size_t i = 0; i < m; i++)
+            for (int j = 0; j < k; j++) {
+                double rij = p->lps[i * k + j];
+                double* Sj = p->S + j * ns;
+                Sj[0] += rij;
+                for (int a = 0; a < d; a++) Sj[1 + a] += rij * (X[i * d + a] - p->shift[a]);
             }
-        for (int dd = 0; dd < d; dd++) global_var[dd] /= n;
+        if (simd_mv_fixed_dim(d))
+            simd_mv_scatter_fixed(X, m, d, k, p->lps, NULL, p->shiftk, p->Sx);
+        else
+            mv_scatter_full(X, m, d, k, p->lps, NULL, p->shiftk, p->Sx, p->scr);
+    }
+    p->exact += nd->end - nd->begin;
+}
 
-        for (int j = 0; j < k; j++) {
-            memset(result->components[j].cov, 0, sizeof(double) * d * d);
-            for (int dd = 0; dd < d; dd++)
-                result->components[j].cov[dd*d+dd] = global_var[dd] / k;
-            update_cholesky(&result->components[j]);
-        }
-        free(global_var);
-        free(global_mean);
+/* EM on the kd-tree, from the parameters in result (COV_LOWRANK is not
+ * supported: the node statistics are d × d scatters) */
+static int mv_gauss_kdem(const double* data, size_t n, int d, int k,
+                         CovType cov_type, int maxiter, double rtole,
+                         int verbose, MVMixtureResult* result)
+{
+    size_t dd = (size_t)d * d, kns = (size_t)k * (1 + d + dd);
+    MVKdTree t;
+    double t0 = WallSeconds();
+    if (mv_kd_init(&t, data, n, d) != 0) return -3;
+    double t_build = WallSeconds() - t0;
+
+    double* S = (double*)malloc(sizeof(double) * (kns + k * dd + (size_t)k * d));
+    double* Linv = (double*)malloc(sizeof(double) * k * dd);
+    double* Sinv = (double*)malloc(sizeof(double) * k * dd);
+    double* buf = (double*)malloc(sizeof(double) * (3 * (size_t)k + 2 * (size_t)d));
+    double* lps = (double*)malloc(sizeof(double) * (size_t)k * mv_tile_points(d));
+    double* scr = (double*)malloc(sizeof(double) * mv_estep_scratch(d, k));
+    double* dg = cov_type == COV_FULL ? NULL
+               : (double*)malloc(sizeof(double) * mv_diag_len(d, k));
+    if (!S || !Linv || !Sinv || !buf || !lps || !scr || (cov_type != COV_FULL && !dg)) {
+        free(S); free(Linv); free(Sinv); free(buf); free(lps); free(scr); free(dg);
+        mv_kd_free(&t);
+        return -3;
     }
+    double* base = buf;
+    double* shift = buf + 3 * (size_t)k + d;
+    memcpy(shift, t.geo + 2 * d, sizeof(double) * d);   /* root centroid = x̄ */
+    double* Sx = S + kns;
+    double* shiftk = Sx + k * dd;
+    for (int j = 0; j < k; j++) memcpy(shiftk + (size_t)j * d, shift, sizeof(double) * d);
+
+    MVKdPass p;
+    p.t = &t;
+    p.r = result;
+    p.dg = dg;
+    p.Linv = Linv;
+    p.Sinv = Sinv;
+    p.base = base;
+    p.shift = shift;
+    p.shiftk = shiftk;
+    p.Sx = Sx;
+    p.tau = g_kd_tolerance;
+    p.S = S;
+    p.lo = buf + k;
+    p.hi = buf + 2 * (size_t)k;
+    p.xc = buf + 3 * (size_t)k;
+    p.lps = lps;
+    p.scr = scr;
 
-    /* Responsibilities: n × k */
-    double* resp = (double*)malloc(sizeof(double) * n * k);
     double prev_ll = -1e30;
-
-    /* ─── EM loop ─── */
     int iter;
     for (iter = 0; iter < maxiter; iter++) {
-
-        /* ─── E-step ─── */
-        double ll = 0;
-        for (size_t i = 0; i < n; i++) {
-            const double* xi = &data[i * d];
-            double total = 0;
-            double max_lp = -1e30;
-
-            /* Log-sum-exp trick for numerical stability */
-            double lps[64];  /* k <= 64 */
-            int kk = k < 64 ? k : 64;
-            for (int j = 0; j < kk; j++) {
-                lps[j] = log(result->mixing_weights[j]) +
-                         mvgauss_logpdf(xi, &result->components[j]);
-                if (lps[j] > max_lp) max_lp = lps[j];
-            }
-            for (int j = 0; j < kk; j++) {
-                double v = exp(lps[j] - max_lp);
-                resp[i*k+j] = v;
-                total += v;
-            }
-            for (int j = 0; j < kk; j++)
-                resp[i*k+j] /= total;
-
-            ll += max_lp + log(total);
+        for (int j = 0; j < k; j++) {
+            const MVGaussParams* c = &result->components[j];
+            double* Li = Linv + j * dd;
+            chol_inverse(c->cov_chol, d, Li);     /* Σ⁻¹, full */
+            memcpy(Sinv + j * dd, Li, sizeof(double) * dd);
+            /* L⁻¹ column by column: forward substitution on e_col */
+            memset(Li, 0, sizeof(double) * dd);
+            for (int col = 0; col < d; col++)
+                for (int a = col; a < d; a++) {
+                    double s = a == col ? 1.0 : 0.0;
+                    for (int e = col; e < a; e++) s -= c->cov_chol[a*d+e] * Li[e*d+col];
+                    Li[a*d+col] = s / c->cov_chol[a*d+a];
+                }
+            base[j] = log(result->mixing_weights[j]) - 0.5 * (d * log(2 * M_PI) + c->log_det);
+        }
+        if (dg) mv_estep_pack(result, shift, dg);
+        memset(S, 0, sizeof(double) * (kns + k * dd));
+        p.ll = 0;
+        p.pruned = p.exact = 0;
+        mv_kd_visit(&p, 0);
+        for (int j = 0; j < k; j++) {
+            double* s2 = S + j * (1 + d + dd) + 1 + d;
+            for (size_t e = 0; e < dd; e++) s2[e] += Sx[j * dd + e];
         }
+        double ll = p.ll;
 
         double delta = fabs(ll - prev_ll);
         if (verbose) {
-            printf("  [MV-Gauss k=%d d=%d] iter %d  LL=%.4f  delta=%.2e\n",
-                   k, d, iter, ll, delta);
+            printf("  [MV-Gauss k=%d d=%d kd-tree] iter %d  LL=%.4f  delta=%.2e  rows per node %zu  per row %zu\n",
+                   k, d, iter, ll, delta, p.pruned, p.exact);
         }
-
         if (iter > 0 && delta < rtole) {
             iter++;
             break;
         }
         prev_ll = ll;
-
-        /* ─── M-step ─── */
-        for (int j = 0; j < k; j++) {
-            double nj = 0;
-            for (size_t i = 0; i < n; i++) nj += resp[i*k+j];
-
-            if (nj < 1e-10) {
-                result->mixing_weights[j] = 1e-10;
-                continue;
-            }
-
-            /* Update weight */
-            result->mixing_weights[j] = nj / n;
-
-            /* Update mean */
-            memset(result->components[j].mean, 0, sizeof(double) * d);
-            for (size_t i = 0; i < n; i++) {
-                double r = resp[i*k+j];
-                for (int dd = 0; dd < d; dd++)
-                    result->components[j].mean[dd] += r * data[i*d+dd];
-            }
-            for (int dd = 0; dd < d; dd++)
-                result->components[j].mean[dd] /= nj;
-
-            /* Update covariance */
-            memset(result->components[j].cov, 0, sizeof(double) * d * d);
-
-            if (cov_type == COV_FULL) {
-                for (size_t i = 0; i < n; i++) {
-                    double r = resp[i*k+j];
-                    for (int a = 0; a < d; a++) {
-                        double da = data[i*d+a] - result->components[j].mean[a];
-                        for (int b = a; b < d; b++) {
-                            double db = data[i*d+b] - result->components[j].mean[b];
-                            result->components[j].cov[a*d+b] += r * da * db;
-                        }
-                    }
-                }
-                /* Symmetrize and normalize */
-                for (int a = 0; a < d; a++) {
-                    for (int b = a; b < d; b++) {
-                        result->components[j].cov[a*d+b] /= nj;
-                        result->components[j].cov[b*d+a] = result->components[j].cov[a*d+b];
-                    }
-                }
-            } else if (cov_type == COV_DIAGONAL) {
-                for (size_t i = 0; i < n; i++) {
-                    double r = resp[i*k+j];
-                    for (int dd = 0; dd < d; dd++) {
-                        double diff = data[i*d+dd] - result->components[j].mean[dd];
-                        result->components[j].cov[dd*d+dd] += r * diff * diff;
-                    }
-                }
-                for (int dd = 0; dd < d; dd++)
-                    result->components[j].cov[dd*d+dd] /= nj;
-            } else { /* COV_SPHERICAL */
-                double total_var = 0;
-                for (size_t i = 0; i < n; i++) {
-                    double r = resp[i*k+j];
-                    for (int dd = 0; dd < d; dd++) {
-                        double diff = data[i*d+dd] - result->components[j].mean[dd];
-                        total_var += r * diff * diff;
-                    }
-                }
-                total_var /= (nj * d);
-                for (int dd = 0; dd < d; dd++)
-                    result->components[j].cov[dd*d+dd] = total_var;
-            }
-
-            /* Update Cholesky */
-            if (update_cholesky(&result->components[j]) != 0) {
-                /* Reset to identity if Cholesky fails */
-                memset(result->components[j].cov, 0, sizeof(double) * d * d);
-                for (int dd = 0; dd < d; dd++)
-                    result->components[j].cov[dd*d+dd] = 1.0;
-                update_cholesky(&result->components[j]);
-            }
-        }
-
-        /* Normalize weights */
-        double wsum = 0;
-        for (int j = 0; j < k; j++) wsum += result->mixing_weights[j];
-        for (int j = 0; j < k; j++) result->mixing_weights[j] /= wsum;
+        mv_incr_mstep(d, k, cov_type, S, shift, result);
     }
 
-    result->iterations = iter;
-    result->loglikelihood = prev_ll;
-
-    /* Compute BIC/AIC */
-    int nfree;
-    switch (cov_type) {
-        case COV_FULL:      nfree = k * (d + d*(d+1)/2) + k - 1; break;
-        case COV_DIAGONAL:  nfree = k * (d + d) + k - 1; break;
-        case COV_SPHERICAL: nfree = k * (d + 1) + k - 1; break;
-        default:            nfree = k * (d + d*(d+1)/2) + k - 1;
+    /* Exact LL of the final parameters */
+    double ll = 0;
+    int tile = mv_tile_points(d);
+    if (dg) mv_estep_pack(result, shift, dg);
+    for (size_t i = 0; i < n; i += (size_t)tile) {
+        size_t m = n - i < (size_t)tile ? n - i : (size_t)tile;
+        ll += mv_gauss_estep(t.X + i * d, m, d, k, result, dg, lps, scr);
     }
-    result->bic = -2 * result->loglikelihood + nfree * log((double)n);
-    result->aic = -2 * result->loglikelihood + 2 * nfree;
+    if (verbose)
+        printf("  [MV-Gauss k=%d d=%d kd-tree] %d nodes, built in %.3f s; exact LL=%.4f\n",
+               k, d, t.nnodes, t_build, ll);
+    result->iterations = iter;
+    result->loglikelihood = ll;
+    int nfree = mv_gauss_nfree(k, d, 0, cov_type);
+    result->bic = -2 * ll + nfree * log((double)n);
+    result->aic = -2 * ll + 2 * nfree;
 
-    free(resp);
+    free(S); free(Linv); free(Sinv); free(buf); free(lps); free(scr); free(dg);
+    mv_kd_free(&t);
     return 0;
 }
 
@@ -375,28 +1910,6 @@ void ReleaseMVMixtureResult(MVMixtureResult* r) {
  * where δ²_i,j = Mahalanobis distance of x_i from component j.
  * ════════════════════════════════════════════════════════════════════ */
 
-/* Multivariate Student-t log-PDF */
-static double mvt_logpdf(const double* x, int d, const double* mean,
-                         const double* L_chol, double log_det, double nu)
-{
-    /* Compute Mahalanobis distance */
-    double* diff = (double*)malloc(sizeof(double) * d);
-    double* y = (double*)malloc(sizeof(double) * d);
-    for (int i = 0; i < d; i++) diff[i] = x[i] - mean[i];
-    solve_lower(L_chol, d, diff, y);
-    double mah = 0;
-    for (int i = 0; i < d; i++) mah += y[i] * y[i];
-    free(diff); free(y);
-
-    /* log Γ((ν+d)/2) - log Γ(ν/2) - (d/2) log(νπ) - 0.5 log|Σ|
-     * - ((ν+d)/2) log(1 + δ²/ν) */
-    double lp = lgamma((nu + d) / 2.0) - lgamma(nu / 2.0)
-              - (d / 2.0) * log(nu * M_PI)
-              - 0.5 * log_det
-              - ((nu + d) / 2.0) * log(1.0 + mah / nu);
-    return lp;
-}
-
 static void alloc_mvt_params(MVStudentTParams* p, int d) {
     p->dim = d;
     p->mean = (double*)calloc(d, sizeof(double));
@@ -423,17 +1936,151 @@ static int update_cholesky_t(MVStudentTParams* p) {
     return 0;
 }
 
+static int update_diagonal_t(MVStudentTParams* p) {
+    int d = p->dim;
+    double ld = 0;
+    for (int i = 0; i < d; i++) {
+        double v = p->cov[i*d+i] + MV_COV_REG;
+        if (v <= 0) return -1;
+        p->cov_chol[i*d+i] = sqrt(v);
+        ld += log(v);
+    }
+    p->log_det = ld;
+    return 0;
+}
+
 /* Digamma for ν optimization */
 static double digamma_mv(double x) {
     if (x < 6) return digamma_mv(x + 1) - 1.0 / x;
     return log(x) - 1.0/(2*x) - 1.0/(12*x*x) + 1.0/(120*x*x*x*x);
 }
 
+/* Per-iteration constants for mv_t_estep(), laid out as mv_diag_pack()
+ * (means and inverse variances are packed for diagonal and spherical
+ * covariances only), with base_j the log-density at δ² = 0:
+ * log w_j + log Γ((ν+d)/2) − log Γ(ν/2) − (d/2) log(νπ) − ½ log|Σ_j| */
+static void mv_t_pack(const MVStudentTResult* r, double* pk) {
+    int d = r->dim, k = r->num_components;
+    double* base = pk + 2 * (size_t)k * d;
+    for (int j = 0; j < k; j++) {
+        const MVStudentTParams* c = &r->components[j];
+        double nu = c->nu;
+        if (r->cov_type != COV_FULL) mv_diag_pack_comp(d, k, j, c->mean, c->cov, pk);
+        base[j] = log(r->mixing_weights[j])
+                + lgamma((nu + d) / 2.0) - lgamma(nu / 2.0)
+                - (d / 2.0) * log(nu * M_PI)
+                - 0.5 * c->log_det;
+    }
+}
+
+/* Scratch doubles for mv_t_estep(): one tile transposed, k × B
+ * log-densities and k × B values of log(1 + δ²/ν) */
+static size_t mv_t_scratch(int d, int k) {
+    return (size_t)mv_tile_points(d) * ((size_t)d + 2 * (size_t)k);
+}
+
+/* Blocked Student-t E-step over the m rows of X: one distance δ² per point
+ * and component (mv_tile_distance) gives the log-density
+ *   base_j − ((ν_j+d)/2) log(1 + δ²/ν_j)
+ * and the weight u = (ν_j+d)/(ν_j+δ²).  resp and u are m × k row-major;
+ * nus (2k) receives Σ r·log(1 + δ²/ν) and Σ r·u for the ν update
+ * (log u = log((ν+d)/ν) − log(1 + δ²/ν), so the density's logarithm is
+ * reused).  Returns the log-likelihood. */
+static double mv_t_estep(const double* X, size_t m, int d, int k,
+                         const MVStudentTResult* r, const double* pk,
+                         double* resp, double* u, double* nus, double* scratch) {
+    int B = mv_tile_points(d);
+    const double* dg = r->cov_type == COV_FULL ? NULL : pk;
+    const double* base = pk + 2 * (size_t)k * d;
+    double* Y = scratch;
+    double* lp = scratch + (size_t)B * d;     /* k × B */
+    double* lq = lp + (size_t)k * B;          /* k × B */
+    double ll = 0;
+    memset(nus, 0, sizeof(double) * 2 * k);
+    for (size_t i0 = 0; i0 < m; i0 += (size_t)B) {
+        int nb = (int)(m - i0 < (size_t)B ? m - i0 : (size_t)B);
+        const double* Xt = X + i0 * d;
+        if (dg) mv_tile_transpose(Xt, nb, d, B, Y);
+        for (int j = 0; j < k; j++) {
+            const MVStudentTParams* c = &r->components[j];
+            double nu = c->nu, h = (nu + d) / 2.0;
+            double* lpj = lp + (size_t)j * B;
+            double* lqj = lq + (size_t)j * B;
+            double* uj = u + i0 * k + j;
+            mv_tile_distance(Xt, nb, d, k, B, j, dg, c->mean, c->cov_chol, Y, lpj);
+            for (int b = 0; b < nb; b++) {
+                double mah = lpj[b];
+                lqj[b] = log(1.0 + mah / nu);
+                uj[(size_t)b * k] = (nu + d) / (nu + mah);
+                lpj[b] = base[j] - h * lqj[b];
+            }
+        }
+        for (int b = 0; b < nb; b++) {
+            double* ri = resp + (i0 + b) * k;
+            const double* ui = u + (i0 + b) * k;
+            double max_lp = -1e300;
+            for (int j = 0; j < k; j++)
+                if (lp[(size_t)j * B + b] > max_lp) max_lp = lp[(size_t)j * B + b];
+            double total = 0;
+            for (int j = 0; j < k; j++) {
+                ri[j] = exp(lp[(size_t)j * B + b] - max_lp);
+                total += ri[j];
+            }
+            for (int j = 0; j < k; j++) ri[j] /= total;
+            ll += max_lp + log(total);
+            for (int j = 0; j < k; j++) {
+                nus[j] += ri[j] * lq[(size_t)j * B + b];
+                nus[k + j] += ri[j] * ui[j];
+            }
+        }
+    }
+    return ll;
+}
+
+/* SQUAREM coordinates: weights, then per component the mean, the scale
+ * matrix as for the Gaussian engine and ν (clamped to [1, 200] on unpack) */
+static size_t mv_t_accel_len(int d, int k, CovType cov_type) {
+    return (size_t)k * (2 + d + mv_accel_cov_len(d, cov_type == COV_FULL));
+}
+
+static void mv_t_accel_pack(const MVStudentTResult* r, double* th) {
+    int d = r->dim, k = r->num_components;
+    memcpy(th, r->mixing_weights, sizeof(double) * k);
+    th += k;
+    for (int j = 0; j < k; j++) {
+        const MVStudentTParams* c = &r->components[j];
+        memcpy(th, c->mean, sizeof(double) * d);
+        th = mv_accel_pack_cov(c->cov_chol, d, r->cov_type == COV_FULL, th + d);
+        *th++ = c->nu;
+    }
+}
+
+static void mv_t_accel_unpack(MVStudentTResult* r, const double* th) {
+    int d = r->dim, k = r->num_components, full = r->cov_type == COV_FULL;
+    memcpy(r->mixing_weights, th, sizeof(double) * k);
+    EMAccelProjectWeights(r->mixing_weights, k);
+    th += k;
+    for (int j = 0; j < k; j++) {
+        MVStudentTParams* c = &r->components[j];
+        memcpy(c->mean, th, sizeof(double) * d);
+        th = mv_accel_unpack_cov(th + d, d, full, c->cov, c->cov_chol);
+        int rc = full ? update_cholesky_t(c) : update_diagonal_t(c);
+        if (rc != 0) {
+            memset(c->cov, 0, sizeof(double) * d * d);
+            for (int a = 0; a < d; a++) c->cov[a*d+a] = 1.0;
+            update_cholesky_t(c);
+        }
+        double nu = *th++;
+        c->nu = nu > 200.0 ? 200.0 : nu >= 1.0 ? nu : 1.0;
+    }
+}
+
 int UnmixMVStudentT(const double* data, size_t n, int d, int k,
                     CovType cov_type, int maxiter, double rtole,
                     int verbose, MVStudentTResult* result)
 {
     if (!data || n == 0 || d <= 0 || k <= 0 || !result) return -1;
+    if (cov_type > COV_SPHERICAL) return -1;
 
     result->num_components = k;
     result->dim = d;
@@ -449,90 +2096,74 @@ int UnmixMVStudentT(const double* data, size_t n, int d, int k,
 
     /* Initialize: same as Gaussian (k-means++ style) */
     {
-        int first = (int)(n / 2);
-        memcpy(result->components[0].mean, &data[first * d], sizeof(double) * d);
-
-        double* min_dist = (double*)malloc(sizeof(double) * n);
-        for (size_t i = 0; i < n; i++) min_dist[i] = 1e30;
-
-        for (int j = 1; j < k; j++) {
-            for (size_t i = 0; i < n; i++) {
-                double dist = 0;
-                for (int dd = 0; dd < d; dd++) {
-                    double diff = data[i*d+dd] - result->components[j-1].mean[dd];
-                    dist += diff * diff;
-                }
-                if (dist < min_dist[i]) min_dist[i] = dist;
-            }
-            size_t best = 0;
-            for (size_t i = 1; i < n; i++)
-                if (min_dist[i] > min_dist[best]) best = i;
-            memcpy(result->components[j].mean, &data[best * d], sizeof(double) * d);
-        }
-        free(min_dist);
-
-        double* global_var = (double*)calloc(d, sizeof(double));
-        double* global_mean = (double*)calloc(d, sizeof(double));
-        for (size_t i = 0; i < n; i++)
-            for (int dd = 0; dd < d; dd++)
-                global_mean[dd] += data[i*d+dd];
-        for (int dd = 0; dd < d; dd++) global_mean[dd] /= n;
-        for (size_t i = 0; i < n; i++)
-            for (int dd = 0; dd < d; dd++) {
-                double diff = data[i*d+dd] - global_mean[dd];
-                global_var[dd] += diff * diff;
-            }
-        for (int dd = 0; dd < d; dd++) global_var[dd] /= n;
+        double* centers = (double*)malloc(sizeof(double) * k * d);
+        double* global_var = (double*)malloc(sizeof(double) * d);
+        double t_init = WallSeconds();
+        size_t m = mv_init_seed(data, n, d, k, centers, global_var);
 
         for (int j = 0; j < k; j++) {
+            memcpy(result->components[j].mean, &centers[j * d], sizeof(double) * d);
             memset(result->components[j].cov, 0, sizeof(double) * d * d);
             for (int dd = 0; dd < d; dd++)
                 result->components[j].cov[dd*d+dd] = global_var[dd] / k;
             update_cholesky_t(&result->components[j]);
         }
-        free(global_var); free(global_mean);
+        free(centers);
+        free(global_var);
+
+        if (verbose) {
+            printf("  [MV-T k=%d d=%d] init %.3f s", k, d, WallSeconds() - t_init);
+            if (m > 0) printf(" (subsample %zu of %zu)", m, n);
+            printf("\n");
+        }
     }
 
     double* resp = (double*)malloc(sizeof(double) * n * k);
     double* u_weights = (double*)malloc(sizeof(double) * n * k);  /* per-point weights */
+    double* nj = (double*)malloc(sizeof(double) * k);
+    double* mu = (double*)malloc(sizeof(double) * k * d);   /* packed means */
+    size_t clen = cov_type == COV_FULL ? (size_t)d * d : (size_t)d;
+    double* pk = (double*)malloc(sizeof(double) * mv_diag_len(d, k));
+    /* Σr, Σru, Σr·log(1 + δ²/ν), Σr·u, Σru·x; the E-step fills the middle two */
+    size_t len1 = (size_t)k * (4 + d);
+    size_t scr = mv_t_scratch(d, k) > mv_scatter_scratch(d) ? mv_t_scratch(d, k)
+                                                             : mv_scatter_scratch(d);
+    MVPar par;
+    if (!resp || !u_weights || !nj || !mu || !pk ||
+        mv_par_init(&par, n, scr, len1 > k * clen ? len1 : k * clen) != 0) {
+        free(resp); free(u_weights); free(nj); free(mu); free(pk);
+        ReleaseMVStudentTResult(result);
+        return -3;
+    }
+    long nblk = (long)par.nblk;
     double prev_ll = -1e30;
+    int fixed = simd_mv_fixed_dim(d);   /* unrolled covariance kernel */
+    size_t th_len = mv_t_accel_len(d, k, cov_type);
+    EMAccel* acc = EMAccelStart(th_len);
+    double* th = acc ? (double*)malloc(sizeof(double) * th_len) : NULL;
+    if (acc && !th) { EMAccelFinish(acc, NULL); acc = NULL; }
 
     int iter;
     for (iter = 0; iter < maxiter; iter++) {
 
-        /* E-step: compute responsibilities AND u-weights */
-        double ll = 0;
-        for (size_t i = 0; i < n; i++) {
-            const double* xi = &data[i * d];
-            double max_lp = -1e30;
-            double lps[64];
-            int kk = k < 64 ? k : 64;
-
-            for (int j = 0; j < kk; j++) {
-                lps[j] = log(result->mixing_weights[j]) +
-                         mvt_logpdf(xi, d, result->components[j].mean,
-                                    result->components[j].cov_chol,
-                                    result->components[j].log_det,
-                                    result->components[j].nu);
-                if (lps[j] > max_lp) max_lp = lps[j];
-            }
-
-            double total = 0;
-            for (int j = 0; j < kk; j++) {
-                double v = exp(lps[j] - max_lp);
-                resp[i*k+j] = v;
-                total += v;
-            }
-            for (int j = 0; j < kk; j++) resp[i*k+j] /= total;
-            ll += max_lp + log(total);
-
-            /* Compute u-weights: u_ij = (ν_j + d) / (ν_j + δ²_ij) */
-            for (int j = 0; j < kk; j++) {
-                double mah = mahalanobis_sq(xi, result->components[j].mean,
-                                            result->components[j].cov_chol, d);
-                double nu_j = result->components[j].nu;
-                u_weights[i*k+j] = (nu_j + d) / (nu_j + mah);
-            }
+        /* E-step: responsibilities, u-weights and the ν statistics from one
+         * distance per point and component, blocks in parallel */
+        mv_t_pack(result, pk);
+        #ifdef _OPENMP
+        #pragma omp parallel for schedule(dynamic, 1) num_threads(par.nthreads) if(par.nthreads > 1)
+        #endif
+        for (long b = 0; b < nblk; b++) {
+            size_t i0 = (size_t)b * par.rows;
+            size_t m = n - i0 < par.rows ? n - i0 : par.rows;
+            par.bll[b] = mv_t_estep(data + i0 * d, m, d, k, result, pk, resp + i0 * k,
+                                    u_weights + i0 * k,
+                                    par.part + (size_t)b * par.part_len + 2 * (size_t)k,
+                                    mv_par_scratch(&par));
+        }
+        double ll = mv_par_ll(&par);
+        if (EMAccelCheck(acc, ll, th)) {
+            mv_t_accel_unpack(result, th);
+            continue;
         }
 
         if (verbose)
@@ -546,95 +2177,55 @@ int UnmixMVStudentT(const double* data, size_t n, int d, int k,
         if (iter > 0 && fabs(ll - prev_ll) < rtole) { iter++; break; }
         prev_ll = ll;
 
-        /* M-step */
-        for (int j = 0; j < k; j++) {
-            double nj = 0, nj_u = 0;
-            for (size_t i = 0; i < n; i++) {
-                nj += resp[i*k+j];
-                nj_u += resp[i*k+j] * u_weights[i*k+j];
+        /* M-step: per-block sums, merged in block order.  The ν statistics
+         * came with the E-step, so the ν update needs no further pass. */
+        #ifdef _OPENMP
+        #pragma omp parallel for schedule(dynamic, 1) num_threads(par.nthreads) if(par.nthreads > 1)
+        #endif
+        for (long b = 0; b < nblk; b++) {
+            double* s1 = par.part + (size_t)b * par.part_len;
+            size_t i0 = (size_t)b * par.rows;
+            size_t i1 = i0 + par.rows < n ? i0 + par.rows : n;
+            memset(s1, 0, sizeof(double) * 2 * k);
+            memset(s1 + 4 * (size_t)k, 0, sizeof(double) * k * d);
+            for (size_t i = i0; i < i1; i++) {
+                const double* xi = &data[i * d];
+                for (int j = 0; j < k; j++) {
+                    double r = resp[i*k+j], ru = r * u_weights[i*k+j];
+                    double* sx = s1 + 4 * (size_t)k + (size_t)j * d;
+                    s1[j] += r;
+                    s1[k + j] += ru;
+                    for (int dd = 0; dd < d; dd++) sx[dd] += ru * xi[dd];
+                }
             }
-            if (nj < 1e-10) { result->mixing_weights[j] = 1e-10; continue; }
-
-            result->mixing_weights[j] = nj / n;
+        }
+        mv_par_merge(&par, len1);
+        double* sum_lq = par.sum + 2 * k;   /* kept until the ν update */
+        double* sum_u = par.sum + 3 * k;
+        for (int j = 0; j < k; j++) {
+            nj[j] = par.sum[j];
+            if (nj[j] < 1e-10) { result->mixing_weights[j] = 1e-10; continue; }
+            result->mixing_weights[j] = nj[j] / n;
 
             /* Update mean: weighted by r_ij * u_ij */
-            memset(result->components[j].mean, 0, sizeof(double) * d);
-            for (size_t i = 0; i < n; i++) {
-                double ru = resp[i*k+j] * u_weights[i*k+j];
-                for (int dd = 0; dd < d; dd++)
-                    result->components[j].mean[dd] += ru * data[i*d+dd];
-            }
             for (int dd = 0; dd < d; dd++)
-                result->components[j].mean[dd] /= nj_u;
-
-            /* Update scale matrix: weighted by r_ij * u_ij */
-            memset(result->components[j].cov, 0, sizeof(double) * d * d);
-            if (cov_type == COV_FULL) {
-                for (size_t i = 0; i < n; i++) {
-                    double ru = resp[i*k+j] * u_weights[i*k+j];
-                    for (int a = 0; a < d; a++) {
-                        double da = data[i*d+a] - result->components[j].mean[a];
-                        for (int b = a; b < d; b++) {
-                            double db = data[i*d+b] - result->components[j].mean[b];
-                            result->components[j].cov[a*d+b] += ru * da * db;
-                        }
-                    }
-                }
-                for (int a = 0; a < d; a++)
-                    for (int b = a; b < d; b++) {
-                        result->components[j].cov[a*d+b] /= nj;
-                        result->components[j].cov[b*d+a] = result->components[j].cov[a*d+b];
-                    }
-            } else if (cov_type == COV_DIAGONAL) {
-                for (size_t i = 0; i < n; i++) {
-                    double ru = resp[i*k+j] * u_weights[i*k+j];
-                    for (int dd = 0; dd < d; dd++) {
-                        double diff = data[i*d+dd] - result->components[j].mean[dd];
-                        result->components[j].cov[dd*d+dd] += ru * diff * diff;
-                    }
-                }
-                for (int dd = 0; dd < d; dd++)
-                    result->components[j].cov[dd*d+dd] /= nj;
-            } else { /* spherical */
-                double tv = 0;
-                for (size_t i = 0; i < n; i++) {
-                    double ru = resp[i*k+j] * u_weights[i*k+j];
-                    for (int dd = 0; dd < d; dd++) {
-                        double diff = data[i*d+dd] - result->components[j].mean[dd];
-                        tv += ru * diff * diff;
-                    }
-                }
-                tv /= (nj * d);
-                for (int dd = 0; dd < d; dd++)
-                    result->components[j].cov[dd*d+dd] = tv;
-            }
+                result->components[j].mean[dd] = par.sum[4 * k + (size_t)j * d + dd] / par.sum[k + j];
 
-            if (update_cholesky_t(&result->components[j]) != 0) {
-                memset(result->components[j].cov, 0, sizeof(double) * d * d);
-                for (int dd = 0; dd < d; dd++)
-                    result->components[j].cov[dd*d+dd] = 1.0;
-                update_cholesky_t(&result->components[j]);
-            }
-
-            /* Update ν via fixed-point iteration (Peel & McLachlan 2000) */
-            double nu_old = result->components[j].nu;
+            /* Update ν via fixed-point iteration (Peel & McLachlan 2000):
+             * E[log u - u] from the r_ij / n_j weighted sums */
+            double nu0 = result->components[j].nu;
+            double e_log_u = log((nu0 + d) / nu0) - sum_lq[j] / nj[j], e_u = sum_u[j] / nj[j];
             for (int nu_iter = 0; nu_iter < 20; nu_iter++) {
                 double nu = result->components[j].nu;
                 /* Fixed-point: ψ(ν/2+d/2) - log(ν/2+d/2) + 1 + E[log u - u] + ψ(ν/2) - log(ν/2) = 0
                  * Simplified update: solve for ν using bisection */
-                double sum_log_u = 0, sum_u = 0;
-                for (size_t i = 0; i < n; i++) {
-                    double w = resp[i*k+j] / nj;
-                    sum_log_u += w * log(u_weights[i*k+j]);
-                    sum_u += w * u_weights[i*k+j];
-                }
                 /* Newton step for ν */
-                double target = 1.0 + sum_log_u - sum_u
+                double target = 1.0 + e_log_u - e_u
                               + digamma_mv((nu + d) / 2.0) - log((nu + d) / 2.0)
                               - digamma_mv(nu / 2.0) + log(nu / 2.0);
                 /* Approximate gradient */
                 double eps = 0.01;
-                double target2 = 1.0 + sum_log_u - sum_u
+                double target2 = 1.0 + e_log_u - e_u
                                + digamma_mv((nu+eps+d)/2.0) - log((nu+eps+d)/2.0)
                                - digamma_mv((nu+eps)/2.0) + log((nu+eps)/2.0);
                 double grad = (target2 - target) / eps;
@@ -648,13 +2239,83 @@ int UnmixMVStudentT(const double* data, size_t n, int d, int k,
             }
         }
 
+        /* Update scale matrix: weighted by r_ij * u_ij (full: tiled SYRK) */
+        for (int j = 0; j < k; j++)
+            memcpy(mu + (size_t)j * d, result->components[j].mean, sizeof(double) * d);
+        #ifdef _OPENMP
+        #pragma omp parallel for schedule(dynamic, 1) num_threads(par.nthreads) if(par.nthreads > 1)
+        #endif
+        for (long b = 0; b < nblk; b++) {
+            double* s2 = par.part + (size_t)b * par.part_len;
+            double* xc = mv_par_scratch(&par);
+            size_t i0 = (size_t)b * par.rows;
+            size_t i1 = i0 + par.rows < n ? i0 + par.rows : n;
+            memset(s2, 0, sizeof(double) * k * clen);
+            if (cov_type == COV_FULL) {
+                if (fixed) simd_mv_scatter_fixed(data + i0 * d, i1 - i0, d, k, resp + i0 * k,
+                                                 u_weights + i0 * k, mu, s2);
+                else mv_scatter_full(data + i0 * d, i1 - i0, d, k, resp + i0 * k,
+                                     u_weights + i0 * k, mu, s2, xc);
+                continue;
+            }
+            for (size_t i = i0; i < i1; i++) {
+                const double* xi = &data[i * d];
+                for (int j = 0; j < k; j++) {
+                    double ru = resp[i*k+j] * u_weights[i*k+j];
+                    const double* mj = mu + (size_t)j * d;
+                    double* sj = s2 + (size_t)j * clen;
+                    for (int dd = 0; dd < d; dd++) {
+                        double diff = xi[dd] - mj[dd];
+                        sj[dd] += ru * diff * diff;
+                    }
+                }
+            }
+        }
+        mv_par_merge(&par, k * clen);
+
+        for (int j = 0; j < k; j++) {
+            if (nj[j] < 1e-10) continue;
+            const double* sj = par.sum + (size_t)j * clen;
+            double* cov = result->components[j].cov;
+            if (cov_type == COV_FULL) {
+                for (int a = 0; a < d; a++)
+                    for (int b = a; b < d; b++)
+                        cov[a*d+b] = cov[b*d+a] = sj[a*d+b] / nj[j];
+            } else if (cov_type == COV_DIAGONAL) {
+                for (int dd = 0; dd < d; dd++) cov[dd*d+dd] = sj[dd] / nj[j];
+            } else { /* spherical */
+                double tv = 0;
+                for (int dd = 0; dd < d; dd++) tv += sj[dd];
+                tv /= (nj[j] * d);
+                for (int dd = 0; dd < d; dd++) cov[dd*d+dd] = tv;
+            }
+
+            int rc = cov_type == COV_FULL ? update_cholesky_t(&result->components[j])
+                                          : update_diagonal_t(&result->components[j]);
+            if (rc != 0) {
+                memset(cov, 0, sizeof(double) * d * d);
+                for (int dd = 0; dd < d; dd++) cov[dd*d+dd] = 1.0;
+                update_cholesky_t(&result->components[j]);
+            }
+        }
+
         double wsum = 0;
         for (int j = 0; j < k; j++) wsum += result->mixing_weights[j];
         for (int j = 0; j < k; j++) result->mixing_weights[j] /= wsum;
+
+        if (acc) {
+            mv_t_accel_pack(result, th);
+            if (EMAccelUpdate(acc, th)) mv_t_accel_unpack(result, th);
+        }
     }
+    if (EMAccelSettle(acc, th)) mv_t_accel_unpack(result, th);
 
     result->iterations = iter;
     result->loglikelihood = prev_ll;
+    int rejected, tried = EMAccelFinish(acc, &rejected);
+    if (verbose && tried)
+        printf("  [MV-T k=%d d=%d] SQUAREM: %d extrapolations, %d rejected\n",
+               k, d, tried, rejected);
 
     int nfree;
     switch (cov_type) {
@@ -666,7 +2327,8 @@ int UnmixMVStudentT(const double* data, size_t n, int d, int k,
     result->bic = -2 * prev_ll + nfree * log((double)n);
     result->aic = -2 * prev_ll + 2 * nfree;
 
-    free(resp); free(u_weights);
+    free(resp); free(u_weights); free(nj); free(mu); free(pk); free(th);
+    mv_par_free(&par);
     return 0;
 }
 
@@ -16,7 +16,10 @@ extern "C" {
 typedef enum {
     COV_FULL     = 0,   /* Full covariance matrix (d² free params) */
     COV_DIAGONAL = 1,   /* Diagonal only (d free params) */
-    COV_SPHERICAL = 2   /* σ²I (1 free param) */
+    COV_SPHERICAL = 2,  /* σ²I (1 free param) */
+    COV_LOWRANK  = 3,   /* WWᵀ + Ψ: rank-q loadings W plus diagonal Ψ
+                         * (mixture of factor analyzers; q from SetLowRankDim) */
+    COV_TIED     = 4    /* One full covariance shared by all components */
 } CovType;
 
 /* Per-component multivariate Gaussian parameters */
@@ -26,6 +29,9 @@ typedef struct {
     double* cov;          /* [dim*dim] full covariance */
     double* cov_chol;     /* [dim*dim] lower Cholesky factor */
     double log_det;       /* log determinant of cov */
+    int rank;             /* q for COV_LOWRANK, else 0 */
+    double* loadings;     /* [dim*rank] W, row-major (COV_LOWRANK, else NULL) */
+    double* psi;          /* [dim] diagonal Ψ (COV_LOWRANK, else NULL) */
 } MVGaussParams;
 
 /* Result from multivariate EM */
@@ -54,11 +60,65 @@ typedef struct {
  * @param verbose  Print iteration info
  * @param result   Output
  * @return 0 on success
+ *
+ * Honors the multiresolution schedule (SetMultiresLevels): coarse levels
+ * run on nested subsamples and the final level on all n rows.
+ *
+ * COV_LOWRANK fits Σ_j = W_j W_jᵀ + Ψ_j (factor analyzers) in O(n·d·q·k)
+ * per iteration: densities through the Woodbury identity and the matrix
+ * determinant lemma, loadings and Ψ by the factor-analysis ECM update.
+ * cov and cov_chol are filled from W and Ψ when the fit ends.
+ *
+ * COV_TIED factors one d × d matrix per iteration instead of k: the
+ * E-step whitens each point once and compares it with the whitened means,
+ * and the M-step subtracts the between-component scatter from the total
+ * scatter, computed once per fit.  Every component holds the same cov.
+ *
+ * With SetEMAcceleration(1) (accel.h) EM is SQUAREM-accelerated on every
+ * level except kd-tree EM.
  */
 int UnmixMVGaussian(const double* data, size_t n, int d, int k,
                     CovType cov_type, int maxiter, double rtole,
                     int verbose, MVMixtureResult* result);
 
+/**
+ * Incremental (Neal–Hinton) MV Gaussian EM: B blocks with cached
+ * per-block sufficient statistics, one block E-step + closed-form M-step
+ * per step.  Same fixed point as UnmixMVGaussian, faster early progress.
+ *
+ * @param maxiter  Maximum passes over the data (each pass = B steps)
+ * @param nblocks  Number of blocks B (0 = default 32)
+ * @return 0 on success, -1 bad args (including COV_LOWRANK), -3 alloc failure
+ */
+int UnmixMVGaussianIncremental(const double* data, size_t n, int d, int k,
+                               CovType cov_type, int maxiter, double rtole,
+                               int nblocks, int verbose, MVMixtureResult* result);
+
+/**
+ * kd-tree EM (Moore 1999) for UnmixMVGaussian on low-dimensional data.
+ *
+ * With tau > 0 and d ≤ MV_KDTREE_MAX_DIM, the full-data EM of
+ * UnmixMVGaussian runs on a kd-tree built once per fit, whose nodes cache
+ * their count, bounding box, centroid and scatter.  A node whose k
+ * responsibility bounds (over its box) are all narrower than tau is
+ * assigned as a whole, at its centroid's responsibilities, from the
+ * cached statistics; only ambiguous leaves are evaluated row by row.  The
+ * per-iteration cost then grows with the number of cluster boundaries
+ * rather than with n.  tau trades accuracy for speed (1e-3 is a sensible
+ * start); the reported LL is exact for the returned parameters.
+ * COV_LOWRANK ignores it.  tau = 0 (the default) disables kd-tree EM.
+ */
+#define MV_KDTREE_MAX_DIM 8
+void   SetMVKdTreeTolerance(double tau);
+double GetMVKdTreeTolerance(void);
+
+/**
+ * Rank q of the COV_LOWRANK loadings.  0 (the default) picks ⌈√d⌉; q is
+ * clamped to [1, d − 1].
+ */
+void SetLowRankDim(int q);
+int  GetLowRankDim(void);
+
 /**
  * Release memory allocated by UnmixMVGaussian.
  */
@@ -99,6 +159,8 @@ typedef struct {
 /**
  * Multivariate Student-t mixture EM.
  * Robust to outliers due to heavy tails.
+ * COV_FULL, COV_DIAGONAL or COV_SPHERICAL; other types return -1.
+ * SQUAREM-accelerated like UnmixMVGaussian when enabled, ν included.
  */
 int UnmixMVStudentT(const double* data, size_t n, int d, int k,
                     CovType cov_type, int maxiter, double rtole,
@@ -0,0 +1,162 @@
+/*
+ * Copyright 2022-2026, Micah Thornton and Chanhee Park
+ * Background chunk reader for the streaming engines.
+ * License: GPL v3
+ */
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "prefetch.h"
+#include "walltime.h"
+
+#if defined(__unix__) || defined(__APPLE__)
+#define PREFETCH_THREADS 1
+#include <pthread.h>
+#include <unistd.h>
+#endif
+
+/*
+ * Ring protocol: slot s = i mod nbuf holds chunk i.  The reader may fill
+ * chunk i once the consumer has released chunk i - nbuf (released counts
+ * chunks handed back); the consumer may take chunk i once produced > i.
+ */
+struct ChunkPrefetch {
+    ChunkReadFn    fn;
+    void*          ctx;
+    size_t         max_rows;
+    size_t         width;
+    int            nbuf;
+    double*        buf[PREFETCH_MAX_BUFFERS];
+    const double*  rows[PREFETCH_MAX_BUFFERS];
+    size_t         count[PREFETCH_MAX_BUFFERS];
+    size_t         produced, consumed, released;
+    int            done, stop, held;
+    double         io_wait;
+#ifdef PREFETCH_THREADS
+    int            threaded;
+    pthread_t      thread;
+    pthread_mutex_t mu;
+    pthread_cond_t cv;
+#endif
+};
+
+#ifdef PREFETCH_THREADS
+/* Touch one byte per page so a mapped chunk is faulted in on this thread,
+ * not in the consumer's E-step */
+static void touch_pages(const double* rows, size_t nbytes, size_t page) {
+    const volatile char* p = (const volatile char*)rows;
+    for (size_t off = 0; off < nbytes; off += page) (void)p[off];
+}
+
+static void* reader_main(void* arg) {
+    ChunkPrefetch* p = (ChunkPrefetch*)arg;
+    long page = sysconf(_SC_PAGESIZE);
+    if (page <= 0) page = 4096;
+    for (;;) {
+        pthread_mutex_lock(&p->mu);
+        while (!p->stop && p->produced - p->released >= (size_t)p->nbuf)
+            pthread_cond_wait(&p->cv, &p->mu);
+        if (p->stop) { pthread_mutex_unlock(&p->mu); break; }
+        int s = (int)(p->produced % (size_t)p->nbuf);
+        pthread_mutex_unlock(&p->mu);
+
+        const double* rows = NULL;
+        size_t n = p->fn(p->ctx, p->buf[s], p->max_rows, &rows);
+        if (n > 0 && rows != p->buf[s])
+            touch_pages(rows, n * p->width * sizeof(double), (size_t)page);
+
+        pthread_mutex_lock(&p->mu);
+        p->rows[s] = rows;
+        p->count[s] = n;
+        if (n == 0) p->done = 1;
+        else p->produced++;
+        pthread_cond_broadcast(&p->cv);
+        pthread_mutex_unlock(&p->mu);
+        if (n == 0) break;
+    }
+    return NULL;
+}
+#endif
+
+ChunkPrefetch* ChunkPrefetchStart(ChunkReadFn fn, void* ctx, size_t max_rows,
+                                  size_t width, int nbuf) {
+    if (!fn || max_rows == 0 || width == 0) return NULL;
+    if (nbuf <= 0) nbuf = PREFETCH_DEFAULT_BUFFERS;
+    if (nbuf > PREFETCH_MAX_BUFFERS) nbuf = PREFETCH_MAX_BUFFERS;
+#ifndef PREFETCH_THREADS
+    nbuf = 1;
+#endif
+    ChunkPrefetch* p = (ChunkPrefetch*)calloc(1, sizeof(ChunkPrefetch));
+    if (!p) return NULL;
+    p->fn = fn;
+    p->ctx = ctx;
+    p->max_rows = max_rows;
+    p->width = width;
+    p->nbuf = nbuf;
+    for (int s = 0; s < nbuf; s++) {
+        p->buf[s] = (double*)malloc(sizeof(double) * max_rows * width);
+        if (!p->buf[s]) { ChunkPrefetchFinish(p, NULL); return NULL; }
+    }
+#ifdef PREFETCH_THREADS
+    if (nbuf > 1) {
+        pthread_mutex_init(&p->mu, NULL);
+        pthread_cond_init(&p->cv, NULL);
+        if (pthread_create(&p->thread, NULL, reader_main, p) == 0) {
+            p->threaded = 1;
+        } else {
+            pthread_mutex_destroy(&p->mu);
+            pthread_cond_destroy(&p->cv);
+            p->nbuf = 1;   /* no thread: read synchronously */
+        }
+    }
+#endif
+    return p;
+}
+
+size_t ChunkPrefetchNext(ChunkPrefetch* p, const double** rows) {
+#ifdef PREFETCH_THREADS
+    if (p->threaded) {
+        double t0 = WallSeconds();
+        pthread_mutex_lock(&p->mu);
+        if (p->held) { p->released++; p->held = 0; pthread_cond_broadcast(&p->cv); }
+        while (p->consumed == p->produced && !p->done)
+            pthread_cond_wait(&p->cv, &p->mu);
+        size_t n = 0;
+        if (p->consumed < p->produced) {
+            int s = (int)(p->consumed % (size_t)p->nbuf);
+            *rows = p->rows[s];
+            n = p->count[s];
+            p->consumed++;
+            p->held = 1;
+        }
+        pthread_mutex_unlock(&p->mu);
+        p->io_wait += WallSeconds() - t0;
+        return n;
+    }
+#endif
+    if (p->done) return 0;
+    double t0 = WallSeconds();
+    size_t n = p->fn(p->ctx, p->buf[0], p->max_rows, rows);
+    if (n == 0) p->done = 1;
+    p->io_wait += WallSeconds() - t0;
+    return n;
+}
+
+void ChunkPrefetchFinish(ChunkPrefetch* p, double* io_wait) {
+    if (!p) return;
+#ifdef PREFETCH_THREADS
+    if (p->threaded) {
+        pthread_mutex_lock(&p->mu);
+        p->stop = 1;
+        pthread_cond_broadcast(&p->cv);
+        pthread_mutex_unlock(&p->mu);
+        pthread_join(p->thread, NULL);
+        pthread_mutex_destroy(&p->mu);
+        pthread_cond_destroy(&p->cv);
+    }
+#endif
+    if (io_wait) *io_wait = p->io_wait;
+    for (int s = 0; s < PREFETCH_MAX_BUFFERS; s++) free(p->buf[s]);
+    free(p);
+}
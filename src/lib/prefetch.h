@@ -0,0 +1,59 @@
+/*
+ * Copyright 2022-2026, Micah Thornton and Chanhee Park
+ * Background chunk reader for the streaming engines: a producer thread
+ * fills a ring of chunk buffers while the caller runs EM on the last one.
+ * License: GPL v3
+ */
+#ifndef PREFETCH_H
+#define PREFETCH_H
+
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define PREFETCH_DEFAULT_BUFFERS 3   /* one in use + two read ahead */
+#define PREFETCH_MAX_BUFFERS     8
+
+/**
+ * Chunk source: read up to max rows into buf and point *rows at them
+ * (buf, or memory the source owns, e.g. a mapping).
+ * @return rows read; 0 at end of data
+ */
+typedef size_t (*ChunkReadFn)(void* ctx, double* buf, size_t max,
+                              const double** rows);
+
+typedef struct ChunkPrefetch ChunkPrefetch;
+
+/**
+ * Start reading one pass from the source's current position.
+ *
+ * @param max_rows  Rows per chunk
+ * @param width     Doubles per row (buffer size = max_rows × width)
+ * @param nbuf      Ring size; 1 (or no thread support) reads synchronously
+ *                  on the calling thread, ≤ 0 selects the default
+ * @return prefetcher, or NULL on allocation failure
+ */
+ChunkPrefetch* ChunkPrefetchStart(ChunkReadFn fn, void* ctx, size_t max_rows,
+                                  size_t width, int nbuf);
+
+/**
+ * Next chunk.  The previous chunk's buffer is handed back to the reader,
+ * so *rows is valid only until the next call.
+ * @return rows in the chunk; 0 at end of pass
+ */
+size_t ChunkPrefetchNext(ChunkPrefetch* p, const double** rows);
+
+/**
+ * Stop the reader (if still running) and free the prefetcher.
+ * @param io_wait  Output (may be NULL): seconds ChunkPrefetchNext spent
+ *                 waiting for data, i.e. I/O not hidden behind compute
+ */
+void ChunkPrefetchFinish(ChunkPrefetch* p, double* io_wait);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* PREFETCH_H */
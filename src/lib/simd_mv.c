@@ -0,0 +1,360 @@
+/*
+ * Copyright 2022-2026, Micah Thornton and Chanhee Park
+ * SIMD kernels for the multivariate engines.
+ *
+ * The covariance update S += Zᵀ·Z is a SYRK.  S is cut into 4-row strips;
+ * each strip is updated in 4 × 8 blocks (AVX2: 8 accumulator registers)
+ * by an outer-product kernel that, for every row t of the tile, broadcasts
+ * 4 values of Z[t, a..a+3] and multiplies them into Z[t, c..c+7].  Each
+ * row of Z is read once per block for 32 multiply-adds and nothing is
+ * reduced across lanes.  The tile is sized by the caller to stay in L1.
+ *
+ * Diagonal and spherical densities need no triangular solve: with the tile
+ * transposed (points along the unit stride) the distance is one fused
+ * multiply-add per dimension for 8 points at a time.
+ *
+ * For d ∈ {1, 2, 3, 4, 8} the kernels are generated per dimension by the
+ * MV_FIXED_* macros, so every loop over d has a constant trip count and
+ * unrolls: L, 1/L_aa and the mean stay in registers while the loop over
+ * points vectorizes.  The d = 4 and d = 8 covariance updates instead keep
+ * one point per vector (4 and 12 accumulator registers).
+ *
+ * License: GPL v3
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include "simd_mv.h"
+
+#ifdef _OPENMP
+#define MV_SIMD_PRAGMA _Pragma("omp simd")
+#else
+#define MV_SIMD_PRAGMA
+#endif
+#if defined(__GNUC__) || defined(__clang__)
+#define MV_UNROLL_PRAGMA _Pragma("GCC unroll 64")
+#else
+#define MV_UNROLL_PRAGMA
+#endif
+
+/* ── AVX2 + FMA detection via simde ────────────────────────────────── */
+#if defined(__AVX2__) || defined(SIMDE_ENABLE_NATIVE_ALIASES)
+  #define USE_AVX2_MV 1
+  #include "simde/x86/avx2.h"
+  #include "simde/x86/fma.h"
+#endif
+
+/* Portable 4 × 4 block: S[a..a+3][c..c+3] += Σ_t Z[t,a+i]·Z[t,c+q]
+ * (the compiler vectorizes the q loop) */
+static void syrk_block4x4(const double* Z, int nb, int d, int a, int c, double* S) {
+    double c0[4] = {0, 0, 0, 0}, c1[4] = {0, 0, 0, 0};
+    double c2[4] = {0, 0, 0, 0}, c3[4] = {0, 0, 0, 0};
+    for (int t = 0; t < nb; t++) {
+        const double* zt = Z + (size_t)t * d;
+        const double* y = zt + c;
+        double x0 = zt[a], x1 = zt[a + 1], x2 = zt[a + 2], x3 = zt[a + 3];
+        for (int q = 0; q < 4; q++) {
+            c0[q] += x0 * y[q];
+            c1[q] += x1 * y[q];
+            c2[q] += x2 * y[q];
+            c3[q] += x3 * y[q];
+        }
+    }
+    double* s0 = S + (size_t)a * d + c;
+    for (int q = 0; q < 4; q++) {
+        s0[q] += c0[q];
+        s0[d + q] += c1[q];
+        s0[2 * d + q] += c2[q];
+        s0[3 * d + q] += c3[q];
+    }
+}
+
+#ifdef USE_AVX2_MV
+/* 4 × 8 block with 8 accumulator registers */
+static void syrk_block4x8_avx2(const double* Z, int nb, int d, int a, int c, double* S) {
+    simde__m256d a00 = simde_mm256_setzero_pd(), a01 = simde_mm256_setzero_pd();
+    simde__m256d a10 = simde_mm256_setzero_pd(), a11 = simde_mm256_setzero_pd();
+    simde__m256d a20 = simde_mm256_setzero_pd(), a21 = simde_mm256_setzero_pd();
+    simde__m256d a30 = simde_mm256_setzero_pd(), a31 = simde_mm256_setzero_pd();
+    for (int t = 0; t < nb; t++) {
+        const double* zt = Z + (size_t)t * d;
+        simde__m256d y0 = simde_mm256_loadu_pd(zt + c);
+        simde__m256d y1 = simde_mm256_loadu_pd(zt + c + 4);
+        simde__m256d x;
+        x = simde_mm256_set1_pd(zt[a]);
+        a00 = simde_mm256_fmadd_pd(x, y0, a00); a01 = simde_mm256_fmadd_pd(x, y1, a01);
+        x = simde_mm256_set1_pd(zt[a + 1]);
+        a10 = simde_mm256_fmadd_pd(x, y0, a10); a11 = simde_mm256_fmadd_pd(x, y1, a11);
+        x = simde_mm256_set1_pd(zt[a + 2]);
+        a20 = simde_mm256_fmadd_pd(x, y0, a20); a21 = simde_mm256_fmadd_pd(x, y1, a21);
+        x = simde_mm256_set1_pd(zt[a + 3]);
+        a30 = simde_mm256_fmadd_pd(x, y0, a30); a31 = simde_mm256_fmadd_pd(x, y1, a31);
+    }
+    double* s = S + (size_t)a * d + c;
+    simde_mm256_storeu_pd(s,     simde_mm256_add_pd(simde_mm256_loadu_pd(s),     a00));
+    simde_mm256_storeu_pd(s + 4, simde_mm256_add_pd(simde_mm256_loadu_pd(s + 4), a01));
+    s += d;
+    simde_mm256_storeu_pd(s,     simde_mm256_add_pd(simde_mm256_loadu_pd(s),     a10));
+    simde_mm256_storeu_pd(s + 4, simde_mm256_add_pd(simde_mm256_loadu_pd(s + 4), a11));
+    s += d;
+    simde_mm256_storeu_pd(s,     simde_mm256_add_pd(simde_mm256_loadu_pd(s),     a20));
+    simde_mm256_storeu_pd(s + 4, simde_mm256_add_pd(simde_mm256_loadu_pd(s + 4), a21));
+    s += d;
+    simde_mm256_storeu_pd(s,     simde_mm256_add_pd(simde_mm256_loadu_pd(s),     a30));
+    simde_mm256_storeu_pd(s + 4, simde_mm256_add_pd(simde_mm256_loadu_pd(s + 4), a31));
+}
+#endif
+
+void simd_mv_syrk(const double* Z, int nb, int d, double* S) {
+    int d4 = d & ~3;
+    for (int a = 0; a < d4; a += 4) {
+        int c = a;
+#ifdef USE_AVX2_MV
+        for (; c + 8 <= d4; c += 8) syrk_block4x8_avx2(Z, nb, d, a, c, S);
+#endif
+        for (; c < d4; c += 4) syrk_block4x4(Z, nb, d, a, c, S);
+    }
+    /* Columns past the last multiple of 4 */
+    if (d4 < d) {
+        for (int t = 0; t < nb; t++) {
+            const double* zt = Z + (size_t)t * d;
+            for (int a = 0; a < d; a++) {
+                double za = zt[a];
+                for (int c = a > d4 ? a : d4; c < d; c++) S[(size_t)a * d + c] += za * zt[c];
+            }
+        }
+    }
+}
+
+void simd_mv_diag_mahalanobis(const double* Y, int B, int nb, int d,
+                              const double* mean, const double* ivar, double* mah) {
+    int b = 0;
+#ifdef USE_AVX2_MV
+    for (; b + 8 <= nb; b += 8) {
+        simde__m256d acc0 = simde_mm256_setzero_pd(), acc1 = simde_mm256_setzero_pd();
+        for (int a = 0; a < d; a++) {
+            const double* ya = Y + (size_t)a * B + b;
+            simde__m256d m = simde_mm256_set1_pd(mean[a]);
+            simde__m256d w = simde_mm256_set1_pd(ivar[a]);
+            simde__m256d y0 = simde_mm256_sub_pd(simde_mm256_loadu_pd(ya), m);
+            simde__m256d y1 = simde_mm256_sub_pd(simde_mm256_loadu_pd(ya + 4), m);
+            acc0 = simde_mm256_fmadd_pd(simde_mm256_mul_pd(y0, w), y0, acc0);
+            acc1 = simde_mm256_fmadd_pd(simde_mm256_mul_pd(y1, w), y1, acc1);
+        }
+        simde_mm256_storeu_pd(mah + b, acc0);
+        simde_mm256_storeu_pd(mah + b + 4, acc1);
+    }
+#endif
+    for (int t = b; t < nb; t++) mah[t] = 0;
+    for (int a = 0; a < d; a++) {
+        const double* ya = Y + (size_t)a * B;
+        double ma = mean[a], wa = ivar[a];
+        for (int t = b; t < nb; t++) {
+            double y = ya[t] - ma;
+            mah[t] += y * wa * y;
+        }
+    }
+}
+
+void simd_mv_sph_mahalanobis(const double* Y, int B, int nb, int d,
+                             const double* mean, double iv, double* mah) {
+    int b = 0;
+#ifdef USE_AVX2_MV
+    simde__m256d w = simde_mm256_set1_pd(iv);
+    for (; b + 8 <= nb; b += 8) {
+        simde__m256d acc0 = simde_mm256_setzero_pd(), acc1 = simde_mm256_setzero_pd();
+        for (int a = 0; a < d; a++) {
+            const double* ya = Y + (size_t)a * B + b;
+            simde__m256d m = simde_mm256_set1_pd(mean[a]);
+            simde__m256d y0 = simde_mm256_sub_pd(simde_mm256_loadu_pd(ya), m);
+            simde__m256d y1 = simde_mm256_sub_pd(simde_mm256_loadu_pd(ya + 4), m);
+            acc0 = simde_mm256_fmadd_pd(y0, y0, acc0);
+            acc1 = simde_mm256_fmadd_pd(y1, y1, acc1);
+        }
+        simde_mm256_storeu_pd(mah + b, simde_mm256_mul_pd(acc0, w));
+        simde_mm256_storeu_pd(mah + b + 4, simde_mm256_mul_pd(acc1, w));
+    }
+#endif
+    for (int t = b; t < nb; t++) mah[t] = 0;
+    for (int a = 0; a < d; a++) {
+        const double* ya = Y + (size_t)a * B;
+        double ma = mean[a];
+        for (int t = b; t < nb; t++) {
+            double y = ya[t] - ma;
+            mah[t] += y * y;
+        }
+    }
+    for (int t = b; t < nb; t++) mah[t] *= iv;
+}
+
+
+/* ── Fixed-dimension kernels ───────────────────────────────────────── */
+
+/* Forward substitution as in mahalanobis_sq(), with the divisions by
+ * L_aa hoisted into reciprocals */
+#define MV_FIXED_MAHALANOBIS(D)                                              \
+static void mahalanobis_d##D(const double* X, int nb, const double* mean,    \
+                             const double* L, double* mah) {                 \
+    double l[D * D], m[D], il[D];                                            \
+    memcpy(l, L, sizeof(l));                                                 \
+    memcpy(m, mean, sizeof(m));                                              \
+    for (int a = 0; a < D; a++) il[a] = 1.0 / l[a * D + a];                  \
+    MV_SIMD_PRAGMA                                                           \
+    for (int b = 0; b < nb; b++) {                                           \
+        const double* x = X + (size_t)b * D;                                 \
+        double y[D], s = 0;                                                  \
+        MV_UNROLL_PRAGMA                                                     \
+        for (int a = 0; a < D; a++) {                                        \
+            double v = x[a] - m[a];                                          \
+            MV_UNROLL_PRAGMA                                                 \
+            for (int c = 0; c < a; c++) v -= l[a * D + c] * y[c];            \
+            y[a] = v * il[a];                                                \
+            s += y[a] * y[a];                                                \
+        }                                                                    \
+        mah[b] = s;                                                          \
+    }                                                                        \
+}
+
+/* Per component, the d(d+1)/2 sums of w·(x − μ)(x − μ)ᵀ over all rows */
+#define MV_FIXED_SCATTER(D)                                                  \
+static void scatter_d##D(const double* X, size_t m, int k,                   \
+                         const double* resp, const double* u,                \
+                         const double* mu, double* S) {                      \
+    for (int j = 0; j < k; j++) {                                            \
+        double mj[D], acc[D * (D + 1) / 2] = {0};                            \
+        memcpy(mj, mu + (size_t)j * D, sizeof(mj));                          \
+        for (size_t i = 0; i < m; i++) {                                     \
+            size_t q = i * k + j;                                            \
+            double w = u ? resp[q] * u[q] : resp[q];                         \
+            double z[D];                                                     \
+            MV_UNROLL_PRAGMA                                                 \
+            for (int a = 0; a < D; a++) z[a] = X[i * D + a] - mj[a];         \
+            int t = 0;                                                       \
+            MV_UNROLL_PRAGMA                                                 \
+            for (int a = 0; a < D; a++) {                                    \
+                double wa = w * z[a];                                        \
+                MV_UNROLL_PRAGMA                                             \
+                for (int c = a; c < D; c++) acc[t++] += wa * z[c];           \
+            }                                                                \
+        }                                                                    \
+        double* Sj = S + (size_t)j * D * D;                                  \
+        int t = 0;                                                           \
+        for (int a = 0; a < D; a++)                                          \
+            for (int c = a; c < D; c++) Sj[a * D + c] += acc[t++];           \
+    }                                                                        \
+}
+
+MV_FIXED_MAHALANOBIS(1)
+MV_FIXED_MAHALANOBIS(2)
+MV_FIXED_MAHALANOBIS(3)
+MV_FIXED_MAHALANOBIS(4)
+MV_FIXED_MAHALANOBIS(8)
+MV_FIXED_SCATTER(1)
+MV_FIXED_SCATTER(2)
+MV_FIXED_SCATTER(3)
+
+#ifdef USE_AVX2_MV
+#define MV_ACC_STORE(p, v) simde_mm256_storeu_pd(p, simde_mm256_add_pd(simde_mm256_loadu_pd(p), v))
+
+/* d = 4: one point per vector, row a of S_j += (w·z_a)·z */
+static void scatter_d4(const double* X, size_t m, int k,
+                       const double* resp, const double* u,
+                       const double* mu, double* S) {
+    for (int j = 0; j < k; j++) {
+        simde__m256d mj = simde_mm256_loadu_pd(mu + (size_t)j * 4);
+        simde__m256d a0 = simde_mm256_setzero_pd(), a1 = a0, a2 = a0, a3 = a0;
+        for (size_t i = 0; i < m; i++) {
+            size_t q = i * k + j;
+            double w = u ? resp[q] * u[q] : resp[q];
+            simde__m256d z = simde_mm256_sub_pd(simde_mm256_loadu_pd(X + i * 4), mj);
+            simde__m256d wz = simde_mm256_mul_pd(simde_mm256_set1_pd(w), z);
+            a0 = simde_mm256_fmadd_pd(simde_mm256_permute4x64_pd(wz, 0x00), z, a0);
+            a1 = simde_mm256_fmadd_pd(simde_mm256_permute4x64_pd(wz, 0x55), z, a1);
+            a2 = simde_mm256_fmadd_pd(simde_mm256_permute4x64_pd(wz, 0xAA), z, a2);
+            a3 = simde_mm256_fmadd_pd(simde_mm256_permute4x64_pd(wz, 0xFF), z, a3);
+        }
+        double* s = S + (size_t)j * 16;
+        MV_ACC_STORE(s, a0);
+        MV_ACC_STORE(s + 4, a1);
+        MV_ACC_STORE(s + 8, a2);
+        MV_ACC_STORE(s + 12, a3);
+    }
+}
+
+/* d = 8: rows 0-3 need both halves of a row, rows 4-7 only columns 4-7,
+ * so the upper triangle is 12 accumulator registers */
+static void scatter_d8(const double* X, size_t m, int k,
+                       const double* resp, const double* u,
+                       const double* mu, double* S) {
+    for (int j = 0; j < k; j++) {
+        const double* mj = mu + (size_t)j * 8;
+        simde__m256d m0 = simde_mm256_loadu_pd(mj), m1 = simde_mm256_loadu_pd(mj + 4);
+        simde__m256d a00 = simde_mm256_setzero_pd(), a01 = a00, a10 = a00, a11 = a00;
+        simde__m256d a20 = a00, a21 = a00, a30 = a00, a31 = a00;
+        simde__m256d a41 = a00, a51 = a00, a61 = a00, a71 = a00;
+        for (size_t i = 0; i < m; i++) {
+            size_t q = i * k + j;
+            double w = u ? resp[q] * u[q] : resp[q];
+            const double* x = X + i * 8;
+            simde__m256d z0 = simde_mm256_sub_pd(simde_mm256_loadu_pd(x), m0);
+            simde__m256d z1 = simde_mm256_sub_pd(simde_mm256_loadu_pd(x + 4), m1);
+            simde__m256d wv = simde_mm256_set1_pd(w);
+            simde__m256d w0 = simde_mm256_mul_pd(wv, z0), w1 = simde_mm256_mul_pd(wv, z1);
+            simde__m256d b;
+            b = simde_mm256_permute4x64_pd(w0, 0x00);
+            a00 = simde_mm256_fmadd_pd(b, z0, a00); a01 = simde_mm256_fmadd_pd(b, z1, a01);
+            b = simde_mm256_permute4x64_pd(w0, 0x55);
+            a10 = simde_mm256_fmadd_pd(b, z0, a10); a11 = simde_mm256_fmadd_pd(b, z1, a11);
+            b = simde_mm256_permute4x64_pd(w0, 0xAA);
+            a20 = simde_mm256_fmadd_pd(b, z0, a20); a21 = simde_mm256_fmadd_pd(b, z1, a21);
+            b = simde_mm256_permute4x64_pd(w0, 0xFF);
+            a30 = simde_mm256_fmadd_pd(b, z0, a30); a31 = simde_mm256_fmadd_pd(b, z1, a31);
+            a41 = simde_mm256_fmadd_pd(simde_mm256_permute4x64_pd(w1, 0x00), z1, a41);
+            a51 = simde_mm256_fmadd_pd(simde_mm256_permute4x64_pd(w1, 0x55), z1, a51);
+            a61 = simde_mm256_fmadd_pd(simde_mm256_permute4x64_pd(w1, 0xAA), z1, a61);
+            a71 = simde_mm256_fmadd_pd(simde_mm256_permute4x64_pd(w1, 0xFF), z1, a71);
+        }
+        double* s = S + (size_t)j * 64;
+        MV_ACC_STORE(s, a00);      MV_ACC_STORE(s + 4, a01);
+        MV_ACC_STORE(s + 8, a10);  MV_ACC_STORE(s + 12, a11);
+        MV_ACC_STORE(s + 16, a20); MV_ACC_STORE(s + 20, a21);
+        MV_ACC_STORE(s + 24, a30); MV_ACC_STORE(s + 28, a31);
+        MV_ACC_STORE(s + 36, a41);
+        MV_ACC_STORE(s + 44, a51);
+        MV_ACC_STORE(s + 52, a61);
+        MV_ACC_STORE(s + 60, a71);
+    }
+}
+#else
+MV_FIXED_SCATTER(4)
+MV_FIXED_SCATTER(8)
+#endif
+
+int simd_mv_fixed_dim(int d) {
+    return d == 1 || d == 2 || d == 3 || d == 4 || d == 8;
+}
+
+void simd_mv_mahalanobis_fixed(const double* X, int nb, int d, const double* mean,
+                               const double* L, double* mah) {
+    switch (d) {
+        case 1: mahalanobis_d1(X, nb, mean, L, mah); break;
+        case 2: mahalanobis_d2(X, nb, mean, L, mah); break;
+        case 3: mahalanobis_d3(X, nb, mean, L, mah); break;
+        case 4: mahalanobis_d4(X, nb, mean, L, mah); break;
+        case 8: mahalanobis_d8(X, nb, mean, L, mah); break;
+        default: break;
+    }
+}
+
+void simd_mv_scatter_fixed(const double* X, size_t m, int d, int k,
+                           const double* resp, const double* u,
+                           const double* mu, double* S) {
+    switch (d) {
+        case 1: scatter_d1(X, m, k, resp, u, mu, S); break;
+        case 2: scatter_d2(X, m, k, resp, u, mu, S); break;
+        case 3: scatter_d3(X, m, k, resp, u, mu, S); break;
+        case 4: scatter_d4(X, m, k, resp, u, mu, S); break;
+        case 8: scatter_d8(X, m, k, resp, u, mu, S); break;
+        default: break;
+    }
+}
@@ -0,0 +1,70 @@
+/*
+ * Copyright 2022-2026, Micah Thornton and Chanhee Park
+ * SIMD kernels for the multivariate Gaussian / Student-t engines.
+ * Uses AVX2 + FMA via simde headers — falls back to portable C otherwise.
+ * License: GPL v3
+ */
+#ifndef SIMD_MV_H
+#define SIMD_MV_H
+
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * Symmetric rank-nb update of a scatter matrix:
+ *
+ *   S += Zᵀ · Z
+ *
+ * Z[nb × d]:  row-major tile (row t at Z + t·d), already centred and
+ *             scaled by √weight
+ * S[d × d]:   row-major; the upper triangle (a ≤ c) is updated.  Entries
+ *             below the diagonal inside diagonal 4 × 4 blocks are written
+ *             too and must be ignored by the caller.
+ */
+void simd_mv_syrk(const double* Z, int nb, int d, double* S);
+
+/*
+ * Squared Mahalanobis distances for a diagonal covariance, across a tile
+ * of points:
+ *
+ *   mah[b] = Σ_a (Y[a·B + b] − mean[a])² · ivar[a],   b < nb
+ *
+ * Y[d × B]:   the tile transposed (dimension a of point b at a·B + b)
+ * ivar[d]:    inverse variances
+ */
+void simd_mv_diag_mahalanobis(const double* Y, int B, int nb, int d,
+                              const double* mean, const double* ivar, double* mah);
+
+/* Spherical covariance: mah[b] = iv · Σ_a (Y[a·B + b] − mean[a])² */
+void simd_mv_sph_mahalanobis(const double* Y, int B, int nb, int d,
+                             const double* mean, double iv, double* mah);
+
+/*
+ * Kernels specialized for small fixed dimensions, d ∈ {1, 2, 3, 4, 8}:
+ * the triangular solve and the covariance update are fully unrolled and
+ * vectorized, reading the row-major points directly.
+ */
+int simd_mv_fixed_dim(int d);   /* 1 when d has specialized kernels */
+
+/* mah[b] = ‖L⁻¹(X[b] − mean)‖², b < nb; X row-major nb × d, L the lower
+ * Cholesky factor (d × d row-major) */
+void simd_mv_mahalanobis_fixed(const double* X, int nb, int d, const double* mean,
+                               const double* L, double* mah);
+
+/*
+ * S_j += Σ_i w_ij (X[i] − μ_j)(X[i] − μ_j)ᵀ for the m rows of X and all k
+ * components, w_ij = resp[i·k+j] · u[i·k+j] (u may be NULL).  S is k × d × d,
+ * μ is k × d; as with simd_mv_syrk() only the upper triangles are defined.
+ */
+void simd_mv_scatter_fixed(const double* X, size_t m, int d, int k,
+                           const double* resp, const double* u,
+                           const double* mu, double* S);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* SIMD_MV_H */
@@ -0,0 +1,432 @@
+/*
+ * Copyright 2022-2026, Micah Thornton and Chanhee Park
+ * Sparse-responsibility EM for univariate mixtures with many components.
+ * License: GPL v3
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <float.h>
+
+#include "sparse_em.h"
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+/* ════════════════════════════════════════════════════════════════════
+ * Supported families
+ *
+ * Every supported family is symmetric and unimodal in location-scale
+ * form:  logpdf(x | μ, s) = g(|x − μ| / s) − log s  with g decreasing.
+ * That is what makes the window bound below valid.  g and s mirror the
+ * family implementations in distributions.c (including their floors).
+ * ════════════════════════════════════════════════════════════════════ */
+
+static int sparse_family_ok(DistFamily f) {
+    return f == DIST_GAUSSIAN || f == DIST_LAPLACE ||
+           f == DIST_LOGISTIC || f == DIST_CAUCHY;
+}
+
+/* Standardized log-density g(z), z ≥ 0 */
+static inline double std_logpdf(DistFamily f, double z) {
+    switch (f) {
+    case DIST_GAUSSIAN: return -0.5 * log(2 * M_PI) - 0.5 * z * z;
+    case DIST_LAPLACE:  return -log(2.0) - z;
+    case DIST_LOGISTIC: return -z - 2 * log1p(exp(-z));
+    case DIST_CAUCHY:   return -log(M_PI) - log1p(z * z);
+    default:            return 0;
+    }
+}
+
+/* Scale s as used by the family's logpdf */
+static double family_scale(DistFamily f, const DistParams* p) {
+    switch (f) {
+    case DIST_GAUSSIAN: return sqrt(p->p[1] > 0 ? p->p[1] : 1e-10);
+    case DIST_LOGISTIC: return fmax(p->p[1], 1e-10);
+    default:            return p->p[1] > 0 ? p->p[1] : 1e-10;
+    }
+}
+
+/* Inverse of family_scale, for writing initial parameters */
+static void set_family_scale(DistFamily f, DistParams* p, double s) {
+    p->p[1] = (f == DIST_GAUSSIAN) ? s * s : s;
+    p->nparams = 2;
+}
+
+typedef struct { double mu; int j; } SortedComp;
+
+static int cmp_double(const void* a, const void* b) {
+    double x = *(const double*)a, y = *(const double*)b;
+    return (x > y) - (x < y);
+}
+
+static int cmp_comp(const void* a, const void* b) {
+    const SortedComp* x = (const SortedComp*)a;
+    const SortedComp* y = (const SortedComp*)b;
+    if (x->mu != y->mu) return (x->mu > y->mu) - (x->mu < y->mu);
+    return x->j - y->j;
+}
+
+/* Grow a CSR-style buffer pair so it can hold at least `need` entries */
+static int ensure_cap(size_t need, size_t* cap, int** col, double** val) {
+    if (need <= *cap) return 0;
+    size_t nc = *cap * 2;
+    if (nc < need) nc = need;
+    int* c = (int*)realloc(*col, sizeof(int) * nc);
+    if (!c) return -1;
+    *col = c;
+    double* v = (double*)realloc(*val, sizeof(double) * nc);
+    if (!v) return -1;
+    *val = v;
+    *cap = nc;
+    return 0;
+}
+
+/* Same for the M-step's gathered (x, r) pairs */
+static int ensure_cap2(size_t need, size_t* cap, double** a, double** b) {
+    if (need <= *cap) return 0;
+    size_t nc = *cap * 2;
+    if (nc < need) nc = need;
+    double* pa = (double*)realloc(*a, sizeof(double) * nc);
+    if (!pa) return -1;
+    *a = pa;
+    double* pb = (double*)realloc(*b, sizeof(double) * nc);
+    if (!pb) return -1;
+    *b = pb;
+    *cap = nc;
+    return 0;
+}
+
+/* ════════════════════════════════════════════════════════════════════
+ * Windowed E-step
+ *
+ * For point x, let lp* be the largest log-term evaluated so far.  Any
+ * component j at distance D = |x − μⱼ| satisfies
+ *
+ *     log wⱼ − log sⱼ + g(D/sⱼ)  ≤  C_max + g(D/s_max),
+ *     C_max = maxⱼ (log wⱼ − log sⱼ),   s_max = maxⱼ sⱼ,
+ *
+ * because g is decreasing and D/sⱼ ≥ D/s_max.  With components sorted
+ * by μ, D grows monotonically as we walk outward from the point, so the
+ * first component whose bound falls below lp* − T (T = −log ε) ends the
+ * walk in that direction — everything beyond it is provably below
+ * ε·exp(lp*) ≤ ε·max term.  lp* only grows while walking, so testing
+ * against the running value is conservative.
+ *
+ * Rows are written in sorted-data order; col holds original component
+ * indices.  Returns the (truncated) LL and adds the error bound to *err.
+ * ════════════════════════════════════════════════════════════════════ */
+static double sparse_estep(const double* xs, size_t n, DistFamily family, int k,
+                           const SortedComp* sc, const double* lc,
+                           const double* inv_s, double c_max, double inv_smax,
+                           double T, double eps,
+                           size_t* row_ptr, int** col, double** val, size_t* cap,
+                           double* lp_buf, int* r_buf, double* err, int* rc)
+{
+    double ll = 0;
+    size_t nnz = 0;
+    int pos = 0;   /* first sorted component with μ ≥ x */
+    *err = 0;
+    *rc = 0;
+
+    for (size_t i = 0; i < n; i++) {
+        double x = xs[i];
+        while (pos < k && sc[pos].mu < x) pos++;
+
+        int cnt = 0;
+        double lp_max = -DBL_MAX;
+
+        /* Seed with the neighbours straddling x */
+        for (int r = pos - 1; r <= pos; r++) {
+            if (r < 0 || r >= k) continue;
+            double lp = lc[r] + std_logpdf(family, fabs(x - sc[r].mu) * inv_s[r]);
+            lp_buf[cnt] = lp; r_buf[cnt] = r; cnt++;
+            if (lp > lp_max) lp_max = lp;
+        }
+        /* Walk left */
+        for (int r = pos - 2; r >= 0; r--) {
+            double D = x - sc[r].mu;
+            if (c_max + std_logpdf(family, D * inv_smax) < lp_max - T) break;
+            double lp = lc[r] + std_logpdf(family, D * inv_s[r]);
+            lp_buf[cnt] = lp; r_buf[cnt] = r; cnt++;
+            if (lp > lp_max) lp_max = lp;
+        }
+        /* Walk right */
+        for (int r = pos + 1; r < k; r++) {
+            double D = sc[r].mu - x;
+            if (c_max + std_logpdf(family, D * inv_smax) < lp_max - T) break;
+            double lp = lc[r] + std_logpdf(family, D * inv_s[r]);
+            lp_buf[cnt] = lp; r_buf[cnt] = r; cnt++;
+            if (lp > lp_max) lp_max = lp;
+        }
+
+        if (ensure_cap(nnz + cnt, cap, col, val) != 0) { *rc = -3; return ll; }
+
+        double total = 0;
+        for (int c = 0; c < cnt; c++) {
+            lp_buf[c] = exp(lp_buf[c] - lp_max);
+            total += lp_buf[c];
+        }
+        double inv_total = 1.0 / total;
+        row_ptr[i] = nnz;
+        for (int c = 0; c < cnt; c++) {
+            (*col)[nnz] = sc[r_buf[c]].j;
+            (*val)[nnz] = lp_buf[c] * inv_total;
+            nnz++;
+        }
+        ll += lp_max + log(total);
+        if (cnt < k) *err += log1p((double)(k - cnt) * eps);
+    }
+    row_ptr[n] = nnz;
+    return ll;
+}
+
+/* ════════════════════════════════════════════════════════════════════
+ * Public entry point
+ * ════════════════════════════════════════════════════════════════════ */
+
+/* ════════════════════════════════════════════════════════════════════
+ * Initialization
+ *
+ * Quantile centers refined by 1-D Lloyd iterations.  On sorted data every
+ * k-means cluster is a contiguous run bounded by midpoints between
+ * neighbouring centers, so with prefix sums of x and x² one Lloyd step
+ * costs O(k log n) rather than O(n·k).  Scale = cluster SD (floored at
+ * 10⁻³ of the global SD), weight = cluster fraction.
+ * ════════════════════════════════════════════════════════════════════ */
+
+/* First index i in sorted xs[0..n) with xs[i] >= v */
+static size_t lower_bound(const double* xs, size_t n, double v) {
+    size_t lo = 0, hi = n;
+    while (lo < hi) {
+        size_t mid = lo + (hi - lo) / 2;
+        if (xs[mid] < v) lo = mid + 1; else hi = mid;
+    }
+    return lo;
+}
+
+static int sorted_lloyd_init(const double* xs, size_t n, int k, DistFamily family,
+                             DistParams* params, double* weights)
+{
+    double* s1  = (double*)malloc(sizeof(double) * (n + 1));
+    double* s2  = (double*)malloc(sizeof(double) * (n + 1));
+    size_t* cut = (size_t*)malloc(sizeof(size_t) * (k + 1));
+    double* mu  = (double*)malloc(sizeof(double) * k);
+    if (!s1 || !s2 || !cut || !mu) { free(s1); free(s2); free(cut); free(mu); return -3; }
+
+    /* Prefix sums of the data shifted by its mean, for cancellation safety */
+    double shift = 0;
+    for (size_t i = 0; i < n; i++) shift += xs[i];
+    shift /= n;
+    s1[0] = s2[0] = 0;
+    for (size_t i = 0; i < n; i++) {
+        double y = xs[i] - shift;
+        s1[i + 1] = s1[i] + y;
+        s2[i + 1] = s2[i] + y * y;
+    }
+    double gvar = s2[n] / n - (s1[n] / n) * (s1[n] / n);
+    double s_floor = gvar > 0 ? 1e-3 * sqrt(gvar) : 1e-5;
+
+    for (int j = 0; j < k; j++)
+        mu[j] = xs[(size_t)(((double)j + 0.5) * n / k)];
+
+    cut[0] = 0;
+    cut[k] = n;
+    for (int it = 0; it < 100; it++) {
+        /* Centers stay sorted, so the cuts are the midpoints between them */
+        for (int j = 1; j < k; j++)
+            cut[j] = lower_bound(xs, n, 0.5 * (mu[j - 1] + mu[j]));
+        int moved = 0;
+        for (int j = 0; j < k; j++) {
+            size_t cnt = cut[j + 1] - cut[j];
+            if (cnt == 0) continue;
+            double c = shift + (s1[cut[j + 1]] - s1[cut[j]]) / cnt;
+            if (c != mu[j]) { mu[j] = c; moved = 1; }
+        }
+        if (!moved) break;
+    }
+    for (int j = 1; j < k; j++)
+        cut[j] = lower_bound(xs, n, 0.5 * (mu[j - 1] + mu[j]));
+
+    for (int j = 0; j < k; j++) {
+        size_t cnt = cut[j + 1] - cut[j];
+        double s;
+        if (cnt > 1) {
+            double a = (s1[cut[j + 1]] - s1[cut[j]]) / cnt;
+            double v = (s2[cut[j + 1]] - s2[cut[j]]) / cnt - a * a;
+            s = v > 0 ? sqrt(v) : 0;
+        } else {
+            /* Empty or singleton cluster: half the gap to its neighbours */
+            double lo = mu[j > 0 ? j - 1 : j], hi = mu[j < k - 1 ? j + 1 : j];
+            s = 0.5 * (hi - lo);
+        }
+        if (!(s > s_floor)) s = s_floor;
+        params[j].p[0] = mu[j];
+        set_family_scale(family, &params[j], s);
+        weights[j] = (cnt > 0 ? (double)cnt : 1.0) / n;
+    }
+    double wsum = 0;
+    for (int j = 0; j < k; j++) wsum += weights[j];
+    for (int j = 0; j < k; j++) weights[j] /= wsum;
+
+    free(s1); free(s2); free(cut); free(mu);
+    return 0;
+}
+
+
+int UnmixGenericSparse(const double* data, size_t n, DistFamily family, int k,
+                       int maxiter, double rtole, double trunc_eps, int verbose,
+                       MixtureResult* result, double* ll_err_bound)
+{
+    if (!data || n == 0 || k <= 0 || !result) return -1;
+    memset(result, 0, sizeof(*result));
+    if (!sparse_family_ok(family)) return -2;
+    const DistFunctions* df = GetDistFunctions(family);
+    if (!df) return -2;
+
+    double eps = (trunc_eps > 0 && trunc_eps < 1) ? trunc_eps : SPARSE_EM_DEFAULT_EPS;
+    double T = -log(eps);
+
+    /* Sort a finite-only copy of the data once */
+    double* xs = (double*)malloc(sizeof(double) * n);
+    if (!xs) return -3;
+    size_t m = 0;
+    for (size_t i = 0; i < n; i++)
+        if (isfinite(data[i])) xs[m++] = data[i];
+    if (m < (size_t)k) { free(xs); return -1; }
+    n = m;
+    qsort(xs, n, sizeof(double), cmp_double);
+
+    result->family = family;
+    result->num_components = k;
+    result->mixing_weights = (double*)malloc(sizeof(double) * k);
+    result->params = (DistParams*)calloc(k, sizeof(DistParams));
+
+    SortedComp* sc   = (SortedComp*)malloc(sizeof(SortedComp) * k);
+    double* lc       = (double*)malloc(sizeof(double) * k);
+    double* inv_s    = (double*)malloc(sizeof(double) * k);
+    double* lp_buf   = (double*)malloc(sizeof(double) * k);
+    int*    r_buf    = (int*)malloc(sizeof(int) * k);
+    size_t* comp_ptr = (size_t*)malloc(sizeof(size_t) * (k + 1));
+    size_t* fill     = (size_t*)malloc(sizeof(size_t) * k);
+    double* nj       = (double*)malloc(sizeof(double) * k);
+    size_t* row_ptr  = (size_t*)malloc(sizeof(size_t) * (n + 1));
+    size_t cap = n * 4, gcap = n * 4;
+    int*    col = (int*)malloc(sizeof(int) * cap);
+    double* val = (double*)malloc(sizeof(double) * cap);
+    double* gx  = (double*)malloc(sizeof(double) * gcap);
+    double* gw  = (double*)malloc(sizeof(double) * gcap);
+
+    int rc = 0;
+    if (!result->mixing_weights || !result->params || !sc || !lc || !inv_s ||
+        !lp_buf || !r_buf || !comp_ptr || !fill || !nj || !row_ptr || !col ||
+        !val || !gx || !gw) {
+        rc = -3;
+        goto done;
+    }
+
+    /* ─── Initialization: 1-D Lloyd on the sorted data ─── */
+    if (sorted_lloyd_init(xs, n, k, family, result->params,
+                          result->mixing_weights) != 0) {
+        rc = -3;
+        goto done;
+    }
+
+    double prev_ll = -1e30, ll = 0, err = 0;
+    int iter;
+    for (iter = 0; iter < maxiter; iter++) {
+        /* Sort components by location; precompute per-component constants */
+        double c_max = -DBL_MAX, s_max = 0;
+        for (int j = 0; j < k; j++) {
+            sc[j].mu = result->params[j].p[0];
+            sc[j].j = j;
+        }
+        qsort(sc, k, sizeof(SortedComp), cmp_comp);
+        for (int r = 0; r < k; r++) {
+            int j = sc[r].j;
+            double s = family_scale(family, &result->params[j]);
+            double w = result->mixing_weights[j] > 1e-300 ? result->mixing_weights[j] : 1e-300;
+            inv_s[r] = 1.0 / s;
+            lc[r] = log(w) - log(s);
+            if (lc[r] > c_max) c_max = lc[r];
+            if (s > s_max) s_max = s;
+        }
+
+        /* ---- E-step ---- */
+        ll = sparse_estep(xs, n, family, k, sc, lc, inv_s, c_max, 1.0 / s_max,
+                          T, eps, row_ptr, &col, &val, &cap, lp_buf, r_buf, &err, &rc);
+        if (rc != 0) goto done;
+        size_t nnz = row_ptr[n];
+
+        if (verbose) {
+            printf("  [%s k=%d sparse] iter %d  LL=%.4f  delta=%.2e  window=%.1f  err<=%.2e\n",
+                   df->name, k, iter, ll, ll - prev_ll, (double)nnz / n, err);
+        }
+
+        if (iter > 0 && fabs(ll - prev_ll) < rtole) {
+            prev_ll = ll;
+            iter++;
+            break;
+        }
+        prev_ll = ll;
+
+        /* ---- M-step from CSR ----
+         * Transpose rows → per-component runs of (x, r) pairs, then run the
+         * family's weighted MLE on each run.  Points outside a component's
+         * windows have r = 0 and contribute nothing, so this is the same
+         * estimate the dense M-step computes. */
+        if (ensure_cap2(nnz, &gcap, &gx, &gw) != 0) { rc = -3; goto done; }
+        memset(comp_ptr, 0, sizeof(size_t) * (k + 1));
+        for (size_t e = 0; e < nnz; e++) comp_ptr[col[e] + 1]++;
+        for (int j = 0; j < k; j++) comp_ptr[j + 1] += comp_ptr[j];
+        memset(nj, 0, sizeof(double) * k);
+        memcpy(fill, comp_ptr, sizeof(size_t) * k);
+        for (size_t i = 0; i < n; i++) {
+            for (size_t e = row_ptr[i]; e < row_ptr[i + 1]; e++) {
+                int j = col[e];
+                size_t at = fill[j]++;
+                gx[at] = xs[i];
+                gw[at] = val[e];
+                nj[j] += val[e];
+            }
+        }
+
+        for (int j = 0; j < k; j++) {
+            result->mixing_weights[j] = nj[j] / n;
+            if (result->mixing_weights[j] < 1e-10) result->mixing_weights[j] = 1e-10;
+            size_t cnt = comp_ptr[j + 1] - comp_ptr[j];
+            if (nj[j] < 1e-10 || cnt == 0) continue;
+
+            DistParams old_p = result->params[j];
+            df->estimate(gx + comp_ptr[j], gw + comp_ptr[j], cnt, &result->params[j]);
+            for (int q = 0; q < result->params[j].nparams; q++) {
+                if (!isfinite(result->params[j].p[q])) { result->params[j] = old_p; break; }
+            }
+        }
+        double wsum = 0;
+        for (int j = 0; j < k; j++) wsum += result->mixing_weights[j];
+        for (int j = 0; j < k; j++) result->mixing_weights[j] /= wsum;
+    }
+
+    result->iterations = iter;
+    result->loglikelihood = prev_ll;
+    {
+        int num_free = k * (df->num_params + 1) - 1;
+        result->bic = -2 * prev_ll + num_free * log((double)n);
+        result->aic = -2 * prev_ll + 2 * num_free;
+    }
+    if (ll_err_bound) *ll_err_bound = err;
+
+done:
+    if (rc != 0) {
+        free(result->mixing_weights); result->mixing_weights = NULL;
+        free(result->params);         result->params = NULL;
+    }
+    free(xs); free(sc); free(lc); free(inv_s); free(lp_buf); free(r_buf);
+    free(comp_ptr); free(fill); free(nj); free(row_ptr); free(col); free(val);
+    free(gx); free(gw);
+    return rc;
+}
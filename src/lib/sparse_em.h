@@ -0,0 +1,59 @@
+/*
+ * Copyright 2022-2026, Micah Thornton and Chanhee Park
+ * Sparse-responsibility EM for univariate mixtures with many components.
+ * License: GPL v3
+ */
+#ifndef SPARSE_EM_H
+#define SPARSE_EM_H
+
+#include <stddef.h>
+#include "distributions.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Default truncation threshold for UnmixGenericSparse */
+#define SPARSE_EM_DEFAULT_EPS 1e-10
+
+/**
+ * Windowed-E-step EM for symmetric location-scale families
+ * (Gaussian, Laplace, Logistic, Cauchy) with large k.
+ *
+ * The data is sorted once; each iteration sorts the components by
+ * location and, for each point, evaluates only the contiguous window of
+ * components whose weighted density can exceed trunc_eps times the
+ * point's largest term.  Responsibilities are stored in CSR form and the
+ * M-step is fed from them, so an iteration costs O(n·w + k log k) for an
+ * average window of w components instead of O(n·k).
+ *
+ * The skip test is a rigorous bound, not a heuristic: a component is
+ * dropped only if its term is provably below trunc_eps·max.  The
+ * reported log-likelihood is therefore a lower bound on the exact
+ * mixture LL at the returned parameters, and
+ *     exact LL − result->loglikelihood ≤ *ll_err_bound
+ * where ll_err_bound = Σᵢ log(1 + mᵢ·trunc_eps), mᵢ = components dropped
+ * for point i.
+ *
+ * @param data          Observed values (need not be sorted)
+ * @param n             Number of observations
+ * @param family        DIST_GAUSSIAN, DIST_LAPLACE, DIST_LOGISTIC or DIST_CAUCHY
+ * @param k             Number of components (no upper limit)
+ * @param maxiter       Maximum EM iterations
+ * @param rtole         Convergence tolerance on LL change
+ * @param trunc_eps     Truncation threshold in (0, 1); ≤ 0 selects
+ *                      SPARSE_EM_DEFAULT_EPS
+ * @param verbose       Print per-iteration LL, window width and error bound
+ * @param result        Output mixture result
+ * @param ll_err_bound  Output (may be NULL): LL truncation error bound
+ * @return 0 on success, -1 bad args, -2 unsupported family, -3 alloc failure
+ */
+int UnmixGenericSparse(const double* data, size_t n, DistFamily family, int k,
+                       int maxiter, double rtole, double trunc_eps, int verbose,
+                       MixtureResult* result, double* ll_err_bound);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* SPARSE_EM_H */
@@ -9,250 +9,931 @@
 #include <string.h>
 #include <math.h>
 #include <float.h>
+#include <stdint.h>
 
 #include "streaming.h"
 #include "distributions.h"
+#include "textio.h"
+#include "binfile.h"
+#include "prefetch.h"
+#include "simd_estep.h"
+#include "checkpoint.h"
+#include "walltime.h"
 
 #define STREAM_PDF_FLOOR 1e-300
+#define STREAM_SIMD_MAX_K 64      /* simd_gaussian_estep() stack limit */
+#define STREAM_RESERVOIR  4096    /* values kept for initialization */
+#define STREAM_WARMUP     65536   /* prefix sampled before EM starts */
+#define STREAM_OFFSET_RING 16     /* > PREFETCH_MAX_BUFFERS + 1 chunks in flight */
+#define STREAM_CKPT_NPARAM (DIST_MAX_PARAMS + 1)   /* p[], nparams */
+#define STREAM_RESEED_FRAC 0.10   /* worst-explained share a re-seed fits */
+#define STREAM_RESEED_WAIT 10     /* chunks between re-seeds */
+
+/* Chunk E-step: resp[j*n + i] and the chunk log-likelihood.  Gaussian
+ * mixtures go through the SIMD kernel, as in UnmixGenericSingle; other
+ * families run a log-sum-exp loop, OpenMP-parallel over points, with the
+ * log-densities staged in resp so there is no per-point scratch or k limit.
+ * par is 3k doubles of scratch (log weights, means, variances). */
+static double stream_estep(const DistFunctions* df, DistFamily family,
+                           const double* x, int n, int k,
+                           const MixtureResult* res, double* par, double* resp)
+{
+    double* logw = par;
+    for (int j = 0; j < k; j++) {
+        double w = res->mixing_weights[j];
+        logw[j] = log(w > STREAM_PDF_FLOOR ? w : STREAM_PDF_FLOOR);
+    }
 
-int UnmixStreaming(const char* filename, const StreamConfig* config,
-                   MixtureResult* result)
+    if (family == DIST_GAUSSIAN && k <= STREAM_SIMD_MAX_K) {
+        double* mu = par + k;
+        double* var = par + 2 * k;
+        for (int j = 0; j < k; j++) {
+            mu[j] = res->params[j].p[0];
+            var[j] = res->params[j].p[1] > 1e-300 ? res->params[j].p[1] : 1e-300;
+        }
+        return simd_gaussian_estep(x, (size_t)n, logw, mu, var, k, resp);
+    }
+
+    double ll = 0;
+    #ifdef _OPENMP
+    #pragma omp parallel for reduction(+:ll) schedule(static) if(n > 5000)
+    #endif
+    for (int i = 0; i < n; i++) {
+        double max_lp = -1e300;
+        for (int j = 0; j < k; j++) {
+            double lp;
+            if (df->logpdf) {
+                lp = logw[j] + df->logpdf(x[i], &res->params[j]);
+            } else {
+                double pv = df->pdf(x[i], &res->params[j]);
+                lp = logw[j] + (pv > STREAM_PDF_FLOOR ? log(pv) : -700);
+            }
+            resp[(size_t)j * n + i] = lp;
+            if (lp > max_lp) max_lp = lp;
+        }
+        double total = 0;
+        for (int j = 0; j < k; j++) {
+            double v = exp(resp[(size_t)j * n + i] - max_lp);
+            resp[(size_t)j * n + i] = v;
+            total += v;
+        }
+        double inv = 1.0 / total;
+        for (int j = 0; j < k; j++) resp[(size_t)j * n + i] *= inv;
+        ll += max_lp + log(total);
+    }
+    return ll;
+}
+
+/* Per-component Σr, Σr·x, Σr·x² over a chunk into stat[0..k), [k..2k),
+ * [2k..3k): one unit-stride sweep per component over responsibilities
+ * that are still cache-resident from the E-step. */
+static void stream_suffstats(const double* x, int n, int k,
+                             const double* resp, double* stat)
 {
-    if (!filename || !config || !result) return -1;
+    #ifdef _OPENMP
+    #pragma omp parallel for schedule(static) if((size_t)n * k > 100000)
+    #endif
+    for (int j = 0; j < k; j++) {
+        const double* r = resp + (size_t)j * n;
+        double s0 = 0, s1 = 0, s2 = 0;
+        #ifdef _OPENMP
+        #pragma omp simd reduction(+:s0,s1,s2)
+        #endif
+        for (int i = 0; i < n; i++) {
+            double rx = r[i] * x[i];
+            s0 += r[i];
+            s1 += rx;
+            s2 += rx * x[i];
+        }
+        stat[j] = s0;
+        stat[k + j] = s1;
+        stat[2 * k + j] = s2;
+    }
+}
 
-    int k = config->num_components;
-    int chunk_size = config->chunk_size > 0 ? config->chunk_size : 10000;
-    int max_passes = config->max_passes > 0 ? config->max_passes : 10;
-    double rtole = config->rtole > 0 ? config->rtole : 1e-5;
-    double decay = config->eta_decay > 0 ? config->eta_decay : 0.6;
-    DistFamily family = config->family;
+/* Reservoir sample (Algorithm R) of the values seen so far; values outside
+ * the family's domain are not sampled, as sanitize_data drops them in
+ * memory.  splitmix64 keeps the sample reproducible. */
+typedef struct {
+    double*  v;
+    size_t   m;       /* values held (≤ STREAM_RESERVOIR) */
+    size_t   seen;    /* valid values offered */
+    uint64_t rng;
+} Reservoir;
+
+static uint64_t reservoir_next(Reservoir* r) {
+    uint64_t z = (r->rng += 0x9E3779B97F4A7C15ULL);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    return z ^ (z >> 31);
+}
+
+static void reservoir_add(Reservoir* r, const DistFunctions* df,
+                          const double* x, size_t n) {
+    for (size_t i = 0; i < n; i++) {
+        if (!isfinite(x[i]) || (df->valid && !df->valid(x[i]))) continue;
+        if (r->m < STREAM_RESERVOIR) {
+            r->v[r->m++] = x[i];
+        } else {
+            uint64_t j = reservoir_next(r) % (r->seen + 1);
+            if (j < STREAM_RESERVOIR) r->v[j] = x[i];
+        }
+        r->seen++;
+    }
+}
+
+/* Input: a text file through TextReader, or a GEMBIN file whose rows are
+ * read straight out of the mapping */
+typedef struct {
+    TextReader* txt;
+    GemBin      bin;
+    size_t      pos;
+    /* Where each chunk ends (byte offset for text, row for GEMBIN), for
+     * checkpoints: chunk c of the pass at chunk_end[c % STREAM_OFFSET_RING] */
+    size_t      chunk_end[STREAM_OFFSET_RING];
+    size_t      produced;
+} StreamSource;
+
+static int source_open(StreamSource* src, const char* filename) {
+    memset(src, 0, sizeof(*src));
+    if (GemBinIsFile(filename)) {
+        int rc = GemBinOpen(filename, &src->bin);
+        if (rc != 0) return rc;
+        if (src->bin.width != 1) { GemBinClose(&src->bin); return -1; }
+        return 0;
+    }
+    src->txt = TextReaderOpen(filename, 0);
+    return src->txt ? 0 : -3;
+}
+
+/* Next chunk of up to max values; *x points at them (buf or the mapping).
+ * Runs on the prefetch thread (ChunkReadFn). */
+static size_t source_next(void* ctx, double* buf, size_t max, const double** x) {
+    StreamSource* src = (StreamSource*)ctx;
+    size_t n;
+    if (src->txt) {
+        *x = buf;
+        n = TextReaderRead(src->txt, buf, max);
+        src->chunk_end[src->produced % STREAM_OFFSET_RING] = TextReaderOffset(src->txt);
+    } else {
+        n = src->bin.count - src->pos;
+        if (n > max) n = max;
+        *x = GemBinRows(&src->bin, src->pos, n, buf);
+        src->pos += n;
+        src->chunk_end[src->produced % STREAM_OFFSET_RING] = src->pos;
+    }
+    src->produced++;
+    return n;
+}
+
+static void source_rewind(StreamSource* src) {
+    if (src->txt) TextReaderRewind(src->txt);
+    src->pos = 0;
+    src->produced = 0;
+}
+
+/* Continue from a position recorded in chunk_end */
+static int source_seek(StreamSource* src, size_t off) {
+    src->produced = 0;
+    if (src->txt) return TextReaderSeek(src->txt, off);
+    if (off > src->bin.count) return -1;
+    src->pos = off;
+    return 0;
+}
+
+static void source_close(StreamSource* src) {
+    if (src->txt) TextReaderClose(src->txt);
+    else GemBinClose(&src->bin);
+}
 
-    const DistFunctions* df = GetDistFunctions(family);
-    if (!df) return -2;
+/* ════════════════════════════════════════════════════════════════════
+ * Online model: everything one chunk update needs, shared by the
+ * multi-pass engine (UnmixStreaming) and the one-pass engine
+ * (UnmixStreamingOnline).  Memory is O(k · chunk_size), independent of
+ * the stream length.
+ * ════════════════════════════════════════════════════════════════════ */
+
+typedef struct {
+    const DistFunctions* df;
+    const DistSuffStats* ss;    /* statistic map; NULL: refit each chunk */
+    DistFamily     family;
+    int            k;
+    int            chunk_size;
+    int            nstat;       /* running statistics per component */
+    double         decay;
+    int            verbose;
+    MixtureResult* result;
+    double*        resp;        /* k × chunk_size responsibilities */
+    double*        work;        /* E-step params (3k) + chunk stats (nstat·k) */
+    double*        tx;          /* T(x) per value for DistSuffStatsSum */
+    double*        suf;         /* running averages: Σr, then Σr·T_s (nstat·k) */
+    double*        suf_w;       /* views into suf */
+    double*        suf_wx;
+    double*        suf_wxx;
+    Reservoir      rsv;
+    size_t         seen;        /* values offered while warming up */
+    int            initialized;
+    int            global_step;
+    /* drift tracking */
+    double         halflife;    /* values; 0 = step_size or decaying step */
+    double         step_size;
+    int            split_merge;
+    double         collapse_weight;
+    double         ll_drop;
+    double         ll_avg;      /* forgetting-weighted chunk LL per value */
+    int            drift_chunks;/* chunks since start or last re-seed */
+    double*        lp;          /* 2 × chunk_size scratch for re-seeding */
+    uint64_t       input_size;  /* checkpoints: CheckpointInputSize of the input */
+} StreamModel;
+
+static void model_free(StreamModel* m) {
+    free(m->resp); free(m->work); free(m->tx); free(m->rsv.v); free(m->suf);
+    free(m->lp);
+    m->resp = m->work = m->tx = m->rsv.v = m->suf = m->lp = NULL;
+    m->suf_w = m->suf_wx = m->suf_wxx = NULL;
+}
 
-    /* Allocate result */
-    result->family = family;
+/* Allocate the model and the result's arrays.
+ * @return 0, -2 unsupported family, -5 allocation failure */
+static int model_alloc(StreamModel* m, const StreamConfig* config,
+                       int chunk_size, MixtureResult* result)
+{
+    memset(m, 0, sizeof(*m));
+    m->df = GetDistFunctions(config->family);
+    if (!m->df) return -2;
+    int k = config->num_components;
+    m->family = config->family;
+    m->k = k;
+    m->chunk_size = chunk_size;
+    /* Families without a statistic map keep Σr·x, Σr·x² for the weights */
+    m->ss = GetDistSuffStats(config->family);
+    m->nstat = m->ss ? 1 + m->ss->nstats : 3;
+    m->decay = config->eta_decay > 0 ? config->eta_decay : 0.6;
+    m->halflife = config->halflife > 0 ? config->halflife : 0;
+    m->step_size = config->step_size > 0 && config->step_size < 1 ? config->step_size : 0;
+    m->split_merge = config->split_merge && k > 1;
+    m->collapse_weight = config->collapse_weight > 0 ? config->collapse_weight : 1e-3;
+    m->ll_drop = config->ll_drop > 0 ? config->ll_drop : 0.5;
+    m->verbose = config->verbose;
+    m->result = result;
+    m->rsv.rng = 0x5EED5EEDULL;
+
+    result->family = config->family;
     result->num_components = k;
     result->mixing_weights = (double*)malloc(sizeof(double) * k);
     result->params = (DistParams*)malloc(sizeof(DistParams) * k);
-    if (!result->mixing_weights || !result->params) {
+    m->resp = (double*)malloc(sizeof(double) * k * chunk_size);
+    m->work = (double*)malloc(sizeof(double) * (3 + m->nstat) * k);
+    if (m->ss && m->family != DIST_GAUSSIAN)
+        m->tx = (double*)malloc(sizeof(double) * (m->ss->nstats + 1) * (size_t)chunk_size);
+    m->rsv.v = (double*)malloc(sizeof(double) * STREAM_RESERVOIR);
+    m->suf = (double*)calloc((size_t)m->nstat * k, sizeof(double));
+    if (m->split_merge) m->lp = (double*)malloc(sizeof(double) * 2 * (size_t)chunk_size);
+    if (!result->mixing_weights || !result->params || !m->resp || !m->work ||
+        !m->rsv.v || !m->suf || (m->ss && m->family != DIST_GAUSSIAN && !m->tx) ||
+        (m->split_merge && !m->lp)) {
+        model_free(m);
         free(result->mixing_weights); result->mixing_weights = NULL;
         free(result->params);         result->params = NULL;
         return -5;
     }
+    m->suf_w = m->suf;
+    m->suf_wx = m->suf + k;
+    m->suf_wxx = m->suf + 2 * k;
+    return 0;
+}
 
-    /* First pass: count lines and compute global stats for initialization */
-    FILE* fp = fopen(filename, "r");
-    if (!fp) {
-        free(result->mixing_weights); result->mixing_weights = NULL;
-        free(result->params);         result->params = NULL;
-        return -3;
+/* Save the model, including the drift-tracking state, with the caller's
+ * pass position filled in ck (pass, rows, offset, total_n, pass_ll, pass_n,
+ * chunks, prev_ll, last_ll, last_n).
+ * A failed write is reported and the fit goes on. */
+static void model_save(const StreamModel* m, const char* path, Checkpoint* ck) {
+    int k = m->k;
+    double* packed = (double*)malloc(sizeof(double) * k * STREAM_CKPT_NPARAM);
+    int rc = -5;
+    if (packed) {
+        for (int j = 0; j < k; j++) {
+            double* q = packed + (size_t)j * STREAM_CKPT_NPARAM;
+            memcpy(q, m->result->params[j].p, sizeof(double) * DIST_MAX_PARAMS);
+            q[DIST_MAX_PARAMS] = m->result->params[j].nparams;
+        }
+        ck->engine = CKPT_STREAMING;
+        ck->family = (int)m->family;
+        ck->k = k;
+        ck->nparam = STREAM_CKPT_NPARAM;
+        ck->nstat = m->nstat;
+        ck->step = (uint64_t)m->global_step;
+        ck->input_size = m->input_size;
+        ck->drift_chunks = m->drift_chunks;
+        ck->drift_ll = m->ll_avg;
+        ck->weights = m->result->mixing_weights;
+        ck->params = packed;
+        ck->stats = m->suf;
+        rc = CheckpointWrite(path, ck);
+        free(packed);
     }
+    if (rc != 0)
+        fprintf(stderr, "  [stream] checkpoint write to %s failed (rc=%d)\n", path, rc);
+}
 
-    size_t total_n = 0;
-    double global_sum = 0, global_sum2 = 0;
-    double global_min = 1e30, global_max = -1e30;
-    char line[256];
-    while (fgets(line, sizeof(line), fp)) {
-        if (line[0] == '#' || line[0] == '\n') continue;
-        double v = atof(line);
-        global_sum += v;
-        global_sum2 += v * v;
-        if (v < global_min) global_min = v;
-        if (v > global_max) global_max = v;
-        total_n++;
+/* Restore a checkpoint written by model_save.
+ * @return 0, or -1 if it belongs to another engine, family, k or input,
+ *         or its parameter counts are not the family's */
+static int model_restore(StreamModel* m, const Checkpoint* ck) {
+    int k = m->k;
+    if (ck->engine != CKPT_STREAMING || ck->family != (int)m->family ||
+        ck->k != k || ck->nparam != STREAM_CKPT_NPARAM || ck->nstat != m->nstat ||
+        ck->input_size != m->input_size)
+        return -1;
+    /* At least the family's free parameters; more where the family caches
+     * a derived value after them (Gamma's lgamma(α) in p[2]) */
+    for (int j = 0; j < k; j++) {
+        double np = ck->params[(size_t)j * STREAM_CKPT_NPARAM + DIST_MAX_PARAMS];
+        if (!(np >= m->df->num_params && np <= DIST_MAX_PARAMS) || np != (int)np)
+            return -1;
     }
-    fclose(fp);
+    for (int j = 0; j < k; j++) {
+        const double* q = ck->params + (size_t)j * STREAM_CKPT_NPARAM;
+        memcpy(m->result->params[j].p, q, sizeof(double) * DIST_MAX_PARAMS);
+        m->result->params[j].nparams = (int)q[DIST_MAX_PARAMS];
+        m->result->mixing_weights[j] = ck->weights[j];
+    }
+    memcpy(m->suf, ck->stats, sizeof(double) * m->nstat * k);
+    m->global_step = (int)ck->step;
+    m->drift_chunks = ck->drift_chunks;
+    m->ll_avg = ck->drift_ll;
+    m->initialized = 1;
+    return 0;
+}
 
-    if (total_n == 0) {
-        free(result->mixing_weights); result->mixing_weights = NULL;
-        free(result->params);         result->params = NULL;
-        return -4;
+/* Statistic sums of one block whose responsibilities are in m->resp, in
+ * the layout of m->suf: Σr·x and Σr·x² for Gaussians (and for families
+ * without a map, which only use Σr), the family's map otherwise */
+static void model_stats(StreamModel* m, const double* x, int n, double* stat) {
+    if (m->ss && m->family != DIST_GAUSSIAN)
+        DistSuffStatsSum(m->family, x, (size_t)n, m->k, m->resp,
+                         m->result->params, m->tx, stat);
+    else
+        stream_suffstats(x, n, m->k, m->resp, stat);
+}
+
+/* Initial parameters from the reservoir through the family's init_params
+ * (k-means++ for Gaussians, whose cluster fractions in p[2] become the
+ * weights, as in UnmixGenericSingle).  With a statistic map the running
+ * statistics start as one E-step over the reservoir; otherwise from the
+ * initial means and variances.
+ * @return 0, or -4 if the reservoir is empty */
+static int model_init(StreamModel* m) {
+    const DistFunctions* df = m->df;
+    MixtureResult* result = m->result;
+    int k = m->k;
+    if (m->rsv.m == 0) return -4;
+
+    /* Student-t starts from the Gaussian clusters (location, scale,
+     * ν = 5): studt_init spreads locations evenly over the range */
+    int from_gauss = m->family == DIST_GAUSSIAN || m->family == DIST_STUDENT_T;
+    if (from_gauss) GetDistFunctions(DIST_GAUSSIAN)->init_params(m->rsv.v, m->rsv.m, k,
+                                                                 result->params);
+    else df->init_params(m->rsv.v, m->rsv.m, k, result->params);
+    double wsum = 0;
+    for (int j = 0; j < k; j++) {
+        double w = 1.0 / k;
+        if (from_gauss) {
+            w = result->params[j].p[2] > 1e-10 ? result->params[j].p[2] : 1e-10;
+            result->params[j].p[2] = 0;
+        }
+        if (m->family == DIST_STUDENT_T) {
+            result->params[j].p[1] = sqrt(result->params[j].p[1] > 1e-20 ? result->params[j].p[1] : 1e-20);
+            result->params[j].p[2] = 5.0;
+            result->params[j].nparams = 3;
+        }
+        result->mixing_weights[j] = w;
+        wsum += w;
+    }
+    for (int j = 0; j < k; j++) result->mixing_weights[j] /= wsum;
+
+    if (m->ss) {
+        double* stat = m->work + 3 * k;
+        size_t ns = (size_t)m->nstat * k;
+        memset(m->suf, 0, sizeof(double) * ns);
+        for (size_t off = 0; off < m->rsv.m; off += (size_t)m->chunk_size) {
+            int n = (int)(m->rsv.m - off < (size_t)m->chunk_size ? m->rsv.m - off
+                                                                  : (size_t)m->chunk_size);
+            stream_estep(df, m->family, m->rsv.v + off, n, k, result, m->work, m->resp);
+            model_stats(m, m->rsv.v + off, n, stat);
+            for (size_t q = 0; q < ns; q++) m->suf[q] += stat[q];
+        }
+        for (size_t q = 0; q < ns; q++) m->suf[q] /= (double)m->rsv.m;
+    } else {
+        for (int j = 0; j < k; j++) {
+            double w = result->mixing_weights[j];
+            double mu = result->params[j].p[0];
+            double var = df->num_params >= 2 ? result->params[j].p[1] : 1.0;
+            m->suf_w[j] = w;
+            m->suf_wx[j] = w * mu;
+            m->suf_wxx[j] = w * (mu * mu + var);
+        }
     }
+    m->initialized = 1;
+    if (m->verbose)
+        printf("  [stream] init: %zu-value reservoir from the first %zu values\n",
+               m->rsv.m, m->seen);
+    return 0;
+}
 
-    double global_mean = global_sum / total_n;
-    double global_var = global_sum2 / total_n - global_mean * global_mean;
-    if (global_var < 1e-10) global_var = 1e-10;
+/* Step size for a chunk of n values: 1 - 2^(-n/halflife) (the statistics
+ * then weigh a value by 2^(-age/halflife)), the constant step_size, or the
+ * decaying (t + 2)^-decay of Cappé & Moulines */
+static double model_step(const StreamModel* m, int n) {
+    if (m->halflife > 0) return 1 - pow(0.5, (double)n / m->halflife);
+    if (m->step_size > 0) return m->step_size;
+    return pow(m->global_step + 2.0, -m->decay);
+}
 
-    if (config->verbose)
-        printf("  [stream] n=%zu  mean=%.4f  var=%.4f  range=[%.2f, %.2f]\n",
-               total_n, global_mean, global_var, global_min, global_max);
+static int cmp_double(const void* a, const void* b) {
+    double u = *(const double*)a, v = *(const double*)b;
+    return (u > v) - (u < v);
+}
 
-    /* Initialize parameters: spread means evenly across data range */
+/* Weights and parameters from the running statistics */
+static void model_from_stats(StreamModel* m) {
+    MixtureResult* result = m->result;
+    int k = m->k;
+    double wsum = 0;
+    for (int j = 0; j < k; j++) wsum += m->suf_w[j];
     for (int j = 0; j < k; j++) {
-        result->mixing_weights[j] = 1.0 / k;
-        double frac = (k > 1) ? (double)j / (k - 1) : 0.5;
-        double mu = global_min + frac * (global_max - global_min);
-        result->params[j].p[0] = mu;
-        if (df->num_params >= 2) result->params[j].p[1] = global_var / k;
-        result->params[j].nparams = df->num_params;
+        result->mixing_weights[j] = m->suf_w[j] / wsum;
+        if (result->mixing_weights[j] < 1e-10) result->mixing_weights[j] = 1e-10;
     }
+    if (m->ss) DistParamsFromStats(m->family, m->suf, k, result->params);
+}
 
-    /* Running sufficient statistics per component */
-    double* suf_w = (double*)calloc(k, sizeof(double));
-    double* suf_wx = (double*)calloc(k, sizeof(double));
-    double* suf_wxx = (double*)calloc(k, sizeof(double));
-    if (!suf_w || !suf_wx || !suf_wxx) {
-        free(suf_w); free(suf_wx); free(suf_wxx);
-        free(result->mixing_weights); result->mixing_weights = NULL;
-        free(result->params);         result->params = NULL;
-        return -5;
+/* Refit component slot to the worst-explained STREAM_RESEED_FRAC of the
+ * chunk under the current mixture: its weight becomes that share, the
+ * other components' statistics are scaled to make room, and its own are
+ * those of the selected values.
+ * @return 1 if re-seeded, 0 if the chunk has too few usable values */
+static int model_reseed(StreamModel* m, const double* x, int n, int slot) {
+    const DistFunctions* df = m->df;
+    MixtureResult* result = m->result;
+    int k = m->k;
+    double* lp = m->lp;          /* per-value mixture log-density */
+    double* sorted = m->lp + n;  /* then the selection weights */
+    int nv = 0;
+    for (int i = 0; i < n; i++) {
+        if (!isfinite(x[i]) || (df->valid && !df->valid(x[i]))) { lp[i] = HUGE_VAL; continue; }
+        double max_lp = -HUGE_VAL, tot = 0;
+        for (int j = 0; j < k; j++) {
+            double w = result->mixing_weights[j], l;
+            if (df->logpdf) l = df->logpdf(x[i], &result->params[j]);
+            else {
+                double pv = df->pdf(x[i], &result->params[j]);
+                l = pv > STREAM_PDF_FLOOR ? log(pv) : -700;
+            }
+            m->work[j] = log(w) + l;
+            if (m->work[j] > max_lp) max_lp = m->work[j];
+        }
+        for (int j = 0; j < k; j++) tot += exp(m->work[j] - max_lp);
+        lp[i] = isfinite(max_lp) ? max_lp + log(tot) : -HUGE_VAL;
+        sorted[nv++] = lp[i];
+    }
+    int cnt = (int)(STREAM_RESEED_FRAC * nv);
+    if (cnt < 2) return 0;
+    qsort(sorted, (size_t)nv, sizeof(double), cmp_double);
+    double thr = sorted[cnt - 1];
+    cnt = 0;
+    for (int i = 0; i < n; i++) {
+        sorted[i] = lp[i] <= thr ? 1.0 : 0.0;
+        cnt += lp[i] <= thr;
     }
 
-    /* Init sufficient stats */
-    for (int j = 0; j < k; j++) {
-        suf_w[j] = 1.0 / k;
-        suf_wx[j] = result->params[j].p[0] / k;
-        suf_wxx[j] = (result->params[j].p[0] * result->params[j].p[0] +
-                       (df->num_params >= 2 ? result->params[j].p[1] : 1.0)) / k;
+    DistParams p = result->params[slot];
+    df->estimate(x, sorted, (size_t)n, &p);
+    for (int q = 0; q < p.nparams; q++)
+        if (!isfinite(p.p[q])) return 0;
+
+    double w_new = (double)cnt / (double)nv, others = 0;
+    for (int j = 0; j < k; j++) if (j != slot) others += m->suf_w[j];
+    double scale = others > 0 ? (1 - w_new) / others : 0;
+    for (int s = 0; s < m->nstat; s++)
+        for (int j = 0; j < k; j++)
+            if (j != slot) m->suf[(size_t)s * k + j] *= scale;
+
+    /* The slot's statistics: the selected values' averages times w_new */
+    double st[DIST_MAX_STATS + 3];
+    if (m->ss && m->family != DIST_GAUSSIAN)
+        DistSuffStatsSum(m->family, x, (size_t)n, 1, sorted, &p, NULL, st);
+    else
+        stream_suffstats(x, n, 1, sorted, st);
+    for (int s = 0; s < m->nstat; s++)
+        m->suf[(size_t)s * k + slot] = w_new * st[s] / st[0];
+    result->params[slot] = p;
+    model_from_stats(m);
+    return 1;
+}
+
+/* Drift-mode bookkeeping after a chunk: the running LL per value, and with
+ * split_merge the re-seeding of a collapsed component, or of the lightest
+ * one (merged first into the component that shares most of its
+ * responsibility) when the chunk LL drops well below its running mean */
+static void model_track(StreamModel* m, const double* x, int n, double chunk_ll,
+                        double eta) {
+    int k = m->k;
+    double avg = chunk_ll / n;
+    if (m->drift_chunks++ == 0) { m->ll_avg = avg; return; }
+
+    if (m->split_merge && m->drift_chunks > STREAM_RESEED_WAIT) {
+        const double* w = m->result->mixing_weights;
+        int light = 0;
+        for (int j = 1; j < k; j++) if (w[j] < w[light]) light = j;
+        int slot = -1, into = -1;
+        if (w[light] < m->collapse_weight) {
+            slot = light;
+        } else if (avg < m->ll_avg - m->ll_drop) {
+            /* m->resp still holds this chunk's responsibilities */
+            const double* rl = m->resp + (size_t)light * n;
+            double best = -1;
+            for (int j = 0; j < k; j++) {
+                if (j == light) continue;
+                const double* rj = m->resp + (size_t)j * n;
+                double ov = 0;
+                for (int i = 0; i < n; i++) ov += rl[i] * rj[i];
+                if (ov > best) { best = ov; into = j; }
+            }
+            for (int s = 0; s < m->nstat; s++) {
+                m->suf[(size_t)s * k + into] += m->suf[(size_t)s * k + light];
+                m->suf[(size_t)s * k + light] = 0;
+            }
+            slot = light;
+        }
+        if (slot >= 0) {
+            int ok = model_reseed(m, x, n, slot);
+            if (!ok && into >= 0) model_from_stats(m);   /* keep the merge */
+            if (m->verbose && into >= 0)
+                printf("  [stream] drift: chunk LL %.4f vs %.4f, component %d merged "
+                       "into %d%s\n", avg, m->ll_avg, slot + 1, into + 1,
+                       ok ? " and re-seeded" : "");
+            else if (m->verbose)
+                printf("  [stream] drift: component %d weight collapsed%s\n", slot + 1,
+                       ok ? ", re-seeded" : "");
+            m->drift_chunks = 0;
+            return;
+        }
     }
+    m->ll_avg = (1 - eta) * m->ll_avg + eta * avg;
+}
 
-    /* Allocate chunk buffer */
-    double* chunk = (double*)malloc(sizeof(double) * chunk_size);
-    double* chunk_resp = (double*)malloc(sizeof(double) * k * chunk_size);
-    double* chunk_w = (double*)malloc(sizeof(double) * chunk_size);
-    if (!chunk || !chunk_resp || !chunk_w) {
-        free(chunk); free(chunk_resp); free(chunk_w);
-        free(suf_w); free(suf_wx); free(suf_wxx);
-        free(result->mixing_weights); result->mixing_weights = NULL;
-        free(result->params);         result->params = NULL;
-        return -5;
+/* One chunk of stochastic EM with the model_step schedule.  Until the
+ * model is initialized the chunk only feeds the warm-up reservoir; the
+ * chunk that completes the prefix initializes it and is then used for EM.
+ * @return 1 with *ll = chunk log-likelihood if EM ran, 0 during warm-up */
+static int model_chunk(StreamModel* m, const double* x, int n_read, double* ll) {
+    const DistFunctions* df = m->df;
+    MixtureResult* result = m->result;
+    int k = m->k;
+
+    if (!m->initialized) {
+        reservoir_add(&m->rsv, df, x, (size_t)n_read);
+        m->seen += (size_t)n_read;
+        if (m->seen < STREAM_WARMUP || model_init(m) != 0) return 0;
+    }
+
+    double eta = model_step(m, n_read);
+    m->global_step++;
+
+    /* E-step on chunk */
+    *ll = stream_estep(df, m->family, x, n_read, k, result, m->work, m->resp);
+
+    /* Stochastic M-step: update sufficient statistics */
+    double* stat = m->work + 3 * k;
+    model_stats(m, x, n_read, stat);
+    for (size_t q = 0; q < (size_t)m->nstat * k; q++)
+        m->suf[q] = (1 - eta) * m->suf[q] + eta * (stat[q] / n_read);
+
+    /* Reconstruct parameters from sufficient statistics */
+    model_from_stats(m);
+    if (!m->ss) {
+        /* No map: use the chunk as weighted pseudo-data (the component's
+         * responsibilities are a contiguous row) and blend */
+        for (int j = 0; j < k; j++) {
+            DistParams old = result->params[j];
+            df->estimate(x, m->resp + (size_t)j * n_read, n_read,
+                         &result->params[j]);
+            for (int q = 0; q < result->params[j].nparams; q++) {
+                if (!isfinite(result->params[j].p[q]))
+                    result->params[j].p[q] = old.p[q];
+                else
+                    result->params[j].p[q] = (1-eta)*old.p[q] + eta*result->params[j].p[q];
+            }
+        }
+    }
+    if (m->halflife > 0 || m->step_size > 0) model_track(m, x, n_read, *ll, eta);
+    return 1;
+}
+
+/* LL, BIC and AIC for n values */
+static void model_finish(StreamModel* m, double ll, size_t n) {
+    MixtureResult* result = m->result;
+    int nfree = m->k * (m->df->num_params + 1) - 1;
+    result->loglikelihood = ll;
+    result->iterations = m->global_step;
+    result->bic = -2 * ll + nfree * log((double)n);
+    result->aic = -2 * ll + 2 * nfree;
+}
+
+static void release_result(MixtureResult* result) {
+    free(result->mixing_weights); result->mixing_weights = NULL;
+    free(result->params);         result->params = NULL;
+}
+
+int UnmixStreaming(const char* filename, const StreamConfig* config,
+                   MixtureResult* result)
+{
+    if (!filename || !config || !result) return -1;
+
+    int k = config->num_components;
+    int chunk_size = config->chunk_size > 0 ? config->chunk_size : 10000;
+    int max_passes = config->max_passes > 0 ? config->max_passes : 10;
+    double rtole = config->rtole > 0 ? config->rtole : 1e-5;
+
+    /* Initialization is folded into the first pass: the first STREAM_WARMUP
+     * values (whole chunks) feed a reservoir, the family's init_params runs
+     * on it, and EM starts on the chunk that completes the prefix. */
+    StreamModel m;
+    int rc = model_alloc(&m, config, chunk_size, result);
+    if (rc != 0) return rc;
+
+    /* The file is opened (memory-mapped) once and rewound for every pass */
+    StreamSource src;
+    rc = source_open(&src, filename);
+    if (rc != 0) {
+        model_free(&m);
+        release_result(result);
+        return rc;
     }
+    m.input_size = CheckpointInputSize(filename);
+
+    /* Every pass reads through a prefetcher: a background thread parses
+     * (or faults in) the next chunks while this thread runs EM */
+    int nbuf = config->io_buffers;
+    double io_wait = 0, t_pass;
+    ChunkPrefetch* pf;
+    size_t total_n = 0;
+    size_t got;
+    const double* x;
 
     double prev_ll = -1e30;
-    int global_step = 0;
+    double last_ll = 0;
+    size_t last_n = 0;
+
+    /* Resume: the checkpoint holds the model and the position inside the
+     * pass it was written in; no checkpoint file means a fresh start */
+    const char* ckpath = config->checkpoint_path;
+    Checkpoint ck, at;
+    int start_pass = 0;
+    memset(&ck, 0, sizeof(ck));
+    memset(&at, 0, sizeof(at));
+    if (ckpath && (rc = CheckpointRead(ckpath, &ck)) != -3) {
+        if (rc == 0) rc = model_restore(&m, &ck);
+        if (rc != 0) {
+            CheckpointRelease(&ck);
+            source_close(&src);
+            model_free(&m);
+            release_result(result);
+            return rc;
+        }
+        at = ck;                 /* position fields only from here on */
+        at.weights = at.params = at.stats = NULL;
+        CheckpointRelease(&ck);
+        start_pass = at.converged ? max_passes : at.pass;
+        total_n = (size_t)at.total_n;
+        prev_ll = at.prev_ll;
+        last_ll = at.last_ll;
+        last_n = (size_t)at.last_n;
+        if (config->verbose)
+            printf("  [stream] resumed from %s: pass %d, row %llu, step %d\n",
+                   ckpath, at.pass + 1, (unsigned long long)at.rows, m.global_step);
+    }
 
     /* Streaming EM passes */
-    for (int pass = 0; pass < max_passes; pass++) {
-        fp = fopen(filename, "r");
-        if (!fp) break;
-
+    for (int pass = start_pass; pass < max_passes; pass++) {
         double pass_ll = 0;
-        size_t pass_n = 0;
+        size_t pass_n = 0, rows = 0;
         int chunk_idx = 0;
 
+        source_rewind(&src);
+        if (pass == start_pass && at.rows > 0) {
+            if (source_seek(&src, (size_t)at.offset) != 0) {
+                /* The recorded position is not in this input */
+                source_close(&src);
+                model_free(&m);
+                release_result(result);
+                return -1;
+            }
+            pass_ll = at.pass_ll;
+            pass_n = (size_t)at.pass_n;
+            rows = (size_t)at.rows;
+            chunk_idx = (int)at.chunks;
+        }
+        t_pass = WallSeconds();
+        pf = ChunkPrefetchStart(source_next, &src, (size_t)chunk_size, 1, nbuf);
+        if (!pf) {
+            source_close(&src);
+            model_free(&m);
+            release_result(result);
+            return -5;
+        }
+
+        size_t nchunk = 0;   /* chunks read since the pass (re)started */
         while (1) {
             /* Read a chunk */
-            int n_read = 0;
-            while (n_read < chunk_size && fgets(line, sizeof(line), fp)) {
-                if (line[0] == '#' || line[0] == '\n') continue;
-                chunk[n_read++] = atof(line);
-            }
+            int n_read = (int)ChunkPrefetchNext(pf, &x);
             if (n_read == 0) break;
+            if (pass == 0) total_n += (size_t)n_read;
+            rows += (size_t)n_read;
+            nchunk++;
 
-            double eta = pow(global_step + 2.0, -decay);
-            global_step++;
-
-            /* E-step on chunk */
-            double chunk_ll = 0;
-            for (int i = 0; i < n_read; i++) {
-                double total = 0;
-                for (int j = 0; j < k; j++) {
-                    double lp = df->logpdf ?
-                        df->logpdf(chunk[i], &result->params[j]) :
-                        log(df->pdf(chunk[i], &result->params[j]) + 1e-300);
-                    double p = result->mixing_weights[j] * exp(lp);
-                    if (p < STREAM_PDF_FLOOR) p = STREAM_PDF_FLOOR;
-                    chunk_resp[j * n_read + i] = p;
-                    total += p;
-                }
-                for (int j = 0; j < k; j++) chunk_resp[j * n_read + i] /= total;
-                chunk_ll += log(total);
-            }
+            double chunk_ll;
+            if (!model_chunk(&m, x, n_read, &chunk_ll)) continue;
             pass_ll += chunk_ll;
             pass_n += n_read;
+            chunk_idx++;
 
-            /* Stochastic M-step: update sufficient statistics */
-            for (int j = 0; j < k; j++) {
-                double new_w = 0, new_wx = 0, new_wxx = 0;
-                for (int i = 0; i < n_read; i++) {
-                    double r = chunk_resp[j * n_read + i];
-                    new_w += r;
-                    new_wx += r * chunk[i];
-                    new_wxx += r * chunk[i] * chunk[i];
-                }
-                new_w /= n_read;
-                new_wx /= n_read;
-                new_wxx /= n_read;
-
-                suf_w[j] = (1 - eta) * suf_w[j] + eta * new_w;
-                suf_wx[j] = (1 - eta) * suf_wx[j] + eta * new_wx;
-                suf_wxx[j] = (1 - eta) * suf_wxx[j] + eta * new_wxx;
-            }
-
-            /* Reconstruct parameters from sufficient statistics */
-            double wsum = 0;
-            for (int j = 0; j < k; j++) wsum += suf_w[j];
-            for (int j = 0; j < k; j++) {
-                result->mixing_weights[j] = suf_w[j] / wsum;
-                if (result->mixing_weights[j] < 1e-10) result->mixing_weights[j] = 1e-10;
-
-                double mu = suf_wx[j] / (suf_w[j] > 1e-10 ? suf_w[j] : 1e-10);
-                double var = suf_wxx[j] / (suf_w[j] > 1e-10 ? suf_w[j] : 1e-10) - mu * mu;
-                if (var < 1e-10) var = 1e-10;
-
-                if (family == DIST_GAUSSIAN) {
-                    result->params[j].p[0] = mu;
-                    result->params[j].p[1] = var;
-                    result->params[j].nparams = 2;
-                } else {
-                    /* General: use chunk as weighted pseudo-data */
-                    for (int i = 0; i < n_read; i++)
-                        chunk_w[i] = chunk_resp[j * n_read + i];
-                    DistParams old = result->params[j];
-                    df->estimate(chunk, chunk_w, n_read, &result->params[j]);
-                    for (int q = 0; q < result->params[j].nparams; q++) {
-                        if (!isfinite(result->params[j].p[q]))
-                            result->params[j].p[q] = old.p[q];
-                        else
-                            result->params[j].p[q] = (1-eta)*old.p[q] + eta*result->params[j].p[q];
-                    }
-                }
+            if (ckpath && config->checkpoint_every > 0 &&
+                chunk_idx % config->checkpoint_every == 0) {
+                ck.pass = pass;
+                ck.rows = rows;
+                ck.offset = src.chunk_end[(nchunk - 1) % STREAM_OFFSET_RING];
+                ck.total_n = total_n;
+                ck.pass_ll = pass_ll;
+                ck.pass_n = pass_n;
+                ck.chunks = (uint64_t)chunk_idx;
+                ck.prev_ll = prev_ll;
+                ck.last_ll = last_ll;
+                ck.last_n = last_n;
+                model_save(&m, ckpath, &ck);
             }
-
-            chunk_idx++;
         }
-        fclose(fp);
+        ChunkPrefetchFinish(pf, &io_wait);
+        t_pass = WallSeconds() - t_pass;
+
+        /* Input shorter than the warm-up prefix: initialize from all of
+         * it and start EM on the next pass */
+        if (!m.initialized) {
+            if (model_init(&m) != 0) break;
+            continue;
+        }
 
+        last_ll = pass_ll;
+        last_n = pass_n;
         double avg_ll = pass_ll / (pass_n > 0 ? pass_n : 1);
         if (config->verbose)
-            printf("  [stream] pass %d/%d  chunks=%d  avg_LL=%.6f  eta=%.4f\n",
-                   pass + 1, max_passes, chunk_idx, avg_ll, pow(global_step + 1.0, -decay));
+            printf("  [stream] pass %d/%d  chunks=%d  avg_LL=%.6f  eta=%.4f  "
+                   "io_wait=%.3fs  compute=%.3fs\n",
+                   pass + 1, max_passes, chunk_idx, avg_ll,
+                   m.halflife > 0 || m.step_size > 0 ? model_step(&m, chunk_size)
+                                                     : pow(m.global_step + 1.0, -m.decay),
+                   io_wait, t_pass - io_wait);
 
         /* Check convergence */
-        if (pass > 0 && fabs(avg_ll - prev_ll) < rtole) {
+        int converged = pass > 0 && fabs(avg_ll - prev_ll) < rtole;
+        prev_ll = avg_ll;
+
+        /* End-of-pass checkpoint: the next run starts the following pass */
+        if (ckpath) {
+            memset(&ck, 0, sizeof(ck));
+            ck.pass = pass + 1;
+            ck.converged = converged;
+            ck.total_n = total_n;
+            ck.prev_ll = prev_ll;
+            ck.last_ll = last_ll;
+            ck.last_n = last_n;
+            model_save(&m, ckpath, &ck);
+        }
+        if (converged) {
             if (config->verbose) printf("  [stream] converged at pass %d\n", pass + 1);
             break;
         }
-        prev_ll = avg_ll;
     }
 
-    /* Final full-pass LL computation */
-    fp = fopen(filename, "r");
+    if (!m.initialized) {
+        source_close(&src);
+        model_free(&m);
+        release_result(result);
+        return -4;
+    }
+
+    /* Final LL: the last EM pass's sum (scaled over a skipped warm-up
+     * prefix), or one more pass with the final parameters */
     double final_ll = 0;
-    if (fp) {
-        while (fgets(line, sizeof(line), fp)) {
-            if (line[0] == '#' || line[0] == '\n') continue;
-            double x = atof(line);
-            double total = 0;
-            for (int j = 0; j < k; j++) {
-                double lp = df->logpdf ?
-                    df->logpdf(x, &result->params[j]) :
-                    log(df->pdf(x, &result->params[j]) + 1e-300);
-                total += result->mixing_weights[j] * exp(lp);
-            }
-            final_ll += log(total > 1e-300 ? total : 1e-300);
+    if (config->ll_from_last_pass && last_n > 0) {
+        final_ll = last_ll * ((double)total_n / (double)last_n);
+    } else {
+        source_rewind(&src);
+        pf = ChunkPrefetchStart(source_next, &src, (size_t)chunk_size, 1, nbuf);
+        if (!pf) {
+            source_close(&src);
+            model_free(&m);
+            release_result(result);
+            return -5;
         }
-        fclose(fp);
+        while ((got = ChunkPrefetchNext(pf, &x)) > 0)
+            final_ll += stream_estep(m.df, m.family, x, (int)got, k, result,
+                                     m.work, m.resp);
+        ChunkPrefetchFinish(pf, NULL);
     }
+    source_close(&src);
 
-    result->loglikelihood = final_ll;
-    result->iterations = global_step;
-    int nfree = k * (df->num_params + 1) - 1;
-    result->bic = -2 * final_ll + nfree * log((double)total_n);
-    result->aic = -2 * final_ll + 2 * nfree;
+    model_finish(&m, final_ll, total_n);
+    model_free(&m);
+    return 0;
+}
+
+/* Chunk source for the one-pass engine: a TextReader on a stream */
+static size_t text_next(void* ctx, double* buf, size_t max, const double** x) {
+    *x = buf;
+    return TextReaderRead((TextReader*)ctx, buf, max);
+}
+
+int UnmixStreamingOnline(FILE* fp, const StreamConfig* config,
+                         MixtureResult* result)
+{
+    if (!fp || !config || !result) return -1;
+    /* A checkpoint resumes by re-reading the input from an offset */
+    if (config->checkpoint_path) return -1;
+
+    int chunk_size = config->chunk_size > 0 ? config->chunk_size : 10000;
+    StreamModel m;
+    int rc = model_alloc(&m, config, chunk_size, result);
+    if (rc != 0) return rc;
+
+    TextReader* txt = TextReaderOpenFile(fp);
+    ChunkPrefetch* pf = txt ? ChunkPrefetchStart(text_next, txt, (size_t)chunk_size,
+                                                 1, config->io_buffers) : NULL;
+    if (!pf) {
+        TextReaderClose(txt);
+        model_free(&m);
+        release_result(result);
+        return -5;
+    }
+
+    /* The LL of the chunks EM ran on, scaled over the warm-up prefix like
+     * ll_from_last_pass: a running estimate, the stream cannot be re-read.
+     * Drift tracking reports the forgetting-weighted LL instead, which
+     * describes the current mixture rather than the whole history. */
+    int drift = m.halflife > 0 || m.step_size > 0;
+    double t0 = WallSeconds(), io_wait = 0;
+    double em_ll = 0;
+    size_t n = 0, em_n = 0;
+    size_t next_snap = config->snapshot_every;
+    const double* x;
+    int n_read, stopped = 0;
+    while (!stopped && (n_read = (int)ChunkPrefetchNext(pf, &x)) > 0) {
+        n += (size_t)n_read;
+        double chunk_ll;
+        if (model_chunk(&m, x, n_read, &chunk_ll)) {
+            em_ll += chunk_ll;
+            em_n += (size_t)n_read;
+        }
+        if (next_snap > 0 && n >= next_snap && m.initialized) {
+            while (next_snap <= n) next_snap += config->snapshot_every;
+            double avg = drift ? m.ll_avg : em_n ? em_ll / (double)em_n : 0.0;
+            model_finish(&m, avg * (double)n, n);
+            if (config->verbose)
+                printf("  [stream] snapshot n=%zu  avg_LL=%.6f\n", n, avg);
+            if (config->snapshot && config->snapshot(result, n, config->snapshot_ctx))
+                stopped = 1;
+        }
+    }
+    /* The reader may be blocked on a live stream that has more to come */
+    if (stopped) TextReaderCancel(txt);
+    ChunkPrefetchFinish(pf, &io_wait);
+    TextReaderClose(txt);
+
+    /* Stream shorter than the warm-up prefix: the fit is the
+     * initialization itself */
+    if (!m.initialized && model_init(&m) != 0) {
+        model_free(&m);
+        release_result(result);
+        return -4;
+    }
+    if (em_n == 0) {
+        for (size_t i = 0; i < m.rsv.m; i += (size_t)chunk_size) {
+            int nb = (int)(m.rsv.m - i < (size_t)chunk_size ? m.rsv.m - i : (size_t)chunk_size);
+            em_ll += stream_estep(m.df, m.family, m.rsv.v + i, nb, m.k, result,
+                                  m.work, m.resp);
+        }
+        em_n = m.rsv.m;
+    }
+    if (config->verbose) {
+        double t = WallSeconds() - t0;
+        printf("  [stream] one pass: n=%zu  steps=%d  avg_LL=%.6f  io_wait=%.3fs  "
+               "compute=%.3fs%s\n", n, m.global_step, em_ll / (double)em_n,
+               io_wait, t - io_wait, stopped ? "  (stopped by snapshot callback)" : "");
+    }
 
-    free(suf_w); free(suf_wx); free(suf_wxx);
-    free(chunk); free(chunk_resp); free(chunk_w);
+    double avg = drift && m.drift_chunks > 0 ? m.ll_avg : em_ll / (double)em_n;
+    model_finish(&m, avg * (double)n, n);
+    model_free(&m);
     return 0;
 }
@@ -7,12 +7,21 @@
 #define STREAMING_H
 
 #include <stddef.h>
+#include <stdio.h>
 #include "distributions.h"
 
 #ifdef __cplusplus
 extern "C" {
 #endif
 
+/**
+ * Model snapshot callback for UnmixStreamingOnline: the current fit (LL,
+ * BIC and AIC are running estimates) after n_seen values.
+ * @return nonzero to stop reading and finish with the current model
+ */
+typedef int (*StreamSnapshotFn)(const MixtureResult* model, size_t n_seen,
+                                void* ctx);
+
 typedef struct {
     int num_components;
     int chunk_size;        /* rows per chunk */
@@ -21,20 +30,112 @@ typedef struct {
     int verbose;
     DistFamily family;
     double eta_decay;      /* step-size decay: eta = (pass*n_chunks + chunk + 2)^(-decay) */
+    int io_buffers;        /* read-ahead ring: 0 = default (3), 1 = no reader thread */
+    int ll_from_last_pass; /* 1: report the LL accumulated during the last EM
+                            * pass instead of scanning the file once more with
+                            * the final parameters (see UnmixStreaming) */
+    size_t snapshot_every; /* UnmixStreamingOnline: call snapshot every this
+                            * many values (0 = never) */
+    StreamSnapshotFn snapshot;
+    void* snapshot_ctx;
+    const char* checkpoint_path; /* UnmixStreaming: resume from / save to
+                            * this file (NULL = no checkpoints); must be
+                            * NULL for UnmixStreamingOnline */
+    int checkpoint_every;  /* chunks between checkpoints; 0 = end of each
+                            * pass only */
+    double halflife;       /* drift tracking: statistics forget old values
+                            * with this half-life, in values (0 = off) */
+    double step_size;      /* drift tracking: constant step per chunk
+                            * instead (used when halflife is 0; 0 = off) */
+    int split_merge;       /* drift tracking: re-seed a component whose
+                            * weight collapses, or merge one away and
+                            * re-seed it when the chunk LL drops */
+    double collapse_weight;/* re-seed below this weight (0 = 1e-3) */
+    double ll_drop;        /* re-seed when a chunk's LL per value falls this
+                            * far below its running mean (0 = 0.5 nats) */
 } StreamConfig;
 
 /**
  * Stream EM: fits a mixture model by reading data from a file in chunks.
- * Never loads more than chunk_size values into RAM at once.
+ * Never loads more than chunk_size values into RAM at once.  The file is
+ * memory-mapped (or read in large blocks) and parsed with a
+ * locale-independent parser; '#' comment lines and blank lines are skipped.
+ * A GEMBIN file (binfile.h) with one value per row is read straight out of
+ * the mapping instead, so each pass is a sequential memory scan.
+ * There is no separate counting scan: the first pass samples its first
+ * 65536 values into a reservoir, initializes from it with the family's
+ * init_params (k-means++ for Gaussians and Student-t), and runs EM from
+ * there on.  Each chunk updates running averages of the family's
+ * sufficient statistics (GetDistSuffStats: the exponential families, the
+ * moment fits, and Student-t's ECM statistics), so the M-step is O(k) and
+ * the fit converges to the in-memory EM solution; families without a map
+ * refit each chunk with estimate() and blend.
+ * A reader thread fills the next chunks while EM runs on the current one;
+ * verbose output reports, per pass, the time spent waiting for data
+ * (io_wait) and the rest (compute).
  *
- * @param filename   Path to data file (one value per line)
+ * By default the reported log-likelihood (and BIC/AIC) comes from one
+ * extra pass with the final parameters.  With ll_from_last_pass it is the
+ * sum accumulated while the last EM pass ran, which saves that scan; the
+ * parameters move during the pass, so it is slightly below the exact value
+ * until EM has converged.  If the last pass was the first one, it is
+ * scaled up to cover the warm-up prefix.
+ *
+ * With checkpoint_path set, the running sufficient statistics, parameters,
+ * step counter and input position are written there (checkpoint.h) every
+ * checkpoint_every chunks and at the end of every pass.  If the file
+ * already exists the fit resumes from it, skipping straight to the saved
+ * position, and continues exactly as the interrupted run would have; a
+ * resumed run with a larger max_passes extends a fit that stopped at
+ * max_passes (a converged one is only reported).  The file is left in
+ * place; delete it to start over.
+ *
+ * @param filename   Path to data file (one value per line, or GEMBIN)
  * @param config     Streaming configuration
  * @param result     Output mixture result
- * @return 0 on success, -1 on error
+ * @return 0 on success, -1 bad arguments, -2 unsupported family,
+ *         -3 file cannot be opened, -4 no data, -5 allocation failure;
+ *         -1 also if the checkpoint is for another model or for an
+ *         input of a different size
  */
 int UnmixStreaming(const char* filename, const StreamConfig* config,
                    MixtureResult* result);
 
+/**
+ * One-pass online EM over a text stream that cannot be rewound: stdin, a
+ * pipe from zcat, a socket, a sensor.  Reads fp to EOF in chunks of
+ * chunk_size values (same line rules as UnmixStreaming) and applies the
+ * same stochastic-approximation update per chunk, so memory stays
+ * O(k · chunk_size) however long the stream runs.  Every snapshot_every
+ * values config->snapshot receives the current model; it can stop the
+ * stream early, and the call then returns even if the stream stays open
+ * (a read waiting for more input is woken).  max_passes, rtole and
+ * ll_from_last_pass do not apply: the reported LL is always the running
+ * sum over the chunks EM ran on, scaled to all values.  A stream shorter than the warm-up prefix returns
+ * the initialization fitted to the reservoir.
+ *
+ * Drift tracking (halflife or step_size) replaces the decaying step
+ * (t+2)^-eta_decay with a constant one, so the statistics are an
+ * exponentially weighted window over the recent stream and the model
+ * follows a drifting distribution at O(k) per chunk; the reported LL is
+ * then the forgetting-weighted LL per value scaled to n_seen.  With
+ * split_merge, a component whose weight drops below collapse_weight is
+ * refitted to the worst-explained 10% of the current chunk; when a chunk's
+ * LL per value falls ll_drop below its running mean, the lightest
+ * component is first merged into the one sharing most of its
+ * responsibility (statistics add) and its slot refitted the same way.
+ *
+ * fp is read through its file descriptor (POSIX) and not closed; nothing
+ * may have been read from it through stdio before the call.  Checkpoints
+ * resume by re-reading the input, so checkpoint_path must be NULL.
+ *
+ * @return 0 on success, -1 bad arguments (including checkpoint_path),
+ *         -2 unsupported family,
+ *         -4 no data, -5 allocation failure
+ */
+int UnmixStreamingOnline(FILE* fp, const StreamConfig* config,
+                         MixtureResult* result);
+
 #ifdef __cplusplus
 }
 #endif
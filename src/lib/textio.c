@@ -0,0 +1,333 @@
+/*
+ * Copyright 2022-2026, Micah Thornton and Chanhee Park
+ * Fast text input for streaming EM.
+ * License: GPL v3
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <float.h>
+#include <locale.h>
+
+#include "textio.h"
+
+#if defined(__unix__) || defined(__APPLE__)
+#define TEXTIO_POSIX 1
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#endif
+
+#define TEXTIO_BLOCK (4u << 20)   /* read() block size when not mapped */
+
+/* ════════════════════════════════════════════════════════════════════
+ * Decimal parser
+ *
+ * The mantissa is accumulated as an integer (≤ 19 significant digits fit
+ * in uint64) and scaled by an exact power of ten.  With m < 2⁵³ and
+ * |e| ≤ 22 both operands are exact doubles, so the single IEEE multiply
+ * or divide is correctly rounded (Clinger's fast path).  17–19 digit
+ * mantissas — what printf("%.17g") and Python repr() produce — use the
+ * same product in 64-bit long double where available; everything else
+ * falls back to strtod.
+ * ════════════════════════════════════════════════════════════════════ */
+
+static const double pow10_tab[23] = {
+    1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+    1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+};
+
+#if LDBL_MANT_DIG >= 64
+static const long double pow10_ltab[23] = {
+    1e0L, 1e1L, 1e2L, 1e3L, 1e4L, 1e5L, 1e6L, 1e7L, 1e8L, 1e9L, 1e10L, 1e11L,
+    1e12L, 1e13L, 1e14L, 1e15L, 1e16L, 1e17L, 1e18L, 1e19L, 1e20L, 1e21L, 1e22L
+};
+#endif
+
+/* Slow path: strtod on a NUL-terminated copy, with '.' mapped to the
+ * locale's decimal point so the result never depends on setlocale() */
+static double parse_slow(const char* s, const char* end, const char** next) {
+    char buf[128];
+    size_t len = (size_t)(end - s);
+    if (len > sizeof(buf) - 1) len = sizeof(buf) - 1;
+    memcpy(buf, s, len);
+    buf[len] = '\0';
+    char dp = localeconv()->decimal_point[0];
+    if (dp != '.')
+        for (size_t i = 0; i < len; i++)
+            if (buf[i] == '.') buf[i] = dp;
+    char* e;
+    double v = strtod(buf, &e);
+    if (next) *next = s + (e - buf);
+    return v;
+}
+
+double FastParseDouble(const char* s, const char* end, const char** next) {
+    const char* p = s;
+    while (p < end && (*p == ' ' || *p == '\t')) p++;
+    const char* start = p;
+
+    int neg = 0;
+    if (p < end && (*p == '-' || *p == '+')) { neg = (*p == '-'); p++; }
+
+    uint64_t m = 0;
+    int nd = 0;          /* significant digits kept in m */
+    int e10 = 0;
+    int any = 0, dropped = 0;
+    while (p < end && *p == '0') { p++; any = 1; }
+    for (; p < end && (unsigned)(*p - '0') < 10; p++, any = 1) {
+        if (nd < 19) { m = m * 10 + (uint64_t)(*p - '0'); nd++; }
+        else { e10++; dropped |= (*p != '0'); }
+    }
+    if (p < end && *p == '.') {
+        p++;
+        if (m == 0)
+            for (; p < end && *p == '0'; p++) { e10--; any = 1; }
+        for (; p < end && (unsigned)(*p - '0') < 10; p++, any = 1) {
+            if (nd < 19) { m = m * 10 + (uint64_t)(*p - '0'); nd++; e10--; }
+            else dropped |= (*p != '0');
+        }
+    }
+    if (!any) {
+        /* inf / nan / junk: let strtod decide (it rejects junk) */
+        if (p < end && (*p == 'i' || *p == 'I' || *p == 'n' || *p == 'N'))
+            return parse_slow(start, end, next);
+        if (next) *next = s;
+        return 0.0;
+    }
+    if (p < end && (*p == 'e' || *p == 'E')) {
+        const char* q = p + 1;
+        int eneg = 0, ev = 0, edig = 0;
+        if (q < end && (*q == '-' || *q == '+')) { eneg = (*q == '-'); q++; }
+        for (; q < end && (unsigned)(*q - '0') < 10; q++, edig++)
+            if (ev < 100000) ev = ev * 10 + (*q - '0');
+        if (edig) { e10 += eneg ? -ev : ev; p = q; }
+    }
+    if (next) *next = p;
+
+    if (m == 0) return neg ? -0.0 : 0.0;
+    if (!dropped && e10 >= -22 && e10 <= 22) {
+        if (m <= (UINT64_C(1) << 53)) {
+            double v = (double)m;
+            v = e10 < 0 ? v / pow10_tab[-e10] : v * pow10_tab[e10];
+            return neg ? -v : v;
+        }
+#if LDBL_MANT_DIG >= 64
+        long double lv = (long double)m;
+        lv = e10 < 0 ? lv / pow10_ltab[-e10] : lv * pow10_ltab[e10];
+        return neg ? -(double)lv : (double)lv;
+#endif
+    }
+    return parse_slow(start, end, next);
+}
+
+/* ════════════════════════════════════════════════════════════════════
+ * Reader
+ *
+ * A mapped file is one window [base, base + size).  In block mode the
+ * window is a heap buffer refilled by read(); a line cut by the block
+ * end is moved to the front before the next read, so the line scanner
+ * only ever sees complete lines (or the unterminated last line at EOF).
+ * ════════════════════════════════════════════════════════════════════ */
+
+struct TextReader {
+    const char* base;     /* window start */
+    size_t      size;     /* window length */
+    size_t      pos;      /* scan offset within the window */
+    size_t      consumed; /* bytes consumed before this window (block mode) */
+    int         mapped;
+    int         eof;      /* block mode: no more bytes after this window */
+#ifdef TEXTIO_POSIX
+    int         fd;
+    int         cancel[2]; /* borrowed: self-pipe that wakes a blocked read */
+#endif
+    FILE*       fp;       /* non-POSIX block mode */
+    int         borrowed; /* opened from a caller's FILE*: do not close */
+    char*       buf;      /* block-mode buffer (TEXTIO_BLOCK bytes) */
+};
+
+#ifdef TEXTIO_POSIX
+/* A live stream may block indefinitely: wait for data or a cancel.
+ * @return 1 if fd is readable (or at EOF), 0 if cancelled */
+static int reader_wait(TextReader* r) {
+    if (r->cancel[0] < 0) return 1;
+    struct pollfd pf[2] = { { r->fd, POLLIN, 0 }, { r->cancel[0], POLLIN, 0 } };
+    for (;;) {
+        if (poll(pf, 2, -1) >= 0) break;
+        if (errno != EINTR) return 1;
+    }
+    return !(pf[1].revents & POLLIN);
+}
+#endif
+
+static void reader_fill(TextReader* r) {
+    size_t keep = r->size - r->pos;
+    if (keep > 0) memmove(r->buf, r->buf + r->pos, keep);
+    r->consumed += r->pos;
+    r->pos = 0;
+    size_t got = 0;
+    while (keep + got < TEXTIO_BLOCK) {
+#ifdef TEXTIO_POSIX
+        if (r->borrowed && !reader_wait(r)) { r->eof = 1; break; }
+        ssize_t g = read(r->fd, r->buf + keep + got, TEXTIO_BLOCK - keep - got);
+#else
+        long g = (long)fread(r->buf + keep + got, 1, TEXTIO_BLOCK - keep - got, r->fp);
+#endif
+        if (g <= 0) { r->eof = 1; break; }
+        got += (size_t)g;
+        if (r->borrowed) break;   /* live stream: take what has arrived */
+    }
+    r->base = r->buf;
+    r->size = keep + got;
+}
+
+TextReader* TextReaderOpen(const char* path, int flags) {
+    if (!path) return NULL;
+    TextReader* r = (TextReader*)calloc(1, sizeof(TextReader));
+    if (!r) return NULL;
+#ifdef TEXTIO_POSIX
+    r->fd = open(path, O_RDONLY);
+    if (r->fd < 0) { free(r); return NULL; }
+    struct stat st;
+    if (!(flags & TEXTIO_NO_MMAP) && fstat(r->fd, &st) == 0 &&
+        S_ISREG(st.st_mode) && st.st_size > 0) {
+        void* p = mmap(NULL, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, r->fd, 0);
+        if (p != MAP_FAILED) {
+#ifdef MADV_SEQUENTIAL
+            madvise(p, (size_t)st.st_size, MADV_SEQUENTIAL);
+#endif
+            r->base = (const char*)p;
+            r->size = (size_t)st.st_size;
+            r->mapped = 1;
+            r->eof = 1;
+            return r;
+        }
+    }
+#else
+    (void)flags;
+    r->fp = fopen(path, "rb");
+    if (!r->fp) { free(r); return NULL; }
+#endif
+#if defined(TEXTIO_POSIX) && defined(POSIX_FADV_SEQUENTIAL) && !defined(__APPLE__)
+    posix_fadvise(r->fd, 0, 0, POSIX_FADV_SEQUENTIAL);   /* larger readahead */
+#endif
+    r->buf = (char*)malloc(TEXTIO_BLOCK);
+    if (!r->buf) { TextReaderClose(r); return NULL; }
+    reader_fill(r);
+    return r;
+}
+
+TextReader* TextReaderOpenFile(FILE* fp) {
+    if (!fp) return NULL;
+    TextReader* r = (TextReader*)calloc(1, sizeof(TextReader));
+    if (!r) return NULL;
+    r->borrowed = 1;
+#ifdef TEXTIO_POSIX
+    r->fd = fileno(fp);
+    if (pipe(r->cancel) != 0) r->cancel[0] = r->cancel[1] = -1;
+#else
+    r->fp = fp;
+#endif
+    r->buf = (char*)malloc(TEXTIO_BLOCK);
+    if (!r->buf) { TextReaderClose(r); return NULL; }
+    reader_fill(r);
+    return r;
+}
+
+void TextReaderRewind(TextReader* r) {
+    if (!r) return;
+    r->pos = 0;
+    if (r->mapped) return;
+#ifdef TEXTIO_POSIX
+    lseek(r->fd, 0, SEEK_SET);
+#else
+    rewind(r->fp);
+#endif
+    r->size = 0;
+    r->consumed = 0;
+    r->eof = 0;
+    reader_fill(r);
+    r->consumed = 0;
+}
+
+size_t TextReaderOffset(const TextReader* r) {
+    return r ? r->consumed + r->pos : 0;
+}
+
+int TextReaderSeek(TextReader* r, size_t off) {
+    if (!r) return -1;
+    if (r->mapped) {
+        if (off > r->size) return -1;
+        r->pos = off;
+        return 0;
+    }
+#ifdef TEXTIO_POSIX
+    if (lseek(r->fd, (off_t)off, SEEK_SET) < 0) return -1;
+#else
+    if (fseek(r->fp, (long)off, SEEK_SET) != 0) return -1;
+#endif
+    r->pos = 0;
+    r->size = 0;
+    r->eof = 0;
+    reader_fill(r);
+    r->consumed = off;
+    return 0;
+}
+
+size_t TextReaderRead(TextReader* r, double* out, size_t max) {
+    size_t n = 0;
+    while (n < max) {
+        const char* p = r->base + r->pos;
+        const char* end = r->base + r->size;
+        const char* nl = (const char*)memchr(p, '\n', (size_t)(end - p));
+        if (!nl) {
+            if (!r->eof && (r->pos > 0 || r->size < TEXTIO_BLOCK)) {
+                reader_fill(r);      /* line cut by the block end */
+                continue;
+            }
+            /* EOF, or a line longer than a whole block: like fgets with a
+             * short buffer, the block is taken as a line of its own */
+            if (p == end) break;     /* end of file */
+            nl = end;                /* unterminated last line */
+        }
+        r->pos = (size_t)(nl - r->base) + (nl < end);
+
+        /* Skip comments and blank (whitespace-only) lines */
+        if (*p == '#') continue;
+        const char* q = p;
+        while (q < nl && (*q == ' ' || *q == '\t' || *q == '\r')) q++;
+        if (q == nl) continue;
+
+        out[n++] = FastParseDouble(q, nl, NULL);
+    }
+    return n;
+}
+
+void TextReaderCancel(TextReader* r) {
+#ifdef TEXTIO_POSIX
+    if (r && r->borrowed && r->cancel[1] >= 0) {
+        char c = 0;
+        while (write(r->cancel[1], &c, 1) < 0 && errno == EINTR) {}
+    }
+#else
+    (void)r;
+#endif
+}
+
+void TextReaderClose(TextReader* r) {
+    if (!r) return;
+#ifdef TEXTIO_POSIX
+    if (r->mapped) munmap((void*)r->base, r->size);
+    if (r->fd >= 0 && !r->borrowed) close(r->fd);
+    if (r->borrowed && r->cancel[0] >= 0) { close(r->cancel[0]); close(r->cancel[1]); }
+#else
+    if (r->fp && !r->borrowed) fclose(r->fp);
+#endif
+    free(r->buf);
+    free(r);
+}
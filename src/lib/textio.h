@@ -0,0 +1,86 @@
+/*
+ * Copyright 2022-2026, Micah Thornton and Chanhee Park
+ * Fast text input for streaming EM: memory-mapped (or block-read) files
+ * and a locale-independent decimal parser.
+ * License: GPL v3
+ */
+#ifndef TEXTIO_H
+#define TEXTIO_H
+
+#include <stddef.h>
+#include <stdio.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* TextReaderOpen flags */
+#define TEXTIO_NO_MMAP 1   /* always use read() blocks (pipes, testing) */
+
+typedef struct TextReader TextReader;
+
+/**
+ * Open a one-value-per-line text file.  Regular files are memory-mapped;
+ * anything else (or TEXTIO_NO_MMAP) is read in large blocks.
+ * @return reader, or NULL if the file cannot be opened
+ */
+TextReader* TextReaderOpen(const char* path, int flags);
+
+/**
+ * Read an already open stream (stdin, a pipe) in blocks, through its file
+ * descriptor on POSIX.  fp is not closed by TextReaderClose, nothing may
+ * have been read from it through stdio yet, and TextReaderRewind is only
+ * meaningful if it is seekable.
+ * @return reader, or NULL on allocation failure
+ */
+TextReader* TextReaderOpenFile(FILE* fp);
+
+/**
+ * Parse up to max values into out, continuing where the last call stopped.
+ * Line rules match the historical fgets/atof reader: lines starting with
+ * '#' and blank lines are skipped, only the first number on a line is
+ * used, and a line with no number reads as 0.
+ * @return number of values stored; 0 at end of file
+ */
+size_t TextReaderRead(TextReader* r, double* out, size_t max);
+
+/** Restart from the beginning of the file. */
+void TextReaderRewind(TextReader* r);
+
+/** Bytes consumed so far in the current pass. */
+size_t TextReaderOffset(const TextReader* r);
+
+/**
+ * Continue from byte offset off, which must be a line start (an offset
+ * returned by TextReaderOffset).  Needs a seekable file.
+ * @return 0 on success, -1 if the reader cannot seek there
+ */
+int TextReaderSeek(TextReader* r, size_t off);
+
+/**
+ * Wake a read blocked on a stream opened by TextReaderOpenFile; it and
+ * every later one see end of file.  Safe to call from another thread
+ * (e.g. while a prefetch thread is reading); a no-op for files, which
+ * never block indefinitely.
+ */
+void TextReaderCancel(TextReader* r);
+
+void TextReaderClose(TextReader* r);
+
+/**
+ * Parse one decimal double from [s, end): optional leading blanks, sign,
+ * digits, '.', exponent.  Up to 19 significant digits with |exp10| ≤ 22
+ * are converted with one multiply or divide (correctly rounded up to 15
+ * digits; 17–19 digits go through long double and may differ from strtod
+ * by one ulp); longer mantissas, larger exponents, inf and nan go through
+ * strtod.  The decimal point is always '.', regardless of locale.
+ *
+ * @param next  Output (may be NULL): first unparsed byte; s if no number
+ */
+double FastParseDouble(const char* s, const char* end, const char** next);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* TEXTIO_H */
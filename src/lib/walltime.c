@@ -0,0 +1,15 @@
+/*
+ * Copyright 2022-2026, Micah Thornton and Chanhee Park
+ * Monotonic wall clock for verbose phase timings and I/O wait accounting.
+ * License: GPL v3
+ */
+
+#include <time.h>
+
+#include "walltime.h"
+
+double WallSeconds(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + 1e-9 * (double)ts.tv_nsec;
+}
@@ -0,0 +1,20 @@
+/*
+ * Copyright 2022-2026, Micah Thornton and Chanhee Park
+ * Monotonic wall clock for verbose phase timings and I/O wait accounting.
+ * License: GPL v3
+ */
+#ifndef WALLTIME_H
+#define WALLTIME_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** Seconds on a monotonic clock; only differences are meaningful */
+double WallSeconds(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* WALLTIME_H */
@@ -32,6 +32,10 @@
 #include "multivariate.h"
 #include "complex_em.h"
 #include "streaming.h"
+#include "sparse_em.h"
+#include "binfile.h"
+#include "textio.h"
+#include "accel.h"
 
 using namespace std;
 
@@ -58,8 +62,18 @@ struct emsettings{
     bool streaming = false;
     int stream_chunk = 10000;
     int stream_passes = 10;
+    bool stream_last_ll = false;
+    bool stream_one_pass = false;
+    size_t stream_snapshot = 0;
+    string checkpoint = "";
+    int checkpoint_every = 0;
+    double halflife = 0;
+    double step_size = 0;
+    bool split_merge = false;
     int mv_dim = 2;
     CovType cov_type = COV_FULL;
+    int lowrank_dim = 0;
+    double kd_tolerance = 0;
     KMethod kmethod = KMETHOD_BIC;
     bool complex_circular = false;
     bool complex_noncircular = false;
@@ -67,6 +81,13 @@ struct emsettings{
     bool complex_mv = false;
     int complex_mv_dim = 2;
     bool complex_streaming = false;
+    long init_subsample = -1;   /* -1 = library default threshold */
+    int multires = 1;           /* coarse-to-fine levels, 1 = off */
+    int restarts = 1;           /* parallel pruned multi-start, 1 = off */
+    int threads = 0;            /* OpenMP threads, 0 = default */
+    bool squarem = false;       /* SQUAREM in the MV and complex engines */
+    bool sparse_estep = false;
+    double trunc_eps = SPARSE_EM_DEFAULT_EPS;
     double rtole;
 };
 struct genesamfile{
@@ -100,6 +121,8 @@ struct comppatcounts parseinputfile(string ifilename);
 struct comppatcounts parseinputgenesam(string samfilename);
 vector<double> parsegmvinputfile(string valfilename);
 struct genesamfile readgenesamintostruct(string samfilename);
+int runconvert(int argc, char** argv);
+int printsnapshot(const MixtureResult* model, size_t n_seen, void* ctx);
 
 void MakeEMConfig(EMConfig_t* ConfigPtr, struct emsettings* ems);
 
@@ -114,6 +137,7 @@ void printusage(){
     cout << "|  -i/-I/--IFILE  <file>   Input: CSV compatibility patterns (MN mode)    |" << endl;
     cout << "|  -e/-E/--EFILE  <file>   Input: exponential mixture values              |" << endl;
     cout << "|  -o/-O/--OFILE  <file>   Output file (default: <timestamp>.abdn.txt)    |" << endl;
+    cout << "|                          -g accepts text or GEMBIN binary files (below) |" << endl;
     cout << "|                                                                          |" << endl;
     cout << "| DISTRIBUTION / COMPONENTS                                                |" << endl;
     cout << "|  -d/-D/--DIST   <family> Distribution family (default: Gaussian)        |" << endl;
@@ -130,6 +154,16 @@ void printusage(){
     cout << "|  -r/-R/--RTOLE  <tol>    Relative tolerance for EM stopping (def: 1e-5) |" << endl;
     cout << "|  -m/-M/--MAXIT  <n>      Maximum EM iterations (default: 1000)          |" << endl;
     cout << "|  -c/-C/--CSEED  <seed>   Integer seed for random number generator       |" << endl;
+    cout << "|  --sparse                Windowed sparse E-step for large k (Gaussian,  |" << endl;
+    cout << "|                          Laplace, Logistic, Cauchy)                     |" << endl;
+    cout << "|  --trunc-eps    <eps>    Sparse E-step truncation threshold (def: 1e-10)|" << endl;
+    cout << "|  --init-subsample <n>    Seed k-means++ on a subsample when rows >= n   |" << endl;
+    cout << "|                          (default: 1000000, 0 = always use full data)   |" << endl;
+    cout << "|  --multires     <L>      Fit on 1/10^(L-1)..1/10 subsamples, then full  |" << endl;
+    cout << "|                          data (Gaussian/generic and MV Gaussian; def: 1)|" << endl;
+    cout << "|  --restarts     <R>      Parallel EM restarts, losers pruned (def: 1)   |" << endl;
+    cout << "|  --threads      <n>      OpenMP threads (def: all cores)                |" << endl;
+    cout << "|  --squarem               SQUAREM extrapolation in MV and complex modes  |" << endl;
     cout << "|                                                                          |" << endl;
     cout << "| MODEL SELECTION MODES                                                    |" << endl;
     cout << "|  --adaptive              Adaptive EM: auto-select k + family per comp.  |" << endl;
@@ -143,19 +177,35 @@ void printusage(){
     cout << "|  --stream                Streaming EM: process file in chunks           |" << endl;
     cout << "|  --chunk-size   <n>      Rows per chunk for streaming EM (def: 10000)   |" << endl;
     cout << "|  --passes       <n>      Number of streaming passes over data (def: 10) |" << endl;
+    cout << "|  --last-pass-ll          Streaming: take final LL from the last pass    |" << endl;
+    cout << "|  --one-pass              Streaming: single online pass (implied by -g -)|" << endl;
+    cout << "|  --snapshot-every <n>    One-pass: print the model every n values       |" << endl;
+    cout << "|  --checkpoint   <file>   Streaming/online: save and resume EM state     |" << endl;
+    cout << "|  --checkpoint-every <n>  Checkpoint every n chunks (online: iterations) |" << endl;
+    cout << "|  --halflife     <n>      Streaming: forget data with this half-life     |" << endl;
+    cout << "|  --step-size    <e>      Streaming: constant step e instead (drift)     |" << endl;
+    cout << "|  --split-merge           Drift: re-seed collapsed/poorly fit components |" << endl;
     cout << "|                                                                          |" << endl;
     cout << "| MULTIVARIATE MODES  (requires row-major space/comma-separated -g file)  |" << endl;
     cout << "|  --mv / --multivariate   Multivariate Gaussian mixture                  |" << endl;
     cout << "|  --mvt / --mv-studentt   Multivariate Student-t mixture                 |" << endl;
     cout << "|  --mv-autok              Auto-select k for multivariate mixture         |" << endl;
     cout << "|  --dim          <d>      Dimensionality (auto-detected from data)       |" << endl;
-    cout << "|  --cov          <type>   Covariance type: full  diagonal  spherical      |" << endl;
+    cout << "|  --cov          <type>   Covariance: full diagonal spherical tied       |" << endl;
+    cout << "|                          lowrank                                        |" << endl;
+    cout << "|  --rank         <q>      Lowrank: factors per component (default √d)    |" << endl;
+    cout << "|  --kd-tree      <tau>    kd-tree EM for d <= 8 (Gaussian; e.g. 1e-3)    |" << endl;
     cout << "|                                                                          |" << endl;
     cout << "| COMPLEX-VALUED MODES  (interleaved re,im pairs in -g file)              |" << endl;
     cout << "|  --complex               Circular symmetric complex Gaussian mixture    |" << endl;
     cout << "|  --complex-nc            Non-circular complex Gaussian (pseudo-cov)     |" << endl;
     cout << "|  --complex-autok         Auto-select k for complex circular mixture     |" << endl;
     cout << "|                                                                          |" << endl;
+    cout << "| BINARY DATA                                                              |" << endl;
+    cout << "|  gemmulem convert <in.txt> <out.gmb> [--dtype f64|f32|ci16]             |" << endl;
+    cout << "|                          Convert text rows to a memory-mapped binary    |" << endl;
+    cout << "|                          file; f64 is read zero-copy by every engine    |" << endl;
+    cout << "|                                                                          |" << endl;
     cout << "| OUTPUT / DISPLAY                                                         |" << endl;
     cout << "|  -v/-V/--VERBO           Verbose: show iteration-by-iteration status    |" << endl;
     cout << "|  -t/-T/--TERMI           Print results to terminal instead of file      |" << endl;
@@ -255,6 +305,23 @@ struct emsettings parseargs(int argc, char ** argv){
             ems.stream_chunk = stoi(string(argv[i+1]));
         } else if (string(argv[i]) == "--passes"){
             ems.stream_passes = stoi(string(argv[i+1]));
+        } else if (string(argv[i]) == "--last-pass-ll"){
+            ems.stream_last_ll = true;
+        } else if (string(argv[i]) == "--one-pass"){
+            ems.streaming = true;
+            ems.stream_one_pass = true;
+        } else if (string(argv[i]) == "--snapshot-every"){
+            ems.stream_snapshot = (size_t)stoull(string(argv[i+1]));
+        } else if (string(argv[i]) == "--checkpoint"){
+            ems.checkpoint = string(argv[i+1]);
+        } else if (string(argv[i]) == "--checkpoint-every"){
+            ems.checkpoint_every = stoi(string(argv[i+1]));
+        } else if (string(argv[i]) == "--halflife"){
+            ems.halflife = stod(string(argv[i+1]));
+        } else if (string(argv[i]) == "--step-size"){
+            ems.step_size = stod(string(argv[i+1]));
+        } else if (string(argv[i]) == "--split-merge"){
+            ems.split_merge = true;
         } else if (string(argv[i]) == "--dim"){
             ems.mv_dim = stoi(string(argv[i+1]));
         } else if (string(argv[i]) == "--cov"){
@@ -262,6 +329,12 @@ struct emsettings parseargs(int argc, char ** argv){
             if (ct == "full") ems.cov_type = COV_FULL;
             else if (ct == "diagonal" || ct == "diag") ems.cov_type = COV_DIAGONAL;
             else if (ct == "spherical" || ct == "sph") ems.cov_type = COV_SPHERICAL;
+            else if (ct == "lowrank" || ct == "lr") ems.cov_type = COV_LOWRANK;
+            else if (ct == "tied") ems.cov_type = COV_TIED;
+        } else if (string(argv[i]) == "--rank"){
+            ems.lowrank_dim = stoi(string(argv[i+1]));
+        } else if (string(argv[i]) == "--kd-tree"){
+            ems.kd_tolerance = stod(string(argv[i+1]));
         } else if (string(argv[i]) == "--complex"){
             ems.complex_circular = true;
         } else if (string(argv[i]) == "--complex-nc" || string(argv[i]) == "--complex-noncircular"){
@@ -273,6 +346,20 @@ struct emsettings parseargs(int argc, char ** argv){
             ems.complex_mv = true;
         } else if (string(argv[i]) == "--complex-mv-dim" && i+1 < argc){
             ems.complex_mv_dim = stoi(string(argv[++i]));
+        } else if (string(argv[i]) == "--sparse"){
+            ems.sparse_estep = true;
+        } else if (string(argv[i]) == "--trunc-eps"){
+            ems.trunc_eps = stod(string(argv[i+1]));
+        } else if (string(argv[i]) == "--init-subsample"){
+            ems.init_subsample = stol(string(argv[i+1]));
+        } else if (string(argv[i]) == "--multires"){
+            ems.multires = stoi(string(argv[i+1]));
+        } else if (string(argv[i]) == "--restarts"){
+            ems.restarts = stoi(string(argv[i+1]));
+        } else if (string(argv[i]) == "--threads"){
+            ems.threads = stoi(string(argv[i+1]));
+        } else if (string(argv[i]) == "--squarem"){
+            ems.squarem = true;
         } else if (string(argv[i]) == "--complex-stream"){
             ems.complex_streaming = true;
             ems.complex_circular = true;
@@ -326,8 +413,17 @@ int main(int argc, char** argv)
          "              Micah Thornton & Chanhee Park (2022-2026)     " << endl <<
          "                        [Version 2.0]                       " << endl << endl;
 
+    if (argc >= 2 && string(argv[1]) == "convert") return runconvert(argc, argv);
+
     // Store the user settings for the EM algorithm in the ems structure. 
     struct emsettings ems = parseargs(argc, argv);
+    if (ems.init_subsample >= 0) SetInitSubsampleThreshold((size_t)ems.init_subsample);
+    SetMultiresLevels(ems.multires);
+    SetNumRestarts(ems.restarts);
+    SetNumThreads(ems.threads);
+    SetEMAcceleration(ems.squarem);
+    SetLowRankDim(ems.lowrank_dim);
+    SetMVKdTreeTolerance(ems.kd_tolerance);
 
     if (ems.verbose){
         cout << "INFO: User Settings - Running Gemmule in Verbose Mode (-v)" << endl;
@@ -353,11 +449,46 @@ int main(int argc, char** argv)
     } else if (ems.samfilename != ""){
         if (ems.verbose){cout << "INFO: File IO - Standard Compatibility Patterns Input " << endl;}
         cpc = parseinputgenesam(ems.samfilename);
-    } else if (ems.valfilename != ""){
+    }
+
+    /* GEMBIN input (binfile.h, written by `gemmulem convert`): mapped once
+     * and, for F64 payloads, handed to the engines without copying.  The
+     * mapping lives until the process exits. */
+    GemBin gbin;
+    memset(&gbin, 0, sizeof(gbin));
+    vector<double> bindecoded;
+    const double* bindata = NULL;
+    bool binary_input = ems.valfilename != "" && GemBinIsFile(ems.valfilename.c_str());
+    if (binary_input) {
+        int brc = GemBinOpen(ems.valfilename.c_str(), &gbin);
+        if (brc != 0) {
+            cerr << "ERROR: Cannot read binary file " << ems.valfilename << " (rc=" << brc << ")" << endl;
+            return 1;
+        }
+        bindata = GemBinData(&gbin);
+        if (!bindata) {
+            bindecoded.resize(gbin.count * (size_t)gbin.width);
+            bindata = GemBinRows(&gbin, 0, gbin.count, bindecoded.data());
+        }
+        if (ems.verbose) {
+            cout << "INFO: File IO - Binary input, " << gbin.count << " rows x " << gbin.width
+                 << " values" << (GemBinData(&gbin) ? " (mapped, zero-copy)" : "") << endl;
+        }
+    } else if (ems.valfilename != "" && !ems.streaming && !ems.complex_streaming &&
+               !ems.multivariate && !ems.complex_circular && !ems.complex_noncircular &&
+               !ems.complex_mv){
         if (ems.verbose){cout << "INFO: File IO - Standard Mixture Values Input " << endl;}
         umv = parsegmvinputfile(ems.valfilename);
     }
 
+    /* Univariate values: the parsed text, or a one-column binary file */
+    const double* uvals = umv.data();
+    size_t nvals = umv.size();
+    if (binary_input && gbin.width == 1) {
+        uvals = bindata;
+        nvals = gbin.count;
+    }
+
     if (ems.type=="MN"){
         if (ems.verbose){
             cout << "INFO: File IO - Found Compatilbility Patterns " << endl;
@@ -425,14 +556,14 @@ int main(int argc, char** argv)
     } else if (ems.type == "EM") {
         if (ems.verbose){
             cout << "INFO: User Settings - Running Gemmule in Univariate Exponential Deconvolution Mode, reading univariate normal values. " << endl;
-            cout << "INFO: File IO - " << to_string(umv.size()) << " values read from file. " << endl;
+            cout << "INFO: File IO - " << to_string(nvals) << " values read from file. " << endl;
         }
 
         EMConfig_t EMConfig;
         EMResultExponential_t Result;
 
         MakeEMConfig(&EMConfig, &ems);
-        UnmixExponentials(umv.data(), umv.size(), ems.kmixt, &Result, &EMConfig);
+        UnmixExponentials(uvals, nvals, ems.kmixt, &Result, &EMConfig);
         //struct exponentialEMResults eer = unmixexponentials(umv, ems.kmixt, ems.maxitr, ems.verbose, ems.rtole);
         if (ems.verbose){
             cout << "INFO: EM Algorithm - Exponentials Unmixed in " << to_string(Result.iterstaken) << " Iterations of EM. " << endl;
@@ -473,12 +604,14 @@ int main(int argc, char** argv)
             cerr << "ERROR: Complex mode requires -g <file> (interleaved re,im pairs)" << endl;
             return 1;
         }
-        /* Read interleaved re,im pairs: each line = "re im" or "re,im" */
+        /* Read interleaved re,im pairs: each line = "re im" or "re,im".
+         * Streaming and binary input skip this; the MV path reads its own rows. */
         vector<double> flat;
-        ifstream cf(datafile);
+        ifstream cf;
+        if (!binary_input && !ems.complex_streaming && !ems.complex_mv) cf.open(datafile);
         string line;
         size_t n_complex = 0;
-        while (getline(cf, line)) {
+        while (cf.is_open() && getline(cf, line)) {
             if (line.empty() || line[0] == '#') continue;
             istringstream iss(line);
             string tok;
@@ -494,7 +627,16 @@ int main(int argc, char** argv)
                 n_complex++;
             }
         }
-        if (n_complex == 0) {
+        const double* cdata = flat.data();
+        if (binary_input) {
+            if (!ems.complex_mv && gbin.width != 2) {
+                cerr << "ERROR: Complex binary input needs ci16 dim 1 or f64/f32 dim 2" << endl;
+                return 1;
+            }
+            cdata = bindata;
+            n_complex = gbin.count;
+        }
+        if (n_complex == 0 && !ems.complex_streaming && !ems.complex_mv) {
             cerr << "ERROR: No valid complex data found in " << datafile << endl;
             return 1;
         }
@@ -514,6 +656,11 @@ int main(int argc, char** argv)
             sconf.verbose = ems.verbose ? 1 : 0;
             sconf.eta_decay = 0.6;
             sconf.type = CGAUSS_CIRCULAR;
+            sconf.ll_from_last_pass = ems.stream_last_ll ? 1 : 0;
+            if (ems.checkpoint != "") {
+                sconf.checkpoint_path = ems.checkpoint.c_str();
+                sconf.checkpoint_every = ems.checkpoint_every;
+            }
             CCircMixtureResult cr;
             memset(&cr, 0, sizeof(cr));
             rc = UnmixComplexStreaming(datafile.c_str(), &sconf, &cr);
@@ -536,7 +683,16 @@ int main(int argc, char** argv)
             /* Re-read the file to handle multi-dim data */
             vector<double> mv_flat;
             size_t n_mv = 0;
-            {
+            const double* mvdata = NULL;
+            if (binary_input) {
+                if (gbin.width % 2 != 0) {
+                    cerr << "ERROR: MV complex binary input needs an even number of values per row" << endl;
+                    return 1;
+                }
+                d = gbin.width / 2;
+                mvdata = bindata;
+                n_mv = gbin.count;
+            } else {
                 ifstream mvf(datafile);
                 string line;
                 while (getline(mvf, line)) {
@@ -554,6 +710,7 @@ int main(int argc, char** argv)
                         n_mv++;
                     }
                 }
+                mvdata = mv_flat.data();
             }
             if (n_mv == 0) {
                 cerr << "ERROR: No valid MV complex data (need " << 2*d << " values per line)" << endl;
@@ -563,7 +720,7 @@ int main(int argc, char** argv)
                  << " d=" << d << " k=" << ems.kmixt << endl;
             MVComplexMixtureResult mvr;
             memset(&mvr, 0, sizeof(mvr));
-            rc = UnmixMVComplex(mv_flat.data(), n_mv, d, ems.kmixt,
+            rc = UnmixMVComplex(mvdata, n_mv, d, ems.kmixt,
                                 ems.maxitr, ems.rtole,
                                 ems.verbose ? 1 : 0, &mvr);
             if (rc == 0) {
@@ -586,7 +743,7 @@ int main(int argc, char** argv)
             cout << "INFO: Non-circular complex Gaussian mixture — n=" << n_complex
                  << " k=" << ems.kmixt << endl;
             CNonCircMixtureResult ncr = {0};
-            rc = UnmixComplexNonCircular(flat.data(), n_complex, ems.kmixt,
+            rc = UnmixComplexNonCircular(cdata, n_complex, ems.kmixt,
                                          ems.maxitr, ems.rtole,
                                          ems.verbose ? 1 : 0, &ncr);
             if (rc == 0) {
@@ -608,7 +765,7 @@ int main(int argc, char** argv)
             cout << "INFO: Complex circular auto-k — n=" << n_complex
                  << " k_max=" << kmax << endl;
             CCircMixtureResult cr = {0};
-            rc = UnmixComplexCircularAutoK(flat.data(), n_complex, kmax,
+            rc = UnmixComplexCircularAutoK(cdata, n_complex, kmax,
                                             ems.maxitr, ems.rtole,
                                             ems.verbose ? 1 : 0, &cr);
             if (rc == 0) {
@@ -628,7 +785,7 @@ int main(int argc, char** argv)
             cout << "INFO: Circular complex Gaussian mixture — n=" << n_complex
                  << " k=" << ems.kmixt << endl;
             CCircMixtureResult cr = {0};
-            rc = UnmixComplexCircular(flat.data(), n_complex, ems.kmixt,
+            rc = UnmixComplexCircular(cdata, n_complex, ems.kmixt,
                                       ems.maxitr, ems.rtole,
                                       ems.verbose ? 1 : 0, &cr);
             if (rc == 0) {
@@ -660,10 +817,11 @@ int main(int argc, char** argv)
         /* Read n×d matrix: each line is one observation with d space/comma-separated values */
         vector<double> flat;
         int d_detected = -1;
-        ifstream mvf(datafile);
+        ifstream mvf;
+        if (!binary_input) mvf.open(datafile);
         string line;
         size_t n_mv = 0;
-        while (getline(mvf, line)) {
+        while (mvf.is_open() && getline(mvf, line)) {
             if (line.empty() || line[0] == '#') continue;
             vector<double> row;
             istringstream iss(line);
@@ -680,6 +838,12 @@ int main(int argc, char** argv)
             n_mv++;
         }
         if (ems.mv_dim > 1) d_detected = ems.mv_dim;
+        const double* X = flat.data();
+        if (binary_input) {
+            X = bindata;
+            n_mv = gbin.count;
+            d_detected = gbin.width;
+        }
         if (n_mv == 0 || d_detected <= 0) {
             cerr << "ERROR: No valid multivariate data found in " << datafile << endl;
             return 1;
@@ -687,7 +851,9 @@ int main(int argc, char** argv)
         cout << "INFO: Multivariate Gaussian mixture — n=" << n_mv
              << " d=" << d_detected << " k=" << ems.kmixt
              << " cov=" << (ems.cov_type == COV_FULL ? "full" :
-                            ems.cov_type == COV_DIAGONAL ? "diagonal" : "spherical") << endl;
+                            ems.cov_type == COV_DIAGONAL ? "diagonal" :
+                            ems.cov_type == COV_SPHERICAL ? "spherical" :
+                            ems.cov_type == COV_TIED ? "tied" : "lowrank") << endl;
 
         int rc;
 
@@ -695,7 +861,7 @@ int main(int argc, char** argv)
             /* Auto-k selection */
             int kmax = ems.kmax > 0 ? ems.kmax : 8;
             MVAutoKResult akr;
-            rc = UnmixMVAutoK(flat.data(), n_mv, d_detected, kmax,
+            rc = UnmixMVAutoK(X, n_mv, d_detected, kmax,
                               ems.cov_type, ems.maxitr, ems.rtole,
                               ems.verbose ? 1 : 0, &akr);
             if (rc == 0) {
@@ -717,7 +883,7 @@ int main(int argc, char** argv)
         } else if (ems.mv_studentt) {
             /* Student-t mixture */
             MVStudentTResult tr;
-            rc = UnmixMVStudentT(flat.data(), n_mv, d_detected, ems.kmixt,
+            rc = UnmixMVStudentT(X, n_mv, d_detected, ems.kmixt,
                                  ems.cov_type, ems.maxitr, ems.rtole,
                                  ems.verbose ? 1 : 0, &tr);
             if (rc == 0) {
@@ -737,7 +903,7 @@ int main(int argc, char** argv)
         } else {
             /* Standard Gaussian */
             MVMixtureResult mv_result;
-            rc = UnmixMVGaussian(flat.data(), n_mv, d_detected, ems.kmixt,
+            rc = UnmixMVGaussian(X, n_mv, d_detected, ems.kmixt,
                                  ems.cov_type, ems.maxitr, ems.rtole,
                                  ems.verbose ? 1 : 0, &mv_result);
             if (rc == 0) {
@@ -790,6 +956,7 @@ int main(int argc, char** argv)
         }
 
         StreamConfig scfg;
+        memset(&scfg, 0, sizeof(scfg));
         scfg.num_components = ems.kmixt;
         scfg.chunk_size = ems.stream_chunk;
         scfg.max_passes = ems.stream_passes;
@@ -797,14 +964,39 @@ int main(int argc, char** argv)
         scfg.verbose = ems.verbose ? 1 : 0;
         scfg.family = fam;
         scfg.eta_decay = 0.6;
+        scfg.ll_from_last_pass = ems.stream_last_ll ? 1 : 0;
+        scfg.snapshot_every = ems.stream_snapshot;
+        scfg.snapshot = printsnapshot;
+        scfg.halflife = ems.halflife;
+        scfg.step_size = ems.step_size;
+        scfg.split_merge = ems.split_merge ? 1 : 0;
+        if (ems.checkpoint != "") {
+            scfg.checkpoint_path = ems.checkpoint.c_str();
+            scfg.checkpoint_every = ems.checkpoint_every;
+        }
 
+        /* "-g -" (stdin) and --one-pass: one online pass, nothing re-read */
+        bool one_pass = ems.stream_one_pass || datafile == "-";
+        if (one_pass && ems.checkpoint != "") {
+            cerr << "ERROR: --checkpoint needs a re-readable file; it does not apply to a one-pass stream" << endl;
+            return 1;
+        }
         cout << "INFO: Streaming EM — " << GetDistName(fam)
              << " k=" << ems.kmixt
-             << " chunk=" << ems.stream_chunk
-             << " passes=" << ems.stream_passes << endl;
+             << " chunk=" << ems.stream_chunk;
+        if (one_pass) cout << " one pass" << (datafile == "-" ? " from stdin" : "") << endl;
+        else cout << " passes=" << ems.stream_passes << endl;
 
         MixtureResult result;
-        int rc = UnmixStreaming(datafile.c_str(), &scfg, &result);
+        memset(&result, 0, sizeof(result));
+        int rc;
+        if (one_pass) {
+            FILE* in = datafile == "-" ? stdin : fopen(datafile.c_str(), "rb");
+            rc = in ? UnmixStreamingOnline(in, &scfg, &result) : -3;
+            if (in && in != stdin) fclose(in);
+        } else {
+            rc = UnmixStreaming(datafile.c_str(), &scfg, &result);
+        }
         if (rc == 0) {
             cout << "INFO: LL=" << result.loglikelihood
                  << "  BIC=" << result.bic
@@ -840,14 +1032,20 @@ int main(int argc, char** argv)
     }
 
     if (!ems.distname.empty() || ems.autoselect || ems.adaptive) {
-        if (umv.empty() && ems.valfilename.empty()) {
+        if (nvals == 0 && ems.valfilename.empty()) {
             /* Need a data file — try reading from -g/-e filename or reparse */
             cerr << "ERROR: Generic/auto mode requires data values (-g or -e input)." << endl;
             return 1;
         }
         /* If umv wasn't populated by prior modes, load it now */
-        if (umv.empty() && !ems.valfilename.empty()) {
+        if (nvals == 0 && !ems.valfilename.empty() && !binary_input) {
             umv = parsegmvinputfile(ems.valfilename);
+            uvals = umv.data();
+            nvals = umv.size();
+        }
+        if (nvals == 0 || (binary_input && gbin.width != 1)) {
+            cerr << "ERROR: Univariate mode needs one value per row in " << ems.valfilename << endl;
+            return 1;
         }
 
         int k_min = 1;
@@ -859,7 +1057,7 @@ int main(int argc, char** argv)
                  << ", discovering distribution families from data" << endl;
 
             AdaptiveResult aResult;
-            int rc = UnmixAdaptiveEx(umv.data(), umv.size(),
+            int rc = UnmixAdaptiveEx(uvals, nvals,
                                      k_max, ems.maxitr, ems.rtole,
                                      ems.verbose ? 1 : 0, ems.kmethod, &aResult);
             if (rc == 0) {
@@ -911,7 +1109,7 @@ int main(int argc, char** argv)
             cout << "INFO: Testing k=" << k_min << " to k=" << k_max << endl;
 
             ModelSelectResult msResult;
-            int rc = SelectBestMixture(umv.data(), umv.size(),
+            int rc = SelectBestMixture(uvals, nvals,
                                        NULL, 0,  /* try all valid families */
                                        k_min, k_max,
                                        ems.maxitr, ems.rtole, ems.verbose ? 1 : 0,
@@ -1010,7 +1208,7 @@ int main(int argc, char** argv)
 
             if (ems.online) {
                 cout << "INFO: Online EM — " << GetDistName(fam) << " mixture with k=" << ems.kmixt
-                     << ", batch_size=" << (ems.batch_size > 0 ? ems.batch_size : (int)fmin(256, umv.size()/4)) << endl;
+                     << ", batch_size=" << (ems.batch_size > 0 ? ems.batch_size : (int)fmin(256, nvals/4)) << endl;
             } else {
                 cout << "INFO: Fitting " << GetDistName(fam) << " mixture with k=" << ems.kmixt << endl;
             }
@@ -1018,11 +1216,24 @@ int main(int argc, char** argv)
             MixtureResult result;
             int rc;
             if (ems.online) {
-                rc = UnmixOnline(umv.data(), umv.size(), fam, ems.kmixt,
+                if (ems.checkpoint != "")
+                    SetOnlineCheckpoint(ems.checkpoint.c_str(),
+                                        ems.checkpoint_every > 0 ? ems.checkpoint_every : 100);
+                rc = UnmixOnline(uvals, nvals, fam, ems.kmixt,
                                  ems.maxitr, ems.rtole, ems.batch_size,
                                  ems.verbose ? 1 : 0, &result);
+                SetOnlineCheckpoint(NULL, 0);
+            } else if (ems.sparse_estep) {
+                double ll_err = 0;
+                rc = UnmixGenericSparse(uvals, nvals, fam, ems.kmixt,
+                                        ems.maxitr, ems.rtole, ems.trunc_eps,
+                                        ems.verbose ? 1 : 0, &result, &ll_err);
+                if (rc == -2)
+                    cerr << "ERROR: --sparse supports Gaussian, Laplace, Logistic and Cauchy only" << endl;
+                else if (rc == 0)
+                    cout << "INFO: Sparse E-step LL truncation error <= " << ll_err << endl;
             } else {
-                rc = UnmixGeneric(umv.data(), umv.size(), fam, ems.kmixt,
+                rc = UnmixGeneric(uvals, nvals, fam, ems.kmixt,
                                   ems.maxitr, ems.rtole, ems.verbose ? 1 : 0, &result);
             }
             if (rc == 0) {
@@ -1115,6 +1326,112 @@ vector<double> parsegmvinputfile(string valfilename){
     return(gmv);
 }
 
+/* Snapshot callback for one-pass streaming: the model so far on stdout */
+int printsnapshot(const MixtureResult* model, size_t n_seen, void* ctx){
+    (void)ctx;
+    const DistFunctions* df = GetDistFunctions(model->family);
+    cout << "SNAPSHOT n=" << n_seen << "  LL=" << model->loglikelihood << endl;
+    for (int j = 0; j < model->num_components; j++) {
+        cout << "  Component " << j << ": weight=" << model->mixing_weights[j];
+        for (int p = 0; p < df->num_params; p++)
+            cout << "  p" << p << "=" << model->params[j].p[p];
+        cout << endl;
+    }
+    cout.flush();
+    return 0;
+}
+
+/* gemmulem convert <in.txt> <out.gmb> [--dtype f64|f32|ci16]
+ *
+ * Text rows (space/tab/comma-separated, '#' comments) to a GEMBIN file.
+ * The column count is taken from the first data row; rows with a different
+ * count are skipped.  For ci16 the columns are (re, im) pairs. */
+int runconvert(int argc, char** argv){
+    if (argc < 4) {
+        cerr << "Usage: gemmulem convert <in.txt> <out.gmb> [--dtype f64|f32|ci16]" << endl;
+        return 1;
+    }
+    string infile = argv[2], outfile = argv[3];
+    GemBinType dtype = GEMBIN_F64;
+    for (int i = 4; i + 1 < argc; i++) {
+        if (string(argv[i]) == "--dtype") {
+            string t = argv[++i];
+            if (t == "f64") dtype = GEMBIN_F64;
+            else if (t == "f32") dtype = GEMBIN_F32;
+            else if (t == "ci16") dtype = GEMBIN_CI16;
+            else { cerr << "ERROR: Unknown dtype '" << t << "'. Use f64/f32/ci16" << endl; return 1; }
+        }
+    }
+    ifstream ifs(infile);
+    if (!ifs.is_open()) {
+        cerr << "ERROR: File IO - (" << infile << ") Not Found" << endl;
+        return 1;
+    }
+
+    GemBinWriter* w = NULL;
+    int width = -1;
+    size_t rows = 0, skipped = 0;
+    vector<double> row, batch;
+    string line;
+    while (getline(ifs, line)) {
+        const char* p = line.data();
+        const char* end = p + line.size();
+        row.clear();
+        while (p < end) {
+            while (p < end && (*p == ' ' || *p == '\t' || *p == ',' || *p == '\r')) p++;
+            if (p == end || *p == '#') break;
+            const char* next;
+            double v = FastParseDouble(p, end, &next);
+            if (next == p) {   /* not a number: skip the token */
+                while (p < end && *p != ' ' && *p != '\t' && *p != ',') p++;
+                continue;
+            }
+            row.push_back(v);
+            p = next;
+        }
+        if (row.empty()) continue;
+        if (width < 0) {
+            width = (int)row.size();
+            if (dtype == GEMBIN_CI16 && width % 2 != 0) {
+                cerr << "ERROR: ci16 needs an even number of columns (re, im pairs)" << endl;
+                return 1;
+            }
+            w = GemBinWriterOpen(outfile.c_str(), dtype,
+                                 dtype == GEMBIN_CI16 ? width / 2 : width);
+            if (!w) {
+                cerr << "ERROR: Cannot create " << outfile << endl;
+                return 1;
+            }
+        }
+        if ((int)row.size() != width) { skipped++; continue; }
+        batch.insert(batch.end(), row.begin(), row.end());
+        rows++;
+        if (batch.size() >= 65536) {
+            if (GemBinWriterAppend(w, batch.data(), batch.size() / width) != 0) {
+                GemBinWriterClose(w);
+                cerr << "ERROR: Write to " << outfile << " failed" << endl;
+                return 1;
+            }
+            batch.clear();
+        }
+    }
+    if (!w) {
+        cerr << "ERROR: No data rows found in " << infile << endl;
+        return 1;
+    }
+    int rc = batch.empty() ? 0 : GemBinWriterAppend(w, batch.data(), batch.size() / width);
+    if (GemBinWriterClose(w) != 0) rc = -3;
+    if (rc != 0) {
+        cerr << "ERROR: Write to " << outfile << " failed" << endl;
+        return 1;
+    }
+    cout << "INFO: Wrote " << rows << " rows x " << width << " values ("
+         << (dtype == GEMBIN_F64 ? "f64" : dtype == GEMBIN_F32 ? "f32" : "ci16")
+         << ") to " << outfile << endl;
+    if (skipped) cout << "WARN: Skipped " << skipped << " rows with a different column count" << endl;
+    return 0;
+}
+
 struct genesamfile readgenesamintostruct(string samfilename){
     ifstream gsam(samfilename);
     string linebuf;